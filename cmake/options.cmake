@@ -56,6 +56,7 @@ set(WITH_SOURCE_TREE    "hierarchical" CACHE STRING "Build the source tree for I
 set_property(CACHE WITH_SOURCE_TREE PROPERTY STRINGS no flat hierarchical hierarchical-folders)
 option(WITHOUT_GIT      "Disable the GIT testing routines"                            0)
 option(BUILD_TESTING    "Build test suite" 0)
+option(WITH_BENCHMARKS  "Build benchmarks of the test suite (requires BUILD_TESTING)"  0)
 
 if(UNIX)
   option(USE_LD_GOLD    "Use GNU gold linker"                                        0)
@@ -54,6 +54,10 @@ else()
   message("* Build unit tests       : No (default)")
 endif()
 
+if(BUILD_TESTING AND WITH_BENCHMARKS)
+  message("* Build benchmarks       : Yes")
+endif()
+
 if(USE_COREPCH)
   message("* Build core w/PCH       : Yes (default)")
 else()
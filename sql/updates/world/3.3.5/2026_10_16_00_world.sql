@@ -0,0 +1,5 @@
+--
+DELETE FROM `command` WHERE `name`='debug loscache';
+INSERT INTO `command` (`name`,`permission`,`help`) VALUES
+('debug loscache',300,'Syntax: .debug loscache
+Shows hit rate and time saved by the line of sight cache of your current map');
@@ -23,6 +23,7 @@
 #include <G3D/AABox.h>
 
 #include "Define.h"
+#include "RayPacket.h"
 
 #include <stdexcept>
 #include <vector>
@@ -117,35 +118,16 @@ class TC_COMMON_API BIH
         template<typename RayCallback>
         void intersectRay(const G3D::Ray &r, RayCallback& intersectCallback, float &maxDist, bool stopAtFirst = false) const
         {
-            float intervalMin = -1.f;
-            float intervalMax = -1.f;
+            float intervalMin;
+            float intervalMax;
+            if (!clipRay(r, maxDist, intervalMin, intervalMax))
+                return;
+
             G3D::Vector3 org = r.origin();
             G3D::Vector3 dir = r.direction();
             G3D::Vector3 invDir;
             for (int i=0; i<3; ++i)
-            {
                 invDir[i] = 1.f / dir[i];
-                if (G3D::fuzzyNe(dir[i], 0.0f))
-                {
-                    float t1 = (bounds.low()[i]  - org[i]) * invDir[i];
-                    float t2 = (bounds.high()[i] - org[i]) * invDir[i];
-                    if (t1 > t2)
-                        std::swap(t1, t2);
-                    if (t1 > intervalMin)
-                        intervalMin = t1;
-                    if (t2 < intervalMax || intervalMax < 0.f)
-                        intervalMax = t2;
-                    // intervalMax can only become smaller for other axis,
-                    //  and intervalMin only larger respectively, so stop early
-                    if (intervalMax <= 0 || intervalMin >= maxDist)
-                        return;
-                }
-            }
-
-            if (intervalMin > intervalMax)
-                return;
-            intervalMin = std::max(intervalMin, 0.f);
-            intervalMax = std::min(intervalMax, maxDist);
 
             uint32 offsetFront[3];
             uint32 offsetBack[3];
@@ -253,6 +235,149 @@ class TC_COMMON_API BIH
             }
         }
 
+        /** Traces all rays of a packet in one traversal, rays must share their direction octant.
+            intersectCallback(RayPacket const& packet, uint32 entry, float* maxDist, uint32 laneMask, bool stopAtFirst)
+            tests the lanes of laneMask against one object and returns the lanes that hit it.
+            maxDist holds one distance per lane, lanes stop at their first hit when stopAtFirst is set.
+            Visits the same objects per lane as intersectRay called for each ray.
+        */
+        template<typename PacketCallback>
+        void intersectRayPacket(RayPacket const& packet, PacketCallback& intersectCallback, float* maxDist, bool stopAtFirst = false) const
+        {
+            float laneMin[RayPacket::WIDTH];
+            float laneMax[RayPacket::WIDTH];
+            uint32 active = 0;
+            for (uint32 lane = 0; lane < RayPacket::WIDTH; ++lane)
+            {
+                if (lane < packet.Count && clipRay(packet.Rays[lane], maxDist[lane], laneMin[lane], laneMax[lane]))
+                    active |= 1 << lane;
+                else
+                    laneMin[lane] = laneMax[lane] = 0.f;
+            }
+
+            if (!active)
+                return;
+
+            uint32 offsetFront[3];
+            uint32 offsetBack[3];
+            uint32 offsetFront3[3];
+            uint32 offsetBack3[3];
+            uint32 octant = packet.GetOctant();
+            for (int i=0; i<3; ++i)
+            {
+                offsetFront[i] = (octant >> i) & 1;
+                offsetBack[i] = offsetFront[i] ^ 1;
+                offsetFront3[i] = offsetFront[i] * 3;
+                offsetBack3[i] = offsetBack[i] * 3;
+                ++offsetFront[i];
+                ++offsetBack[i];
+            }
+
+            PacketFloat intervalMin = PacketFloat::Load(laneMin);
+            PacketFloat intervalMax = PacketFloat::Load(laneMax);
+            // lanes that already found their first hit
+            uint32 finished = 0;
+
+            PacketStackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true) {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    bool BVH2 = (tn & (1 << 29)) != 0;
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node, same decisions as intersectRay made per lane
+                            PacketFloat tf = (PacketFloat::Broadcast(intBitsToFloat(tree[node + offsetFront[axis]])) - packet.GetOrigin(axis)) * packet.GetInvDirection(axis);
+                            PacketFloat tb = (PacketFloat::Broadcast(intBitsToFloat(tree[node + offsetBack[axis]])) - packet.GetOrigin(axis)) * packet.GetInvDirection(axis);
+                            PacketBool activeMask = PacketBool::FromBits(active);
+                            uint32 front = (activeMask & !(tf < intervalMin)).Bits();
+                            uint32 back = (activeMask & !(tb > intervalMax)).Bits();
+                            // all rays pass between clip zones
+                            if (!front && !back)
+                                break;
+                            int backNode = offset + offsetBack3[axis];
+                            PacketFloat backMin = PacketFloat::Select(tb >= intervalMin, tb, intervalMin);
+                            // rays pass through far node only
+                            if (!front)
+                            {
+                                node = backNode;
+                                intervalMin = backMin;
+                                active = back;
+                                continue;
+                            }
+                            node = offset + offsetFront3[axis];
+                            // push back node for the lanes passing through it
+                            if (back)
+                            {
+                                backMin.Store(stack[stackPos].tnear);
+                                intervalMax.Store(stack[stackPos].tfar);
+                                stack[stackPos].node = backNode;
+                                stack[stackPos].active = back;
+                                stackPos++;
+                            }
+                            intervalMax = PacketFloat::Select(tf <= intervalMax, tf, intervalMax);
+                            active = front;
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - test some objects
+                            int n = tree[node + 1];
+                            while (n > 0) {
+                                uint32 hits = intersectCallback(packet, objects[offset], maxDist, active, stopAtFirst);
+                                if (stopAtFirst && hits)
+                                {
+                                    finished |= hits;
+                                    active &= ~hits;
+                                    if (!active)
+                                        break;
+                                }
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else
+                    {
+                        if (axis>2)
+                            return; // should not happen
+                        PacketFloat tf = (PacketFloat::Broadcast(intBitsToFloat(tree[node + offsetFront[axis]])) - packet.GetOrigin(axis)) * packet.GetInvDirection(axis);
+                        PacketFloat tb = (PacketFloat::Broadcast(intBitsToFloat(tree[node + offsetBack[axis]])) - packet.GetOrigin(axis)) * packet.GetInvDirection(axis);
+                        node = offset;
+                        intervalMin = PacketFloat::Select(tf >= intervalMin, tf, intervalMin);
+                        intervalMax = PacketFloat::Select(tb <= intervalMax, tb, intervalMax);
+                        active &= (!(intervalMin > intervalMax)).Bits();
+                        if (!active)
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+                do
+                {
+                    // stack is empty?
+                    if (stackPos == 0)
+                        return;
+                    // move back up the stack
+                    stackPos--;
+                    intervalMin = PacketFloat::Load(stack[stackPos].tnear);
+                    active = stack[stackPos].active & ~finished & (!(PacketFloat::Load(maxDist) < intervalMin)).Bits();
+                    if (!active)
+                        continue;
+                    node = stack[stackPos].node;
+                    intervalMax = PacketFloat::Load(stack[stackPos].tfar);
+                    break;
+                } while (true);
+            }
+        }
+
         template<typename IsectCallback>
         void intersectPoint(const G3D::Vector3 &p, IsectCallback& intersectCallback) const
         {
@@ -353,6 +478,48 @@ class TC_COMMON_API BIH
             float tfar;
         };
 
+        struct PacketStackNode
+        {
+            uint32 node;
+            uint32 active;
+            float tnear[RayPacket::WIDTH];
+            float tfar[RayPacket::WIDTH];
+        };
+
+        // clips the ray against the tree bounds, returns false if the ray misses them within maxDist
+        bool clipRay(G3D::Ray const& r, float maxDist, float& intervalMin, float& intervalMax) const
+        {
+            intervalMin = -1.f;
+            intervalMax = -1.f;
+            G3D::Vector3 const& org = r.origin();
+            G3D::Vector3 const& dir = r.direction();
+            for (int i=0; i<3; ++i)
+            {
+                if (G3D::fuzzyNe(dir[i], 0.0f))
+                {
+                    float invDir = 1.f / dir[i];
+                    float t1 = (bounds.low()[i]  - org[i]) * invDir;
+                    float t2 = (bounds.high()[i] - org[i]) * invDir;
+                    if (t1 > t2)
+                        std::swap(t1, t2);
+                    if (t1 > intervalMin)
+                        intervalMin = t1;
+                    if (t2 < intervalMax || intervalMax < 0.f)
+                        intervalMax = t2;
+                    // intervalMax can only become smaller for other axis,
+                    //  and intervalMin only larger respectively, so stop early
+                    if (intervalMax <= 0 || intervalMin >= maxDist)
+                        return false;
+                }
+            }
+
+            if (intervalMin > intervalMax)
+                return false;
+            intervalMin = std::max(intervalMin, 0.f);
+            intervalMax = std::min(intervalMax, maxDist);
+            return true;
+        }
+
         class BuildStats
         {
             private:
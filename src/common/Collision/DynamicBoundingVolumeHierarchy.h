@@ -0,0 +1,408 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _DYNAMIC_BVH_H
+#define _DYNAMIC_BVH_H
+
+#include "Define.h"
+#include "Errors.h"
+#include <G3D/AABox.h>
+#include <G3D/BoundsTrait.h>
+#include <G3D/Ray.h>
+#include <unordered_map>
+#include <vector>
+
+/** Bounding volume hierarchy supporting incremental insert, remove and move of objects.
+    Leaves store bounds enlarged by BOUNDS_MARGIN so objects moving a little (transports, elevators)
+    keep their leaf, otherwise only the leaf is reinserted and its ancestors are refit.
+    The tree is kept height balanced with rotations on every change (same scheme as Box2D b2DynamicTree),
+    so it never needs a full rebuild.
+*/
+template<class T, class BoundsFunc = BoundsTrait<T> >
+class DynamicBVH
+{
+    static constexpr int32 NULL_NODE = -1;
+    static constexpr int32 MAX_STACK_SIZE = 64;
+
+    struct Node
+    {
+        G3D::AABox bounds;
+        T const* object;
+        int32 parent;           // next free node when in free list
+        int32 child1;
+        int32 child2;
+        int32 height;           // leaf = 0, free node = -1
+
+        bool isLeaf() const { return child1 == NULL_NODE; }
+    };
+
+public:
+    static constexpr float BOUNDS_MARGIN = 2.0f;
+
+    DynamicBVH() : _root(NULL_NODE), _freeList(NULL_NODE) { }
+
+    void insert(T const& obj)
+    {
+        int32 leaf = allocateNode();
+        _nodes[leaf].bounds = getFatBounds(obj);
+        _nodes[leaf].object = &obj;
+        _nodes[leaf].height = 0;
+        _leaves[&obj] = leaf;
+        insertLeaf(leaf);
+    }
+
+    void remove(T const& obj)
+    {
+        auto itr = _leaves.find(&obj);
+        if (itr == _leaves.end())
+            return;
+
+        removeLeaf(itr->second);
+        freeNode(itr->second);
+        _leaves.erase(itr);
+    }
+
+    // refits the tree after bounds of obj changed, returns true if its leaf had to be reinserted
+    bool move(T const& obj)
+    {
+        auto itr = _leaves.find(&obj);
+        if (itr == _leaves.end())
+            return false;
+
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        int32 leaf = itr->second;
+        if (_nodes[leaf].bounds.contains(bounds))
+            return false;
+
+        removeLeaf(leaf);
+        _nodes[leaf].bounds = getFatBounds(obj);
+        insertLeaf(leaf);
+        return true;
+    }
+
+    bool empty() const { return _root == NULL_NODE; }
+    uint32 size() const { return uint32(_leaves.size()); }
+    int32 height() const { return _root != NULL_NODE ? _nodes[_root].height : 0; }
+
+    template<typename RayCallback>
+    void intersectRay(G3D::Ray const& ray, RayCallback& intersectCallback, float& maxDist) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        int32 stack[MAX_STACK_SIZE];
+        int32 stackPos = 0;
+        stack[stackPos++] = _root;
+        while (stackPos > 0)
+        {
+            Node const& node = _nodes[stack[--stackPos]];
+            if (node.isLeaf())
+            {
+                // stop at first hit, same as BIHWrap did
+                if (intersectCallback(ray, *node.object, maxDist))
+                    return;
+                continue;
+            }
+
+            // visit nearer child first so first hit is usually the closest one
+            float near1, near2;
+            bool hit1 = intersectBounds(_nodes[node.child1].bounds, ray, maxDist, near1);
+            bool hit2 = intersectBounds(_nodes[node.child2].bounds, ray, maxDist, near2);
+            if (hit1 && hit2)
+            {
+                ASSERT(stackPos + 2 <= MAX_STACK_SIZE);
+                stack[stackPos++] = near1 <= near2 ? node.child2 : node.child1;
+                stack[stackPos++] = near1 <= near2 ? node.child1 : node.child2;
+            }
+            else if (hit1 || hit2)
+            {
+                ASSERT(stackPos + 1 <= MAX_STACK_SIZE);
+                stack[stackPos++] = hit1 ? node.child1 : node.child2;
+            }
+        }
+    }
+
+    template<typename IsectCallback>
+    void intersectPoint(G3D::Vector3 const& point, IsectCallback& intersectCallback) const
+    {
+        if (_root == NULL_NODE)
+            return;
+
+        int32 stack[MAX_STACK_SIZE];
+        int32 stackPos = 0;
+        stack[stackPos++] = _root;
+        while (stackPos > 0)
+        {
+            Node const& node = _nodes[stack[--stackPos]];
+            if (!node.bounds.contains(point))
+                continue;
+
+            if (node.isLeaf())
+                intersectCallback(point, *node.object);
+            else
+            {
+                ASSERT(stackPos + 2 <= MAX_STACK_SIZE);
+                stack[stackPos++] = node.child1;
+                stack[stackPos++] = node.child2;
+            }
+        }
+    }
+
+private:
+    static G3D::AABox getFatBounds(T const& obj)
+    {
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(obj, bounds);
+        G3D::Vector3 margin(BOUNDS_MARGIN, BOUNDS_MARGIN, BOUNDS_MARGIN);
+        return G3D::AABox(bounds.low() - margin, bounds.high() + margin);
+    }
+
+    static G3D::AABox merge(G3D::AABox const& left, G3D::AABox const& right)
+    {
+        return G3D::AABox(left.low().min(right.low()), left.high().max(right.high()));
+    }
+
+    static bool intersectBounds(G3D::AABox const& bounds, G3D::Ray const& ray, float maxDist, float& tNear)
+    {
+        float tMin = 0.0f;
+        float tMax = maxDist;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float origin = ray.origin()[axis];
+            if (ray.direction()[axis] == 0.0f)
+            {
+                if (origin < bounds.low()[axis] || origin > bounds.high()[axis])
+                    return false;
+                continue;
+            }
+
+            float t1 = (bounds.low()[axis] - origin) * ray.invDirection()[axis];
+            float t2 = (bounds.high()[axis] - origin) * ray.invDirection()[axis];
+            if (t1 > t2)
+                std::swap(t1, t2);
+            tMin = std::max(tMin, t1);
+            tMax = std::min(tMax, t2);
+            if (tMin > tMax)
+                return false;
+        }
+
+        tNear = tMin;
+        return true;
+    }
+
+    int32 allocateNode()
+    {
+        if (_freeList == NULL_NODE)
+        {
+            _nodes.emplace_back();
+            _freeList = int32(_nodes.size() - 1);
+            _nodes[_freeList].parent = NULL_NODE;
+        }
+
+        int32 index = _freeList;
+        Node& node = _nodes[index];
+        _freeList = node.parent;
+        node.object = nullptr;
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        return index;
+    }
+
+    void freeNode(int32 index)
+    {
+        _nodes[index].parent = _freeList;
+        _nodes[index].height = -1;
+        _freeList = index;
+    }
+
+    void insertLeaf(int32 leaf)
+    {
+        if (_root == NULL_NODE)
+        {
+            _root = leaf;
+            _nodes[leaf].parent = NULL_NODE;
+            return;
+        }
+
+        // find the best sibling by surface area heuristic
+        G3D::AABox leafBounds = _nodes[leaf].bounds;
+        int32 index = _root;
+        while (!_nodes[index].isLeaf())
+        {
+            Node const& node = _nodes[index];
+            float area = node.bounds.area();
+            float combinedArea = merge(node.bounds, leafBounds).area();
+
+            // cost of creating a new parent for this node and the new leaf
+            float cost = 2.0f * combinedArea;
+            // minimum cost of pushing the leaf further down the tree
+            float inheritanceCost = 2.0f * (combinedArea - area);
+
+            auto descendCost = [&](int32 child)
+            {
+                Node const& childNode = _nodes[child];
+                float newArea = merge(leafBounds, childNode.bounds).area();
+                return (childNode.isLeaf() ? newArea : newArea - childNode.bounds.area()) + inheritanceCost;
+            };
+
+            float cost1 = descendCost(node.child1);
+            float cost2 = descendCost(node.child2);
+            if (cost < cost1 && cost < cost2)
+                break;
+
+            index = cost1 < cost2 ? node.child1 : node.child2;
+        }
+
+        int32 sibling = index;
+        int32 oldParent = _nodes[sibling].parent;
+        int32 newParent = allocateNode();
+        _nodes[newParent].parent = oldParent;
+        _nodes[newParent].bounds = merge(leafBounds, _nodes[sibling].bounds);
+        _nodes[newParent].height = _nodes[sibling].height + 1;
+        _nodes[newParent].child1 = sibling;
+        _nodes[newParent].child2 = leaf;
+        _nodes[sibling].parent = newParent;
+        _nodes[leaf].parent = newParent;
+
+        if (oldParent != NULL_NODE)
+        {
+            if (_nodes[oldParent].child1 == sibling)
+                _nodes[oldParent].child1 = newParent;
+            else
+                _nodes[oldParent].child2 = newParent;
+        }
+        else
+            _root = newParent;
+
+        refit(_nodes[leaf].parent);
+    }
+
+    void removeLeaf(int32 leaf)
+    {
+        if (leaf == _root)
+        {
+            _root = NULL_NODE;
+            return;
+        }
+
+        int32 parent = _nodes[leaf].parent;
+        int32 grandParent = _nodes[parent].parent;
+        int32 sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+        if (grandParent != NULL_NODE)
+        {
+            if (_nodes[grandParent].child1 == parent)
+                _nodes[grandParent].child1 = sibling;
+            else
+                _nodes[grandParent].child2 = sibling;
+            _nodes[sibling].parent = grandParent;
+            freeNode(parent);
+            refit(grandParent);
+        }
+        else
+        {
+            _root = sibling;
+            _nodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+    }
+
+    // walks back up to the root fixing bounds and heights of touched nodes only
+    void refit(int32 index)
+    {
+        while (index != NULL_NODE)
+        {
+            index = rotate(index);
+
+            Node& node = _nodes[index];
+            node.height = 1 + std::max(_nodes[node.child1].height, _nodes[node.child2].height);
+            node.bounds = merge(_nodes[node.child1].bounds, _nodes[node.child2].bounds);
+            index = node.parent;
+        }
+    }
+
+    // promotes a grandchild if the subtree of indexA is unbalanced, returns the new subtree root
+    int32 rotate(int32 indexA)
+    {
+        Node& a = _nodes[indexA];
+        if (a.isLeaf() || a.height < 2)
+            return indexA;
+
+        int32 indexB = a.child1;
+        int32 indexC = a.child2;
+        int32 balance = _nodes[indexC].height - _nodes[indexB].height;
+        if (balance > 1)
+            return rotateUp(indexA, indexC, indexB, false);
+        if (balance < -1)
+            return rotateUp(indexA, indexB, indexC, true);
+        return indexA;
+    }
+
+    // moves child indexUp of indexA into its place, keeping indexOther below indexA
+    int32 rotateUp(int32 indexA, int32 indexUp, int32 indexOther, bool upIsChild1)
+    {
+        Node& a = _nodes[indexA];
+        Node& up = _nodes[indexUp];
+        int32 indexF = up.child1;
+        int32 indexG = up.child2;
+        Node& f = _nodes[indexF];
+        Node& g = _nodes[indexG];
+
+        up.child1 = indexA;
+        up.parent = a.parent;
+        a.parent = indexUp;
+
+        if (up.parent != NULL_NODE)
+        {
+            if (_nodes[up.parent].child1 == indexA)
+                _nodes[up.parent].child1 = indexUp;
+            else
+                _nodes[up.parent].child2 = indexUp;
+        }
+        else
+            _root = indexUp;
+
+        // taller grandchild stays with the promoted node, the other one replaces it below indexA
+        int32 indexKeep = f.height > g.height ? indexF : indexG;
+        int32 indexMove = f.height > g.height ? indexG : indexF;
+        up.child2 = indexKeep;
+        if (upIsChild1)
+            a.child1 = indexMove;
+        else
+            a.child2 = indexMove;
+        _nodes[indexMove].parent = indexA;
+
+        Node const& other = _nodes[indexOther];
+        Node const& moved = _nodes[indexMove];
+        Node const& kept = _nodes[indexKeep];
+        a.bounds = merge(other.bounds, moved.bounds);
+        up.bounds = merge(a.bounds, kept.bounds);
+        a.height = 1 + std::max(other.height, moved.height);
+        up.height = 1 + std::max(a.height, kept.height);
+        return indexUp;
+    }
+
+    std::vector<Node> _nodes;
+    std::unordered_map<T const*, int32> _leaves;
+    int32 _root;
+    int32 _freeList;
+};
+
+#endif // _DYNAMIC_BVH_H
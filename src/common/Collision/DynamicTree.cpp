@@ -16,27 +16,22 @@
  */
 
 #include "DynamicTree.h"
-#include "BoundingIntervalHierarchyWrapper.h"
+#include "DynamicBoundingVolumeHierarchy.h"
 #include "GameObjectModel.h"
+#include "LineOfSightCache.h"
 #include "MapTree.h"
 #include "ModelIgnoreFlags.h"
 #include "RegularGrid.h"
-#include "Timer.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
 #include "WorldModel.h"
 #include <G3D/AABox.h>
 #include <G3D/Ray.h>
 #include <G3D/Vector3.h>
+#include <chrono>
 
 using VMAP::ModelInstance;
 
-namespace {
-
-int CHECK_TREE_PERIOD = 200;
-
-} // namespace
-
 template<> struct HashTrait< GameObjectModel>{
     static size_t hashCode(GameObjectModel const& g) { return (size_t)(void*)&g; }
 };
@@ -47,7 +42,6 @@ template<> struct PositionTrait< GameObjectModel> {
 
 template<> struct BoundsTrait< GameObjectModel> {
     static void getBounds(GameObjectModel const& g, G3D::AABox& out) { out = g.getBounds();}
-    static void getBounds2(GameObjectModel const* g, G3D::AABox& out) { out = g->getBounds();}
 };
 
 /*
@@ -56,53 +50,66 @@ static bool operator==(GameObjectModel const& mdl, GameObjectModel const& mdl2){
 }
 */
 
-typedef RegularGrid2D<GameObjectModel, BIHWrap<GameObjectModel> > ParentTree;
+typedef RegularGrid2D<GameObjectModel, DynamicBVH<GameObjectModel> > ParentTree;
 
 struct DynTreeImpl : public ParentTree/*, public Intersectable*/
 {
     typedef GameObjectModel Model;
     typedef ParentTree base;
 
-    DynTreeImpl() :
-        rebalance_timer(CHECK_TREE_PERIOD),
-        unbalanced_times(0)
-    {
-    }
+    DynTreeImpl() : losCache(nullptr), stats() { }
 
     void insert(Model const& mdl)
     {
+        UpdateTimer timer(*this);
         base::insert(mdl);
-        ++unbalanced_times;
+        modelBounds[&mdl] = mdl.getBounds();
+        invalidateLineOfSight(mdl.getBounds());
+        ++stats.Inserts;
     }
 
     void remove(Model const& mdl)
     {
+        UpdateTimer timer(*this);
         base::remove(mdl);
-        ++unbalanced_times;
+        auto itr = modelBounds.find(&mdl);
+        if (itr != modelBounds.end())
+        {
+            invalidateLineOfSight(itr->second);
+            modelBounds.erase(itr);
+        }
+        ++stats.Removes;
     }
 
-    void balance()
+    void move(Model const& mdl)
     {
-        base::balance();
-        unbalanced_times = 0;
+        UpdateTimer timer(*this);
+        base::move(mdl);
+        G3D::AABox& bounds = modelBounds[&mdl];
+        invalidateLineOfSight(bounds);
+        invalidateLineOfSight(mdl.getBounds());
+        bounds = mdl.getBounds();
+        ++stats.Moves;
     }
 
-    void update(uint32 difftime)
+    void invalidateLineOfSight(G3D::AABox const& bounds)
     {
-        if (empty())
-            return;
-
-        rebalance_timer.Update(difftime);
-        if (rebalance_timer.Passed())
-        {
-            rebalance_timer.Reset(CHECK_TREE_PERIOD);
-            if (unbalanced_times > 0)
-                balance();
-        }
+        if (losCache)
+            losCache->Invalidate(bounds);
     }
 
-    TimeTracker rebalance_timer;
-    int unbalanced_times;
+    struct UpdateTimer
+    {
+        explicit UpdateTimer(DynTreeImpl& tree) : Tree(tree), Start(std::chrono::steady_clock::now()) { }
+        ~UpdateTimer() { Tree.stats.UpdateTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count(); }
+
+        DynTreeImpl& Tree;
+        std::chrono::steady_clock::time_point Start;
+    };
+
+    LineOfSightCache* losCache;
+    std::unordered_map<Model const*, G3D::AABox> modelBounds;
+    DynamicMapTreeStats stats;
 };
 
 DynamicMapTree::DynamicMapTree() : impl(new DynTreeImpl()) { }
@@ -122,19 +129,34 @@ void DynamicMapTree::remove(GameObjectModel const& mdl)
     impl->remove(mdl);
 }
 
+void DynamicMapTree::move(GameObjectModel const& mdl)
+{
+    impl->move(mdl);
+}
+
+void DynamicMapTree::collisionChanged(GameObjectModel const& mdl)
+{
+    impl->invalidateLineOfSight(mdl.getBounds());
+}
+
+void DynamicMapTree::setLineOfSightCache(LineOfSightCache* cache)
+{
+    impl->losCache = cache;
+}
+
 bool DynamicMapTree::contains(GameObjectModel const& mdl) const
 {
     return impl->contains(mdl);
 }
 
-void DynamicMapTree::balance()
+DynamicMapTreeStats DynamicMapTree::getStats() const
 {
-    impl->balance();
+    return impl->stats;
 }
 
-void DynamicMapTree::update(uint32 t_diff)
+void DynamicMapTree::resetStats()
 {
-    impl->update(t_diff);
+    impl->stats = DynamicMapTreeStats();
 }
 
 struct DynamicTreeIntersectionCallback
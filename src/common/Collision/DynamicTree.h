@@ -27,6 +27,7 @@ namespace G3D
 }
 
 class GameObjectModel;
+class LineOfSightCache;
 struct DynTreeImpl;
 
 namespace VMAP
@@ -34,6 +35,14 @@ namespace VMAP
     struct AreaAndLiquidData;
 }
 
+struct DynamicMapTreeStats
+{
+    uint32 Inserts;
+    uint32 Removes;
+    uint32 Moves;
+    uint64 UpdateTime;      // nanoseconds spent changing the tree
+};
+
 class TC_COMMON_API DynamicMapTree
 {
     DynTreeImpl *impl;
@@ -59,10 +68,18 @@ public:
 
     void insert(GameObjectModel const&);
     void remove(GameObjectModel const&);
+    // model bounds changed (transport, elevator), only tree nodes it touches are updated
+    void move(GameObjectModel const&);
     bool contains(GameObjectModel const&) const;
+    // model enabled/disabled its collision or changed phase
+    void collisionChanged(GameObjectModel const&);
+
+    // cached line of sight results around models changing their collision are dropped
+    void setLineOfSightCache(LineOfSightCache* cache);
 
-    void balance();
-    void update(uint32 diff);
+    // changes since last resetStats
+    DynamicMapTreeStats getStats() const;
+    void resetStats();
 };
 
 #endif // _DYNTREE_H
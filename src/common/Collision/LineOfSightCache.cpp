@@ -0,0 +1,126 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LineOfSightCache.h"
+#include <G3D/AABox.h>
+#include <G3D/Vector3.h>
+#include <algorithm>
+#include <bit>
+
+LineOfSightCache::LineOfSightCache(uint32 capacity, uint32 ttl) : _entries(std::bit_ceil(std::max<uint32>(capacity, LOCK_COUNT))), _ttl(ttl),
+    _hits(0), _misses(0), _invalidations(0), _missTime(0)
+{
+}
+
+LineOfSightCache::Key LineOfSightCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 flags)
+{
+    Key key;
+    key.Points = { x1, y1, z1, x2, y2, z2 };
+    key.PhaseMask = phaseMask;
+    key.Flags = flags;
+    return key;
+}
+
+std::size_t LineOfSightCache::GetIndex(Key const& key) const
+{
+    std::size_t hash = 0;
+    auto combine = [&hash](uint32 value) { hash ^= std::size_t(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    for (float point : key.Points)
+        combine(std::bit_cast<uint32>(point));
+
+    combine(key.PhaseMask);
+    combine(key.Flags);
+    return hash & (_entries.size() - 1);
+}
+
+bool LineOfSightCache::Find(Key const& key, uint32 now, bool& result)
+{
+    std::size_t index = GetIndex(key);
+    {
+        std::lock_guard<std::mutex> lock(_locks[index % LOCK_COUNT]);
+        Entry const& entry = _entries[index];
+        if (entry.Valid && entry.EntryKey == key && now - entry.StoreTime < _ttl)
+        {
+            result = entry.Result;
+            _hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    _misses.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void LineOfSightCache::Store(Key const& key, uint32 now, bool result, uint64 calculationTime)
+{
+    _missTime.fetch_add(calculationTime, std::memory_order_relaxed);
+
+    std::size_t index = GetIndex(key);
+    std::lock_guard<std::mutex> lock(_locks[index % LOCK_COUNT]);
+    Entry& entry = _entries[index];
+    entry.EntryKey = key;
+    entry.StoreTime = now;
+    entry.Valid = true;
+    entry.Result = result;
+}
+
+void LineOfSightCache::Invalidate(G3D::AABox const& bounds)
+{
+    uint64 invalidations = 0;
+    for (std::size_t lockIndex = 0; lockIndex < LOCK_COUNT; ++lockIndex)
+    {
+        std::lock_guard<std::mutex> lock(_locks[lockIndex]);
+        for (std::size_t i = lockIndex; i < _entries.size(); i += LOCK_COUNT)
+        {
+            Entry& entry = _entries[i];
+            if (!entry.Valid)
+                continue;
+
+            // bounding box of the segment
+            std::array<float, 6> const& points = entry.EntryKey.Points;
+            G3D::Vector3 low(std::min(points[0], points[3]), std::min(points[1], points[4]), std::min(points[2], points[5]));
+            G3D::Vector3 high(std::max(points[0], points[3]), std::max(points[1], points[4]), std::max(points[2], points[5]));
+            if (!bounds.intersects(G3D::AABox(low, high)))
+                continue;
+
+            entry.Valid = false;
+            ++invalidations;
+        }
+    }
+
+    _invalidations.fetch_add(invalidations, std::memory_order_relaxed);
+}
+
+void LineOfSightCache::Clear()
+{
+    for (std::size_t lockIndex = 0; lockIndex < LOCK_COUNT; ++lockIndex)
+    {
+        std::lock_guard<std::mutex> lock(_locks[lockIndex]);
+        for (std::size_t i = lockIndex; i < _entries.size(); i += LOCK_COUNT)
+            _entries[i].Valid = false;
+    }
+}
+
+LineOfSightCacheStats LineOfSightCache::GetStats() const
+{
+    LineOfSightCacheStats stats;
+    stats.Hits = _hits.load(std::memory_order_relaxed);
+    stats.Misses = _misses.load(std::memory_order_relaxed);
+    stats.Invalidations = _invalidations.load(std::memory_order_relaxed);
+    stats.MissTime = _missTime.load(std::memory_order_relaxed);
+    return stats;
+}
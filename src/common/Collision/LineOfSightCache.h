@@ -0,0 +1,98 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LINE_OF_SIGHT_CACHE_H
+#define _LINE_OF_SIGHT_CACHE_H
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace G3D
+{
+    class AABox;
+}
+
+struct LineOfSightCacheStats
+{
+    uint64 Hits = 0;
+    uint64 Misses = 0;
+    uint64 Invalidations = 0;   // entries dropped by Invalidate
+    uint64 MissTime = 0;        // nanoseconds spent calculating missed results
+};
+
+// Results of line of sight checks of a map (vmap.LosCache.*), keyed by exact endpoints,
+// phase mask and check flags. Fixed size and direct mapped, a new result replaces
+// whatever was stored in its slot. Entries expire after ttl milliseconds so changes that do not go
+// through DynamicMapTree (gameobjects despawning) are picked up eventually, models inserted, removed
+// or toggling collision invalidate entries with overlapping bounds right away.
+class TC_COMMON_API LineOfSightCache
+{
+    public:
+        struct Key
+        {
+            std::array<float, 6> Points;
+            uint32 PhaseMask;
+            uint32 Flags;
+
+            bool operator==(Key const& right) const = default;
+        };
+
+        LineOfSightCache(uint32 capacity, uint32 ttl);
+
+        LineOfSightCache(LineOfSightCache const&) = delete;
+        LineOfSightCache& operator=(LineOfSightCache const&) = delete;
+
+        static Key MakeKey(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phaseMask, uint32 flags);
+
+        // now is any millisecond clock, same for Find and Store
+        bool Find(Key const& key, uint32 now, bool& result);
+        void Store(Key const& key, uint32 now, bool result, uint64 calculationTime);
+
+        // drops entries whose segment intersects bounds
+        void Invalidate(G3D::AABox const& bounds);
+        void Clear();
+
+        std::size_t GetCapacity() const { return _entries.size(); }
+        LineOfSightCacheStats GetStats() const;
+
+    private:
+        struct Entry
+        {
+            Key EntryKey;
+            uint32 StoreTime = 0;
+            bool Valid = false;
+            bool Result = false;
+        };
+
+        static constexpr std::size_t LOCK_COUNT = 16;
+
+        std::size_t GetIndex(Key const& key) const;
+
+        std::vector<Entry> _entries;
+        std::array<std::mutex, LOCK_COUNT> _locks;  // entry i is guarded by _locks[i % LOCK_COUNT]
+        uint32 _ttl;
+
+        std::atomic<uint64> _hits;
+        std::atomic<uint64> _misses;
+        std::atomic<uint64> _invalidations;
+        std::atomic<uint64> _missTime;
+};
+
+#endif // _LINE_OF_SIGHT_CACHE_H
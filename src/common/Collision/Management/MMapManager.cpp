@@ -16,15 +16,31 @@
  */
 
 #include "MMapManager.h"
+#include "DetourCommon.h"
+#include "DetourNode.h"
 #include "Errors.h"
 #include "Log.h"
 #include "MapDefines.h"
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 namespace MMAP
 {
     constexpr char MAP_FILE_NAME_FORMAT[] = "{}mmaps/{:03}.mmap";
     constexpr char TILE_FILE_NAME_FORMAT[] = "{}mmaps/{:03}{:02}{:02}.mmtile";
 
+    MMapData::MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
+
+    MMapData::~MMapData()
+    {
+        for (ThreadNavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
+            dtFreeNavMeshQuery(i->second);
+
+        // navmesh does not touch data of tiles it does not own when freed, mapped tiles are unmapped after it
+        if (navMesh)
+            dtFreeNavMesh(navMesh);
+    }
+
     // ######################## MMapManager ########################
     MMapManager::~MMapManager()
     {
@@ -162,6 +178,12 @@ namespace MMAP
             return false;
         }
 
+        if (memoryMappedTiles)
+        {
+            fclose(file);
+            return loadMappedTile(mmap, fileName, mapId, x, y, std::size_t(pos), fileHeader.size);
+        }
+
         fseek(file, pos, SEEK_SET);
 
         unsigned char* data = (unsigned char*)dtAlloc(fileHeader.size, DT_ALLOC_PERM);
@@ -196,29 +218,50 @@ namespace MMAP
         }
     }
 
-    bool MMapManager::loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId)
+    bool MMapManager::loadMappedTile(MMapData* mmap, std::string const& fileName, uint32 mapId, int32 x, int32 y, std::size_t dataOffset, uint32 dataSize)
     {
-        if (!loadMapData(basePath, mapId))
+        std::unique_ptr<boost::interprocess::mapped_region> region;
+        try
+        {
+            // detour writes polygon links into tile data when the tile is added, only those pages
+            // become private copies, vertices, detail meshes and bv tree stay shared with page cache
+            boost::interprocess::file_mapping file(fileName.c_str(), boost::interprocess::read_only);
+            region = std::make_unique<boost::interprocess::mapped_region>(file, boost::interprocess::copy_on_write, 0, dataOffset + dataSize);
+        }
+        catch (boost::interprocess::interprocess_exception const& e)
+        {
+            TC_LOG_ERROR("maps", "MMAP:loadMap: Could not map {:03}{:02}{:02}.mmtile: {}", mapId, x, y, e.what());
             return false;
+        }
 
-        MMapData* mmap = loadedMMaps[mapId];
-        auto [queryItr, inserted] = mmap->navMeshQueries.try_emplace(instanceId, nullptr);
-        if (!inserted)
-            return true;
+        unsigned char* data = static_cast<unsigned char*>(region->get_address()) + dataOffset;
+        dtMeshHeader* header = (dtMeshHeader*)data;
+        dtTileRef tileRef = 0;
 
-        // allocate mesh query
-        dtNavMeshQuery* query = dtAllocNavMeshQuery();
-        ASSERT(query);
-        if (dtStatusFailed(query->init(mmap->navMesh, 1024)))
+        // data stays owned by the mapping
+        if (dtStatusSucceed(mmap->navMesh->addTile(data, dataSize, 0, 0, &tileRef)))
         {
-            dtFreeNavMeshQuery(query);
-            mmap->navMeshQueries.erase(queryItr);
-            TC_LOG_ERROR("maps", "MMAP:GetNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-            return false;
+            uint32 packedGridPos = packTileID(x, y);
+            mmap->loadedTileRefs.insert(std::pair<uint32, dtTileRef>(packedGridPos, tileRef));
+            mmap->mappedTiles[packedGridPos] = std::move(region);
+            ++loadedTiles;
+            TC_LOG_DEBUG("maps", "MMAP:loadMap: Mapped mmtile {:03}[{:02}, {:02}] into {:03}[{:02}, {:02}]", mapId, x, y, mapId, header->x, header->y);
+            return true;
         }
 
-        TC_LOG_DEBUG("maps", "MMAP:GetNavMeshQuery: created dtNavMeshQuery for mapId {:03} instanceId {}", mapId, instanceId);
-        queryItr->second = query;
+        TC_LOG_ERROR("maps", "MMAP:loadMap: Could not load {:03}{:02}{:02}.mmtile into navmesh", mapId, x, y);
+        return false;
+    }
+
+    bool MMapManager::loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId)
+    {
+        if (!loadMapData(basePath, mapId))
+            return false;
+
+        // queries are created by threads using the map, nothing is allocated per instance
+        MMapData* mmap = loadedMMaps[mapId];
+        std::unique_lock<std::shared_mutex> lock(mmap->lock);
+        mmap->loadedInstances.insert(instanceId);
         return true;
     }
 
@@ -258,6 +301,7 @@ namespace MMAP
         else
         {
             mmap->loadedTileRefs.erase(packedGridPos);
+            mmap->mappedTiles.erase(packedGridPos);
             --loadedTiles;
             TC_LOG_DEBUG("maps", "MMAP:unloadMap: Unloaded mmtile {:03}[{:02}, {:02}] from {:03}", mapId, x, y, mapId);
             return true;
@@ -310,15 +354,13 @@ namespace MMAP
         }
 
         MMapData* mmap = itr->second;
-        auto queryItr = mmap->navMeshQueries.find(instanceId);
-        if (queryItr == mmap->navMeshQueries.end())
+        std::unique_lock<std::shared_mutex> lock(mmap->lock);
+        if (!mmap->loadedInstances.erase(instanceId))
         {
-            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId {:03} instanceId {}", mapId, instanceId);
+            TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Asked to unload not loaded instance mapId {:03} instanceId {}", mapId, instanceId);
             return false;
         }
 
-        dtFreeNavMeshQuery(queryItr->second);
-        mmap->navMeshQueries.erase(queryItr);
         TC_LOG_DEBUG("maps", "MMAP:unloadMapInstance: Unloaded mapId {:03} instanceId {}", mapId, instanceId);
 
         return true;
@@ -339,10 +381,89 @@ namespace MMAP
         if (itr == loadedMMaps.end())
             return nullptr;
 
-        auto queryItr = itr->second->navMeshQueries.find(instanceId);
-        if (queryItr == itr->second->navMeshQueries.end())
+        {
+            std::shared_lock<std::shared_mutex> lock(itr->second->lock);
+            if (!itr->second->loadedInstances.contains(instanceId))
+                return nullptr;
+        }
+
+        return GetThreadNavMeshQuery(mapId);
+    }
+
+    dtNavMeshQuery const* MMapManager::GetThreadNavMeshQuery(uint32 mapId)
+    {
+        auto itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return nullptr;
+
+        MMapData* mmap = itr->second;
+        std::thread::id const threadId = std::this_thread::get_id();
+        {
+            std::shared_lock<std::shared_mutex> lock(mmap->lock);
+            auto queryItr = mmap->navMeshQueries.find(threadId);
+            if (queryItr != mmap->navMeshQueries.end())
+                return queryItr->second;
+        }
+
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        ASSERT(query);
+        if (dtStatusFailed(query->init(mmap->navMesh, NAV_MESH_QUERY_MAX_NODES)))
+        {
+            dtFreeNavMeshQuery(query);
+            TC_LOG_ERROR("maps", "MMAP:GetThreadNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId {:03}", mapId);
             return nullptr;
+        }
+
+        // only the calling thread can insert its own query
+        std::unique_lock<std::shared_mutex> lock(mmap->lock);
+        mmap->navMeshQueries[threadId] = query;
+        TC_LOG_DEBUG("maps", "MMAP:GetThreadNavMeshQuery: created dtNavMeshQuery for mapId {:03}, {} threads use the map", mapId, mmap->navMeshQueries.size());
+        return query;
+    }
+
+    MMapMemoryStats MMapManager::GetMemoryStats(uint32 mapId) const
+    {
+        MMapMemoryStats stats;
+        auto itr = GetMMapData(mapId);
+        if (itr == loadedMMaps.end())
+            return stats;
+
+        MMapData* mmap = itr->second;
+        dtNavMesh const* navMesh = mmap->navMesh;
+        for (int32 i = 0; i < navMesh->getMaxTiles(); ++i)
+        {
+            dtMeshTile const* tile = navMesh->getTile(i);
+            if (!tile || !tile->header)
+                continue;
+
+            ++stats.Tiles;
+            stats.TileDataSize += tile->dataSize;
+        }
+
+        stats.MappedTiles = uint32(mmap->mappedTiles.size());
+
+        std::shared_lock<std::shared_mutex> lock(mmap->lock);
+        std::size_t const querySize = GetNavMeshQuerySize();
+        stats.Instances = uint32(mmap->loadedInstances.size());
+        stats.Queries = uint32(mmap->navMeshQueries.size());
+        stats.QueriesSize = stats.Queries * querySize;
+        if (stats.Instances > stats.Queries)
+            stats.QueriesSizeSaved = (stats.Instances - stats.Queries) * querySize;
+
+        return stats;
+    }
+
+    std::size_t MMapManager::GetNavMeshQuerySize()
+    {
+        // see dtNavMeshQuery::init, main and tiny node pools plus open list
+        auto nodePoolSize = [](int32 maxNodes, int32 hashSize)
+        {
+            return sizeof(dtNodePool) + maxNodes * (sizeof(dtNode) + sizeof(dtNodeIndex)) + hashSize * sizeof(dtNodeIndex);
+        };
 
-        return queryItr->second;
+        return sizeof(dtNavMeshQuery)
+            + nodePoolSize(NAV_MESH_QUERY_MAX_NODES, int32(dtNextPow2(NAV_MESH_QUERY_MAX_NODES / 4)))
+            + nodePoolSize(64, 32)
+            + sizeof(dtNodeQueue) + (NAV_MESH_QUERY_MAX_NODES + 1) * sizeof(dtNode*);
     }
 }
@@ -21,34 +21,57 @@
 #include "Define.h"
 #include "DetourNavMesh.h"
 #include "DetourNavMeshQuery.h"
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
+namespace boost::interprocess
+{
+    class mapped_region;
+}
+
 //  move map related classes
 namespace MMAP
 {
     typedef std::unordered_map<uint32, dtTileRef> MMapTileSet;
-    typedef std::unordered_map<uint32, dtNavMeshQuery*> NavMeshQuerySet;
+    typedef std::unordered_set<uint32> MMapInstanceSet;
+    typedef std::unordered_map<std::thread::id, dtNavMeshQuery*> ThreadNavMeshQuerySet;
+    typedef std::unordered_map<uint32, std::unique_ptr<boost::interprocess::mapped_region>> MMapMappedTileSet;
+
+    // node pool size of every dtNavMeshQuery, enough for MAX_PATH_LENGTH polygon corridors
+    constexpr int32 NAV_MESH_QUERY_MAX_NODES = 1024;
 
     // dummy struct to hold map's mmap data
     struct TC_COMMON_API MMapData
     {
-        MMapData(dtNavMesh* mesh) : navMesh(mesh) { }
-        ~MMapData()
-        {
-            for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
-                dtFreeNavMeshQuery(i->second);
-
-            if (navMesh)
-                dtFreeNavMesh(navMesh);
-        }
+        MMapData(dtNavMesh* mesh);
+        ~MMapData();
 
-        // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
-        NavMeshQuerySet navMeshQueries;     // instanceId to query
+        // navmesh is shared by all instances of the map, dtNavMeshQuery is not thread safe
+        // so every thread doing pathfinding on the map gets its own query instead of every instance
+        MMapInstanceSet loadedInstances;
+        ThreadNavMeshQuerySet navMeshQueries;   // thread to query
+        std::shared_mutex lock;                 // guards loadedInstances and navMeshQueries
 
         dtNavMesh* navMesh;
         MMapTileSet loadedTileRefs;        // maps [map grid coords] to [dtTile]
+        MMapMappedTileSet mappedTiles;     // maps [map grid coords] to tile file mapping owning the tile data (mmap.MemoryMappedTiles)
+    };
+
+    struct MMapMemoryStats
+    {
+        uint32 Tiles = 0;
+        uint32 MappedTiles = 0;
+        std::size_t TileDataSize = 0;
+        uint32 Instances = 0;
+        uint32 Queries = 0;
+        std::size_t QueriesSize = 0;
+        std::size_t QueriesSizeSaved = 0;   // compared to one query per instance
     };
 
     typedef std::unordered_map<uint32, MMapData*> MMapDataSet;
@@ -58,30 +81,41 @@ namespace MMAP
     class TC_COMMON_API MMapManager
     {
         public:
-            MMapManager() : loadedTiles(0), thread_safe_environment(true) {}
+            MMapManager() : loadedTiles(0), thread_safe_environment(true), memoryMappedTiles(false) {}
             ~MMapManager();
 
             void InitializeThreadUnsafe(const std::vector<uint32>& mapIds);
+            // tiles are loaded from copy on write mappings of the tile files instead of being read into private memory
+            void SetMemoryMappedTiles(bool enable) { memoryMappedTiles = enable; }
             bool loadMap(std::string const& basePath, uint32 mapId, int32 x, int32 y);
             bool loadMapInstance(std::string const& basePath, uint32 mapId, uint32 instanceId);
             bool unloadMap(uint32 mapId, int32 x, int32 y);
             bool unloadMap(uint32 mapId);
             bool unloadMapInstance(uint32 mapId, uint32 instanceId);
 
-            // the returned [dtNavMeshQuery const*] is NOT threadsafe
+            // the returned [dtNavMeshQuery const*] is owned by the calling thread and must not be passed to other threads
+            // returns nullptr if the instance is not loaded
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // same query, for any instance of the map
+            dtNavMeshQuery const* GetThreadNavMeshQuery(uint32 mapId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
             uint32 getLoadedMapsCount() const { return uint32(loadedMMaps.size()); }
+            MMapMemoryStats GetMemoryStats(uint32 mapId) const;
+
+            // approximate heap size of a single dtNavMeshQuery
+            static std::size_t GetNavMeshQuerySize();
         private:
             bool loadMapData(std::string const& basePath, uint32 mapId);
+            bool loadMappedTile(MMapData* mmap, std::string const& fileName, uint32 mapId, int32 x, int32 y, std::size_t dataOffset, uint32 dataSize);
             uint32 packTileID(int32 x, int32 y);
 
             MMapDataSet::const_iterator GetMMapData(uint32 mapId) const;
             MMapDataSet loadedMMaps;
             uint32 loadedTiles;
             bool thread_safe_environment;
+            bool memoryMappedTiles;
     };
 }
 
@@ -15,6 +15,7 @@
  * with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <string>
@@ -180,6 +181,26 @@ namespace VMAP
         return true;
     }
 
+    void VMapManager2::isInLineOfSight(uint32 mapId, std::span<Vector3 const> pos1, std::span<Vector3 const> pos2, std::span<bool> results, ModelIgnoreFlags ignoreFlags)
+    {
+        InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
+        if (!isLineOfSightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_LOS) || instanceTree == iInstanceMapTrees.end())
+        {
+            std::fill(results.begin(), results.end(), true);
+            return;
+        }
+
+        std::vector<Vector3> internalPos1(pos1.size());
+        std::vector<Vector3> internalPos2(pos2.size());
+        for (std::size_t i = 0; i < pos1.size(); ++i)
+        {
+            internalPos1[i] = convertPositionToInternalRep(pos1[i].x, pos1[i].y, pos1[i].z);
+            internalPos2[i] = convertPositionToInternalRep(pos2[i].x, pos2[i].y, pos2[i].z);
+        }
+
+        instanceTree->second->isInLineOfSight(internalPos1, internalPos2, results, ignoreFlags);
+    }
+
     /**
     get the hit position and return true if we hit something
     otherwise the result pos will be the dest pos
@@ -233,6 +254,25 @@ namespace VMAP
         return VMAP_INVALID_HEIGHT_VALUE;
     }
 
+    void VMapManager2::getHeights(uint32 mapId, std::span<Vector3 const> positions, std::span<float> heights, float maxSearchDist)
+    {
+        InstanceTreeMap::const_iterator instanceTree = GetMapTree(mapId);
+        if (!isHeightCalcEnabled() || IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_HEIGHT) || instanceTree == iInstanceMapTrees.end())
+        {
+            std::fill(heights.begin(), heights.end(), VMAP_INVALID_HEIGHT_VALUE);
+            return;
+        }
+
+        std::vector<Vector3> internalPositions(positions.size());
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            internalPositions[i] = convertPositionToInternalRep(positions[i].x, positions[i].y, positions[i].z);
+
+        instanceTree->second->getHeights(internalPositions, heights, maxSearchDist);
+        for (float& height : heights)
+            if (!(height < G3D::finf()))
+                height = VMAP_INVALID_HEIGHT_VALUE; // No height
+    }
+
     bool VMapManager2::getAreaInfo(uint32 mapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
     {
         if (!IsVMAPDisabledForPtr(mapId, VMAP_DISABLE_AREAFLAG))
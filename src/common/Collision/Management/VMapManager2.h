@@ -19,6 +19,7 @@
 #define _VMAPMANAGER2_H
 
 #include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 #include "Define.h"
@@ -113,6 +114,10 @@ namespace VMAP
             bool getObjectHitPos(unsigned int mapId, float x1, float y1, float z1, float x2, float y2, float z2, float& rx, float& ry, float& rz, float modifyDist) override;
             float getHeight(unsigned int mapId, float x, float y, float z, float maxSearchDist) override;
 
+            // batch versions of isInLineOfSight and getHeight for many positions on the same map, positions are in world coordinates
+            void isInLineOfSight(uint32 mapId, std::span<G3D::Vector3 const> pos1, std::span<G3D::Vector3 const> pos2, std::span<bool> results, ModelIgnoreFlags ignoreFlags);
+            void getHeights(uint32 mapId, std::span<G3D::Vector3 const> positions, std::span<float> heights, float maxSearchDist);
+
             bool processCommand(char* /*command*/) override { return false; } // for debug and extensions
 
             bool getAreaInfo(uint32 mapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const override;
@@ -17,6 +17,7 @@
 
 #include "MapTree.h"
 #include "ModelInstance.h"
+#include "RayPacket.h"
 #include "VMapManager2.h"
 #include "VMapDefinitions.h"
 #include "Log.h"
@@ -26,6 +27,7 @@
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <limits>
 
 using G3D::Vector3;
@@ -50,6 +52,23 @@ namespace VMAP
         ModelIgnoreFlags flags;
     };
 
+    class MapRayPacketCallback
+    {
+        public:
+            MapRayPacketCallback(ModelInstance* val, ModelIgnoreFlags ignoreFlags): prims(val), hits(0), flags(ignoreFlags) { }
+            uint32 operator()(RayPacket const& packet, uint32 entry, float* distance, uint32 laneMask, bool pStopAtFirstHit)
+            {
+                uint32 result = prims[entry].intersectRayPacket(packet, distance, laneMask, pStopAtFirstHit, flags);
+                hits |= result;
+                return result;
+            }
+            uint32 getHits() const { return hits; }
+        protected:
+            ModelInstance* prims;
+            uint32 hits;
+            ModelIgnoreFlags flags;
+    };
+
     class AreaInfoCallback
     {
         public:
@@ -151,6 +170,24 @@ namespace VMAP
         return intersectionCallBack.didHit();
     }
 
+    //=========================================================
+    /**
+    Packet version of getIntersectionTime, returns the lanes that hit something.
+    pMaxDist of those lanes is set to their intersection distance
+    */
+    uint32 StaticMapTree::getIntersectionTimes(RayPacket const& packet, float* pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const
+    {
+        float distance[RayPacket::WIDTH];
+        std::copy_n(pMaxDist, RayPacket::WIDTH, distance);
+        MapRayPacketCallback intersectionCallBack(iTreeValues, ignoreFlags);
+        iTree.intersectRayPacket(packet, intersectionCallBack, distance, pStopAtFirstHit);
+        RayPacket::ForEachLane(intersectionCallBack.getHits(), [&](uint32 lane)
+        {
+            pMaxDist[lane] = distance[lane];
+        });
+        return intersectionCallBack.getHits();
+    }
+
     //=========================================================
     bool StaticMapTree::isInLineOfSight(Vector3 const& pos1, Vector3 const& pos2, ModelIgnoreFlags ignoreFlag) const
     {
@@ -171,6 +208,44 @@ namespace VMAP
 
         return true;
     }
+    //=========================================================
+    void StaticMapTree::isInLineOfSight(std::span<Vector3 const> pos1, std::span<Vector3 const> pos2, std::span<bool> results, ModelIgnoreFlags ignoreFlags) const
+    {
+        ASSERT(pos1.size() == pos2.size() && pos1.size() == results.size());
+
+        RayPacketQueue queue([&](RayPacket const& packet, uint32 const* indices)
+        {
+            float maxDist[RayPacket::WIDTH];
+            for (uint32 lane = 0; lane < RayPacket::WIDTH; ++lane)
+                maxDist[lane] = lane < packet.Count ? (pos2[indices[lane]] - pos1[indices[lane]]).magnitude() : 0.f;
+
+            uint32 hits = getIntersectionTimes(packet, maxDist, true, ignoreFlags);
+            for (uint32 lane = 0; lane < packet.Count; ++lane)
+                results[indices[lane]] = !(hits & (1 << lane));
+        });
+
+        for (uint32 i = 0; i < pos1.size(); ++i)
+        {
+            // same early outs as single ray version
+            float maxDist = (pos2[i] - pos1[i]).magnitude();
+            if (maxDist == std::numeric_limits<float>::max() || !std::isfinite(maxDist))
+            {
+                results[i] = false;
+                continue;
+            }
+
+            if (maxDist < 1e-10f)
+            {
+                results[i] = true;
+                continue;
+            }
+
+            queue.Add(G3D::Ray::fromOriginAndDirection(pos1[i], (pos2[i] - pos1[i]) / maxDist), i);
+        }
+
+        queue.Flush();
+    }
+
     //=========================================================
     /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
@@ -235,6 +310,31 @@ namespace VMAP
         return(height);
     }
 
+    //=========================================================
+    void StaticMapTree::getHeights(std::span<Vector3 const> positions, std::span<float> heights, float maxSearchDist) const
+    {
+        ASSERT(positions.size() == heights.size());
+
+        // all rays point down, packets are filled in order
+        RayPacketQueue queue([&](RayPacket const& packet, uint32 const* indices)
+        {
+            float maxDist[RayPacket::WIDTH];
+            std::fill_n(maxDist, RayPacket::WIDTH, maxSearchDist);
+
+            uint32 hits = getIntersectionTimes(packet, maxDist, false, ModelIgnoreFlags::Nothing);
+            for (uint32 lane = 0; lane < packet.Count; ++lane)
+            {
+                Vector3 const& pos = positions[indices[lane]];
+                heights[indices[lane]] = (hits & (1 << lane)) ? pos.z - maxDist[lane] : G3D::finf();
+            }
+        });
+
+        for (uint32 i = 0; i < positions.size(); ++i)
+            queue.Add(G3D::Ray(positions[i], Vector3(0, 0, -1)), i);
+
+        queue.Flush();
+    }
+
     //=========================================================
     LoadResult StaticMapTree::CanLoadMap(const std::string &vmapPath, uint32 mapID, uint32 tileX, uint32 tileY)
     {
@@ -20,6 +20,7 @@
 
 #include "Define.h"
 #include "BoundingIntervalHierarchy.h"
+#include <span>
 #include <unordered_map>
 
 namespace VMAP
@@ -60,6 +61,7 @@ namespace VMAP
 
         private:
             bool getIntersectionTime(const G3D::Ray& pRay, float &pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            uint32 getIntersectionTimes(RayPacket const& packet, float* pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
             //bool containsLoadedMapTile(unsigned int pTileIdent) const { return(iLoadedMapTiles.containsKey(pTileIdent)); }
         public:
             static std::string getTileFileName(uint32 mapID, uint32 tileX, uint32 tileY);
@@ -73,6 +75,9 @@ namespace VMAP
             bool isInLineOfSight(const G3D::Vector3& pos1, const G3D::Vector3& pos2, ModelIgnoreFlags ignoreFlags) const;
             bool getObjectHitPos(const G3D::Vector3& pos1, const G3D::Vector3& pos2, G3D::Vector3& pResultHitPos, float pModifyDist) const;
             float getHeight(const G3D::Vector3& pPos, float maxSearchDist) const;
+            // batch versions of isInLineOfSight and getHeight, rays are traced in packets
+            void isInLineOfSight(std::span<G3D::Vector3 const> pos1, std::span<G3D::Vector3 const> pos2, std::span<bool> results, ModelIgnoreFlags ignoreFlags) const;
+            void getHeights(std::span<G3D::Vector3 const> positions, std::span<float> heights, float maxSearchDist) const;
             bool getAreaInfo(G3D::Vector3 &pos, uint32 &flags, int32 &adtId, int32 &rootId, int32 &groupId) const;
             bool GetLocationInfo(const G3D::Vector3 &pos, LocationInfo &info) const;
 
@@ -18,12 +18,16 @@
 #include "TileAssembler.h"
 #include "MapTree.h"
 #include "BoundingIntervalHierarchy.h"
+#include "ThreadPool.h"
 #include "VMapDefinitions.h"
 
+#include <atomic>
 #include <set>
 #include <iomanip>
 #include <sstream>
 #include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
 
 using G3D::Vector3;
 using G3D::AABox;
@@ -43,6 +47,48 @@ namespace VMAP
         return memcmp(dest, compare, len) == 0;
     }
 
+    // Raw model files are read through a read only mapping of the whole file instead of many small freads
+    class MappedFileReader
+    {
+        public:
+            MappedFileReader() : _data(nullptr), _size(0), _pos(0) { }
+
+            bool Open(char const* path)
+            {
+                try
+                {
+                    _mapping = boost::interprocess::file_mapping(path, boost::interprocess::read_only);
+                    _region = boost::interprocess::mapped_region(_mapping, boost::interprocess::read_only);
+                }
+                catch (boost::interprocess::interprocess_exception const&)
+                {
+                    return false;
+                }
+
+                _data = static_cast<char const*>(_region.get_address());
+                _size = _region.get_size();
+                _pos = 0;
+                return true;
+            }
+
+            bool Read(void* dest, std::size_t size)
+            {
+                if (_size - _pos < size)
+                    return false;
+
+                memcpy(dest, _data + _pos, size);
+                _pos += size;
+                return true;
+            }
+
+        private:
+            boost::interprocess::file_mapping _mapping;
+            boost::interprocess::mapped_region _region;
+            char const* _data;
+            std::size_t _size;
+            std::size_t _pos;
+    };
+
     Vector3 ModelPosition::transform(Vector3 const& pIn) const
     {
         Vector3 out = pIn * iScale;
@@ -52,8 +98,8 @@ namespace VMAP
 
     //=================================================================
 
-    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName)
-        : iDestDir(pDestDirName), iSrcDir(pSrcDirName)
+    TileAssembler::TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads)
+        : iDestDir(pDestDirName), iSrcDir(pSrcDirName), iThreads(std::max(threads, 1u))
     {
         boost::filesystem::create_directory(iDestDir);
         //init();
@@ -70,136 +116,173 @@ namespace VMAP
         if (!success)
             return false;
 
+        std::atomic<bool> allSucceeded(true);
+
         // export Map data
-        for (MapData::iterator map_iter = mapData.begin(); map_iter != mapData.end() && success; ++map_iter)
         {
-            // build global map tree
-            std::vector<ModelSpawn*> mapSpawns;
-            UniqueEntryMap::iterator entry;
-            printf("Calculating model bounds for map %u...\n", map_iter->first);
-            for (entry = map_iter->second->UniqueEntries.begin(); entry != map_iter->second->UniqueEntries.end(); ++entry)
+            Trinity::ThreadPool pool(iThreads);
+            for (std::pair<uint32 const, MapSpawns*>& map_iter : mapData)
             {
-                // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
-                if (entry->second.flags & MOD_M2)
+                pool.PostWork([this, &allSucceeded, &map_iter]()
                 {
-                    if (!calculateTransformedBound(entry->second))
-                        break;
-                }
-                else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
-                {
-                    /// @todo remove extractor hack and uncomment below line:
-                    //entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
-                    entry->second.iBound = entry->second.iBound + Vector3(533.33333f*32, 533.33333f*32, 0.f);
-                }
-                mapSpawns.push_back(&(entry->second));
-                spawnedModelFiles.insert(entry->second.name);
+                    if (allSucceeded && !convertMap(map_iter.first, *map_iter.second))
+                        allSucceeded = false;
+                });
             }
+            pool.Join();
+        }
 
-            printf("Creating map tree for map %u...\n", map_iter->first);
-            BIH pTree;
+        success = allSucceeded;
 
-            try
-            {
-                pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
-            }
-            catch (std::exception& e)
+        // add an object models, listed in temp_gameobject_models file
+        exportGameobjectModels();
+        // export objects
+        {
+            std::cout << "\nConverting Model Files" << std::endl;
+            std::atomic<bool> modelsSucceeded(true);
+            Trinity::ThreadPool pool(iThreads);
+            for (std::string const& spawnedModelFile : spawnedModelFiles)
             {
-                printf("Exception ""%s"" when calling pTree.build", e.what());
-                return false;
+                pool.PostWork([this, &modelsSucceeded, &spawnedModelFile]()
+                {
+                    if (!modelsSucceeded)
+                        return;
+
+                    printf("Converting %s\n", spawnedModelFile.c_str());
+                    if (!convertRawFile(spawnedModelFile))
+                    {
+                        printf("error converting %s\n", spawnedModelFile.c_str());
+                        modelsSucceeded = false;
+                    }
+                });
             }
+            pool.Join();
+
+            success = success && modelsSucceeded;
+        }
+
+        //cleanup:
+        for (std::pair<uint32 const, MapSpawns*>& map_iter : mapData)
+            delete map_iter.second;
+
+        return success;
+    }
 
-            // ===> possibly move this code to StaticMapTree class
-            std::map<uint32, uint32> modelNodeIdx;
-            for (uint32 i=0; i<mapSpawns.size(); ++i)
-                modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
+    bool TileAssembler::convertMap(uint32 mapId, MapSpawns& spawns)
+    {
+        bool success = true;
 
-            // write map tree file
-            std::stringstream mapfilename;
-            mapfilename << iDestDir << '/' << std::setfill('0') << std::setw(3) << map_iter->first << ".vmtree";
-            FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
-            if (!mapfile)
+        // build global map tree
+        std::vector<ModelSpawn*> mapSpawns;
+        std::set<std::string> modelFiles;
+        UniqueEntryMap::iterator entry;
+        printf("Calculating model bounds for map %u...\n", mapId);
+        for (entry = spawns.UniqueEntries.begin(); entry != spawns.UniqueEntries.end(); ++entry)
+        {
+            // M2 models don't have a bound set in WDT/ADT placement data, i still think they're not used for LoS at all on retail
+            if (entry->second.flags & MOD_M2)
             {
-                success = false;
-                printf("Cannot open %s\n", mapfilename.str().c_str());
-                break;
+                if (!calculateTransformedBound(entry->second))
+                    break;
             }
-
-            //general info
-            if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
-            uint32 globalTileID = StaticMapTree::packTileID(65, 65);
-            pair<TileMap::iterator, TileMap::iterator> globalRange = map_iter->second->TileEntries.equal_range(globalTileID);
-            char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
-            if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
-            // Nodes
-            if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
-            if (success) success = pTree.writeToFile(mapfile);
-            // global map spawns (WDT), if any (most instances)
-            if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
-
-            for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob)
-                success = ModelSpawn::writeToFile(mapfile, map_iter->second->UniqueEntries[glob->second]);
-
-            fclose(mapfile);
-
-            // <====
-
-            // write map tile files, similar to ADT files, only with extra BSP tree node info
-            TileMap &tileEntries = map_iter->second->TileEntries;
-            TileMap::iterator tile;
-            for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+            else if (entry->second.flags & MOD_WORLDSPAWN) // WMO maps and terrain maps use different origin, so we need to adapt :/
             {
-                ModelSpawn const& spawn = map_iter->second->UniqueEntries[tile->second];
-                if (spawn.flags & MOD_WORLDSPAWN) // WDT spawn, saved as tile 65/65 currently...
-                    continue;
-                uint32 nSpawns = tileEntries.count(tile->first);
-                std::stringstream tilefilename;
-                tilefilename.fill('0');
-                tilefilename << iDestDir << '/' << std::setw(3) << map_iter->first << '_';
-                uint32 x, y;
-                StaticMapTree::unpackTileID(tile->first, x, y);
-                tilefilename << std::setw(2) << x << '_' << std::setw(2) << y << ".vmtile";
-                if (FILE* tilefile = fopen(tilefilename.str().c_str(), "wb"))
-                {
-                    // file header
-                    if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
-                    // write number of tile spawns
-                    if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
-                    // write tile spawns
-                    for (uint32 s=0; s<nSpawns; ++s)
-                    {
-                        if (s)
-                            ++tile;
-                        ModelSpawn const& spawn2 = map_iter->second->UniqueEntries[tile->second];
-                        success = success && ModelSpawn::writeToFile(tilefile, spawn2);
-                        // MapTree nodes to update when loading tile:
-                        std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
-                        if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
-                    }
-                    fclose(tilefile);
-                }
+                /// @todo remove extractor hack and uncomment below line:
+                //entry->second.iPos += Vector3(533.33333f*32, 533.33333f*32, 0.f);
+                entry->second.iBound = entry->second.iBound + Vector3(533.33333f*32, 533.33333f*32, 0.f);
             }
-            // break; //test, extract only first map; TODO: remvoe this line
+            mapSpawns.push_back(&(entry->second));
+            modelFiles.insert(entry->second.name);
         }
 
-        // add an object models, listed in temp_gameobject_models file
-        exportGameobjectModels();
-        // export objects
-        std::cout << "\nConverting Model Files" << std::endl;
-        for (std::string const& spawnedModelFile : spawnedModelFiles)
         {
-            std::cout << "Converting " << spawnedModelFile << std::endl;
-            if (!convertRawFile(spawnedModelFile))
+            std::lock_guard<std::mutex> lock(spawnedModelFilesLock);
+            spawnedModelFiles.insert(modelFiles.begin(), modelFiles.end());
+        }
+
+        printf("Creating map tree for map %u...\n", mapId);
+        BIH pTree;
+
+        try
+        {
+            pTree.build(mapSpawns, BoundsTrait<ModelSpawn*>::getBounds);
+        }
+        catch (std::exception& e)
+        {
+            printf("Exception ""%s"" when calling pTree.build", e.what());
+            return false;
+        }
+
+        // ===> possibly move this code to StaticMapTree class
+        std::map<uint32, uint32> modelNodeIdx;
+        for (uint32 i=0; i<mapSpawns.size(); ++i)
+            modelNodeIdx.insert(pair<uint32, uint32>(mapSpawns[i]->ID, i));
+
+        // write map tree file
+        std::stringstream mapfilename;
+        mapfilename << iDestDir << '/' << std::setfill('0') << std::setw(3) << mapId << ".vmtree";
+        FILE* mapfile = fopen(mapfilename.str().c_str(), "wb");
+        if (!mapfile)
+        {
+            printf("Cannot open %s\n", mapfilename.str().c_str());
+            return false;
+        }
+
+        //general info
+        if (success && fwrite(VMAP_MAGIC, 1, 8, mapfile) != 8) success = false;
+        uint32 globalTileID = StaticMapTree::packTileID(65, 65);
+        pair<TileMap::iterator, TileMap::iterator> globalRange = spawns.TileEntries.equal_range(globalTileID);
+        char isTiled = globalRange.first == globalRange.second; // only maps without terrain (tiles) have global WMO
+        if (success && fwrite(&isTiled, sizeof(char), 1, mapfile) != 1) success = false;
+        // Nodes
+        if (success && fwrite("NODE", 4, 1, mapfile) != 1) success = false;
+        if (success) success = pTree.writeToFile(mapfile);
+        // global map spawns (WDT), if any (most instances)
+        if (success && fwrite("GOBJ", 4, 1, mapfile) != 1) success = false;
+
+        for (TileMap::iterator glob = globalRange.first; glob != globalRange.second && success; ++glob)
+            success = ModelSpawn::writeToFile(mapfile, spawns.UniqueEntries[glob->second]);
+
+        fclose(mapfile);
+
+        // <====
+
+        // write map tile files, similar to ADT files, only with extra BSP tree node info
+        TileMap &tileEntries = spawns.TileEntries;
+        TileMap::iterator tile;
+        for (tile = tileEntries.begin(); tile != tileEntries.end(); ++tile)
+        {
+            ModelSpawn const& spawn = spawns.UniqueEntries[tile->second];
+            if (spawn.flags & MOD_WORLDSPAWN) // WDT spawn, saved as tile 65/65 currently...
+                continue;
+            uint32 nSpawns = tileEntries.count(tile->first);
+            std::stringstream tilefilename;
+            tilefilename.fill('0');
+            tilefilename << iDestDir << '/' << std::setw(3) << mapId << '_';
+            uint32 x, y;
+            StaticMapTree::unpackTileID(tile->first, x, y);
+            tilefilename << std::setw(2) << x << '_' << std::setw(2) << y << ".vmtile";
+            if (FILE* tilefile = fopen(tilefilename.str().c_str(), "wb"))
             {
-                std::cout << "error converting " << spawnedModelFile << std::endl;
-                success = false;
-                break;
+                // file header
+                if (success && fwrite(VMAP_MAGIC, 1, 8, tilefile) != 8) success = false;
+                // write number of tile spawns
+                if (success && fwrite(&nSpawns, sizeof(uint32), 1, tilefile) != 1) success = false;
+                // write tile spawns
+                for (uint32 s=0; s<nSpawns; ++s)
+                {
+                    if (s)
+                        ++tile;
+                    ModelSpawn const& spawn2 = spawns.UniqueEntries[tile->second];
+                    success = success && ModelSpawn::writeToFile(tilefile, spawn2);
+                    // MapTree nodes to update when loading tile:
+                    std::map<uint32, uint32>::iterator nIdx = modelNodeIdx.find(spawn2.ID);
+                    if (success && fwrite(&nIdx->second, sizeof(uint32), 1, tilefile) != 1) success = false;
+                }
+                fclose(tilefile);
             }
         }
 
-        //cleanup:
-        for (std::pair<uint32 const, MapSpawns*>& map_iter : mapData)
-            delete map_iter.second;
-
         return success;
     }
 
@@ -431,15 +514,13 @@ namespace VMAP
         fclose(model_list_copy);
     }
 
-// temporary use defines to simplify read/check code (close file and return at fail)
-#define READ_OR_RETURN(V, S) if (fread((V), (S), 1, rf) != 1) { \
-                                fclose(rf); printf("readfail, op = %i\n", readOperation); return(false); }
-#define READ_OR_RETURN_WITH_DELETE(V, S) if (fread((V), (S), 1, rf) != 1) { \
-                                fclose(rf); printf("readfail, op = %i\n", readOperation); delete[] V; return(false); };
+// temporary use defines to simplify read/check code (return at fail)
+#define READ_OR_RETURN(V, S) if (!rf.Read((V), (S))) { \
+                                printf("readfail, op = %i\n", readOperation); return(false); }
 #define CMP_OR_RETURN(V, S)  if (strcmp((V), (S)) != 0)        { \
-                                fclose(rf); printf("cmpfail, %s!=%s\n", V, S);return(false); }
+                                printf("cmpfail, %s!=%s\n", V, S);return(false); }
 
-    bool GroupModel_Raw::Read(FILE* rf)
+    bool GroupModel_Raw::Read(MappedFileReader& rf)
     {
         char blockId[5];
         blockId[4] = 0;
@@ -478,13 +559,11 @@ namespace VMAP
         READ_OR_RETURN(&nindexes, sizeof(uint32));
         if (nindexes >0)
         {
-            uint16 *indexarray = new uint16[nindexes];
-            READ_OR_RETURN_WITH_DELETE(indexarray, nindexes*sizeof(uint16));
+            std::vector<uint16> indexarray(nindexes);
+            READ_OR_RETURN(indexarray.data(), nindexes*sizeof(uint16));
             triangles.reserve(nindexes / 3);
             for (uint32 i=0; i<nindexes; i+=3)
                 triangles.push_back(MeshTriangle(indexarray[i], indexarray[i+1], indexarray[i+2]));
-
-            delete[] indexarray;
         }
 
         // ---- vectors
@@ -496,12 +575,9 @@ namespace VMAP
 
         if (nvectors >0)
         {
-            float *vectorarray = new float[nvectors*3];
-            READ_OR_RETURN_WITH_DELETE(vectorarray, nvectors*sizeof(float)*3);
-            for (uint32 i=0; i<nvectors; ++i)
-                vertexArray.push_back( Vector3(vectorarray + 3*i) );
-
-            delete[] vectorarray;
+            // Vector3 is 3 packed floats, same as in the file
+            vertexArray.resize(nvectors);
+            READ_OR_RETURN(vertexArray.data(), nvectors*sizeof(float)*3);
         }
         // ----- liquid
         liquid = nullptr;
@@ -539,8 +615,8 @@ namespace VMAP
 
     bool WorldModel_Raw::Read(const char * path)
     {
-        FILE* rf = fopen(path, "rb");
-        if (!rf)
+        MappedFileReader rf;
+        if (!rf.Open(path))
         {
             printf("ERROR: Can't open raw model file: %s\n", path);
             return false;
@@ -566,8 +642,6 @@ namespace VMAP
         for (uint32 g = 0; g < groups && succeed; ++g)
             succeed = groupsArray[g].Read(rf);
 
-        if (succeed) /// rf will be freed inside Read if the function had any errors.
-            fclose(rf);
         return succeed;
     }
 
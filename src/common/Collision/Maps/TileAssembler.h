@@ -21,6 +21,7 @@
 #include <G3D/Vector3.h>
 #include <G3D/Matrix3.h>
 #include <map>
+#include <mutex>
 #include <set>
 
 #include "ModelInstance.h"
@@ -63,6 +64,8 @@ namespace VMAP
     typedef std::map<uint32, MapSpawns*> MapData;
     //===============================================
 
+    class MappedFileReader;
+
     struct TC_COMMON_API GroupModel_Raw
     {
         uint32 mogpflags;
@@ -78,7 +81,7 @@ namespace VMAP
             liquid(nullptr) { }
         ~GroupModel_Raw();
 
-        bool Read(FILE* f);
+        bool Read(MappedFileReader& rf);
     };
 
     struct TC_COMMON_API WorldModel_Raw
@@ -96,11 +99,17 @@ namespace VMAP
             std::string iSrcDir;
             MapData mapData;
             std::set<std::string> spawnedModelFiles;
+            std::mutex spawnedModelFilesLock;
+            uint32 iThreads;
+
+            // builds the model tree of a single map and writes its .vmtree and .vmtile files
+            bool convertMap(uint32 mapId, MapSpawns& spawns);
 
         public:
-            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName);
+            TileAssembler(const std::string& pSrcDirName, const std::string& pDestDirName, uint32 threads = 1);
             virtual ~TileAssembler();
 
+            // maps and model files are converted on iThreads threads, they do not depend on each other
             bool convertWorld2();
             bool readMapSpawns();
             bool calculateTransformedBound(ModelSpawn &spawn);
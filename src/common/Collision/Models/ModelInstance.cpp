@@ -18,6 +18,7 @@
 #include "ModelInstance.h"
 #include "WorldModel.h"
 #include "MapTree.h"
+#include "RayPacket.h"
 
 using G3D::Vector3;
 using G3D::Ray;
@@ -50,6 +51,25 @@ namespace VMAP
                   << " t/tmax:" << time << '/' << pMaxDist;
         std::cout << "\nBound lo:" << iBound.low().x << ", " << iBound.low().y << ", " << iBound.low().z << " hi: "
                   << iBound.high().x << ", " << iBound.high().y << ", " << iBound.high().z << std::endl; */
+        return intersectModel(pRay, pMaxDist, pStopAtFirstHit, ignoreFlags);
+    }
+
+    uint32 ModelInstance::intersectRayPacket(RayPacket const& packet, float* pMaxDist, uint32 laneMask, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const
+    {
+        if (!iModel)
+            return 0;
+
+        uint32 hits = 0;
+        RayPacket::ForEachLane(packet.IntersectBounds(iBound, pMaxDist, laneMask), [&](uint32 lane)
+        {
+            if (intersectModel(packet.Rays[lane], pMaxDist[lane], pStopAtFirstHit, ignoreFlags))
+                hits |= 1 << lane;
+        });
+        return hits;
+    }
+
+    bool ModelInstance::intersectModel(G3D::Ray const& pRay, float& pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const
+    {
         // child bounds are defined in object space:
         Vector3 p = iInvRot * (pRay.origin() - iPos) * iInvScale;
         Ray modRay(p, iInvRot * pRay.direction());
@@ -25,6 +25,8 @@
 
 #include "Define.h"
 
+struct RayPacket;
+
 namespace VMAP
 {
     class WorldModel;
@@ -67,11 +69,15 @@ namespace VMAP
             ModelInstance(ModelSpawn const& spawn, WorldModel* model);
             void setUnloaded() { iModel = nullptr; }
             bool intersectRay(G3D::Ray const& pRay, float& pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+            // intersectRay for the lanes of laneMask, bounds are tested for all lanes at once, returns the lanes that hit
+            uint32 intersectRayPacket(RayPacket const& packet, float* pMaxDist, uint32 laneMask, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
             void intersectPoint(G3D::Vector3 const& p, AreaInfo &info) const;
             bool GetLocationInfo(G3D::Vector3 const& p, LocationInfo &info) const;
             bool GetLiquidLevel(G3D::Vector3 const& p, LocationInfo &info, float &liqHeight) const;
             WorldModel* getWorldModel() { return iModel; }
         protected:
+            bool intersectModel(G3D::Ray const& pRay, float& pMaxDist, bool pStopAtFirstHit, ModelIgnoreFlags ignoreFlags) const;
+
             G3D::Matrix3 iInvRot;
             float iInvScale;
             WorldModel* iModel;
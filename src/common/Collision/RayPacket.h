@@ -0,0 +1,243 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _RAYPACKET_H
+#define _RAYPACKET_H
+
+#include "Define.h"
+#include <G3D/AABox.h>
+#include <G3D/Ray.h>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RAY_PACKET_SSE
+#include <emmintrin.h>
+#endif
+
+/** Lane mask of a 4 wide packet compare, SSE register when available with a scalar fallback.
+    Comparisons follow scalar float rules: any compare involving NaN is false.
+*/
+struct PacketBool
+{
+#ifdef RAY_PACKET_SSE
+    __m128 v;
+
+    uint32 Bits() const { return uint32(_mm_movemask_ps(v)); }
+
+    static PacketBool FromBits(uint32 bits)
+    {
+        __m128i const lanes = _mm_setr_epi32(1, 2, 4, 8);
+        return { _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(int32(bits)), lanes), lanes)) };
+    }
+
+    friend PacketBool operator&(PacketBool left, PacketBool right) { return { _mm_and_ps(left.v, right.v) }; }
+    friend PacketBool operator|(PacketBool left, PacketBool right) { return { _mm_or_ps(left.v, right.v) }; }
+    PacketBool operator!() const { return { _mm_xor_ps(v, _mm_castsi128_ps(_mm_set1_epi32(-1))) }; }
+#else
+    uint32 v;
+
+    uint32 Bits() const { return v; }
+
+    static PacketBool FromBits(uint32 bits) { return { bits & 0xF }; }
+
+    friend PacketBool operator&(PacketBool left, PacketBool right) { return { left.v & right.v }; }
+    friend PacketBool operator|(PacketBool left, PacketBool right) { return { left.v | right.v }; }
+    PacketBool operator!() const { return { ~v & 0xF }; }
+#endif
+};
+
+struct PacketFloat
+{
+#ifdef RAY_PACKET_SSE
+    __m128 v;
+
+    static PacketFloat Load(float const* values) { return { _mm_loadu_ps(values) }; }
+    static PacketFloat Broadcast(float value) { return { _mm_set1_ps(value) }; }
+    void Store(float* values) const { _mm_storeu_ps(values, v); }
+
+    friend PacketFloat operator+(PacketFloat left, PacketFloat right) { return { _mm_add_ps(left.v, right.v) }; }
+    friend PacketFloat operator-(PacketFloat left, PacketFloat right) { return { _mm_sub_ps(left.v, right.v) }; }
+    friend PacketFloat operator*(PacketFloat left, PacketFloat right) { return { _mm_mul_ps(left.v, right.v) }; }
+    friend PacketBool operator<(PacketFloat left, PacketFloat right) { return { _mm_cmplt_ps(left.v, right.v) }; }
+    friend PacketBool operator<=(PacketFloat left, PacketFloat right) { return { _mm_cmple_ps(left.v, right.v) }; }
+    friend PacketBool operator>(PacketFloat left, PacketFloat right) { return { _mm_cmpgt_ps(left.v, right.v) }; }
+    friend PacketBool operator>=(PacketFloat left, PacketFloat right) { return { _mm_cmpge_ps(left.v, right.v) }; }
+
+    // returns right for lanes where either side is NaN, same as (left < right) ? left : right
+    static PacketFloat Min(PacketFloat left, PacketFloat right) { return { _mm_min_ps(left.v, right.v) }; }
+    static PacketFloat Max(PacketFloat left, PacketFloat right) { return { _mm_max_ps(left.v, right.v) }; }
+    static PacketFloat Select(PacketBool mask, PacketFloat ifTrue, PacketFloat ifFalse) { return { _mm_or_ps(_mm_and_ps(mask.v, ifTrue.v), _mm_andnot_ps(mask.v, ifFalse.v)) }; }
+    static PacketBool Unordered(PacketFloat left, PacketFloat right) { return { _mm_cmpunord_ps(left.v, right.v) }; }
+#else
+    float v[4];
+
+    static PacketFloat Load(float const* values) { PacketFloat result; std::memcpy(result.v, values, sizeof(result.v)); return result; }
+    static PacketFloat Broadcast(float value) { return { { value, value, value, value } }; }
+    void Store(float* values) const { std::memcpy(values, v, sizeof(v)); }
+
+    template<class Op>
+    static PacketFloat Apply(PacketFloat left, PacketFloat right, Op op) { return { { op(left.v[0], right.v[0]), op(left.v[1], right.v[1]), op(left.v[2], right.v[2]), op(left.v[3], right.v[3]) } }; }
+
+    template<class Op>
+    static PacketBool Compare(PacketFloat left, PacketFloat right, Op op)
+    {
+        uint32 bits = 0;
+        for (uint32 lane = 0; lane < 4; ++lane)
+            if (op(left.v[lane], right.v[lane]))
+                bits |= 1 << lane;
+        return { bits };
+    }
+
+    friend PacketFloat operator+(PacketFloat left, PacketFloat right) { return Apply(left, right, [](float l, float r) { return l + r; }); }
+    friend PacketFloat operator-(PacketFloat left, PacketFloat right) { return Apply(left, right, [](float l, float r) { return l - r; }); }
+    friend PacketFloat operator*(PacketFloat left, PacketFloat right) { return Apply(left, right, [](float l, float r) { return l * r; }); }
+    friend PacketBool operator<(PacketFloat left, PacketFloat right) { return Compare(left, right, [](float l, float r) { return l < r; }); }
+    friend PacketBool operator<=(PacketFloat left, PacketFloat right) { return Compare(left, right, [](float l, float r) { return l <= r; }); }
+    friend PacketBool operator>(PacketFloat left, PacketFloat right) { return Compare(left, right, [](float l, float r) { return l > r; }); }
+    friend PacketBool operator>=(PacketFloat left, PacketFloat right) { return Compare(left, right, [](float l, float r) { return l >= r; }); }
+
+    static PacketFloat Min(PacketFloat left, PacketFloat right) { return Apply(left, right, [](float l, float r) { return l < r ? l : r; }); }
+    static PacketFloat Max(PacketFloat left, PacketFloat right) { return Apply(left, right, [](float l, float r) { return l > r ? l : r; }); }
+    static PacketFloat Select(PacketBool mask, PacketFloat ifTrue, PacketFloat ifFalse)
+    {
+        PacketFloat result;
+        for (uint32 lane = 0; lane < 4; ++lane)
+            result.v[lane] = (mask.v & (1 << lane)) ? ifTrue.v[lane] : ifFalse.v[lane];
+        return result;
+    }
+    static PacketBool Unordered(PacketFloat left, PacketFloat right) { return Compare(left, right, [](float l, float r) { return l != l || r != r; }); }
+#endif
+};
+
+/** Up to four rays traced together through a BIH.
+    All rays of a packet must point into the same octant (see GetOctant) so they agree on
+    the near and far child of every node, lanes are independent otherwise.
+*/
+struct RayPacket
+{
+    static constexpr uint32 WIDTH = 4;
+
+    G3D::Ray Rays[WIDTH];
+    float Origin[3][WIDTH];
+    float InvDirection[3][WIDTH];
+    uint32 Count = 0;
+
+    // sign bits of the direction, matches the child ordering used by BIH traversal
+    static uint32 GetOctant(G3D::Vector3 const& direction)
+    {
+        uint32 octant = 0;
+        for (uint32 axis = 0; axis < 3; ++axis)
+        {
+            uint32 bits;
+            std::memcpy(&bits, &direction[axis], sizeof(bits));
+            octant |= (bits >> 31) << axis;
+        }
+        return octant;
+    }
+
+    void Set(G3D::Ray const* rays, uint32 count)
+    {
+        Count = count;
+        for (uint32 lane = 0; lane < WIDTH; ++lane)
+        {
+            // unused lanes repeat the first ray and stay masked out
+            G3D::Ray const& ray = rays[lane < count ? lane : 0];
+            Rays[lane] = ray;
+            for (uint32 axis = 0; axis < 3; ++axis)
+            {
+                Origin[axis][lane] = ray.origin()[axis];
+                InvDirection[axis][lane] = 1.f / ray.direction()[axis];
+            }
+        }
+    }
+
+    uint32 GetLaneMask() const { return (1u << Count) - 1; }
+    uint32 GetOctant() const { return GetOctant(Rays[0].direction()); }
+
+    PacketFloat GetOrigin(uint32 axis) const { return PacketFloat::Load(Origin[axis]); }
+    PacketFloat GetInvDirection(uint32 axis) const { return PacketFloat::Load(InvDirection[axis]); }
+
+    // lanes of laneMask whose ray enters the box before their maxDist, NaN slabs (ray parallel to and on a box face) count as hit
+    uint32 IntersectBounds(G3D::AABox const& box, float const* maxDist, uint32 laneMask) const
+    {
+        PacketFloat tNear = PacketFloat::Broadcast(0.f);
+        PacketFloat tFar = PacketFloat::Load(maxDist);
+        PacketBool unordered = PacketBool::FromBits(0);
+        for (uint32 axis = 0; axis < 3; ++axis)
+        {
+            PacketFloat t1 = (PacketFloat::Broadcast(box.low()[axis]) - GetOrigin(axis)) * GetInvDirection(axis);
+            PacketFloat t2 = (PacketFloat::Broadcast(box.high()[axis]) - GetOrigin(axis)) * GetInvDirection(axis);
+            unordered = unordered | PacketFloat::Unordered(t1, t2);
+            tNear = PacketFloat::Max(tNear, PacketFloat::Min(t1, t2));
+            tFar = PacketFloat::Min(tFar, PacketFloat::Max(t1, t2));
+        }
+        return laneMask & ((tNear <= tFar) | unordered).Bits();
+    }
+
+    template<class Worker>
+    static void ForEachLane(uint32 laneMask, Worker&& worker)
+    {
+        for (; laneMask; laneMask &= laneMask - 1)
+            worker(uint32(std::countr_zero(laneMask)));
+    }
+};
+
+/** Collects rays of a batch query and hands them to trace(RayPacket const&, uint32 const* indices)
+    in packets of rays sharing an octant. Flush() must be called after the last ray was added.
+*/
+template<class Trace>
+class RayPacketQueue
+{
+    public:
+        explicit RayPacketQueue(Trace trace) : _trace(std::move(trace)), _counts() { }
+
+        void Add(G3D::Ray const& ray, uint32 index)
+        {
+            uint32 octant = RayPacket::GetOctant(ray.direction());
+            uint32& count = _counts[octant];
+            _rays[octant][count] = ray;
+            _indices[octant][count] = index;
+            if (++count == RayPacket::WIDTH)
+                TraceOctant(octant);
+        }
+
+        void Flush()
+        {
+            for (uint32 octant = 0; octant < 8; ++octant)
+                if (_counts[octant])
+                    TraceOctant(octant);
+        }
+
+    private:
+        void TraceOctant(uint32 octant)
+        {
+            RayPacket packet;
+            packet.Set(_rays[octant].data(), _counts[octant]);
+            _trace(packet, _indices[octant].data());
+            _counts[octant] = 0;
+        }
+
+        Trace _trace;
+        std::array<std::array<G3D::Ray, RayPacket::WIDTH>, 8> _rays;
+        std::array<std::array<uint32, RayPacket::WIDTH>, 8> _indices;
+        std::array<uint32, 8> _counts;
+};
+
+#endif // _RAYPACKET_H
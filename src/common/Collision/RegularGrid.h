@@ -47,7 +47,24 @@ public:
     #define HGRID_MAP_SIZE  (533.33333f * 64.f)     // shouldn't be changed
     #define CELL_SIZE       float(HGRID_MAP_SIZE/(float)CELL_NUMBER)
 
-    typedef std::unordered_multimap<const T*, Node*> MemberTable;
+    struct Cell
+    {
+        int x, y;
+        bool operator==(Cell const& c2) const
+        {
+            return x == c2.x && y == c2.y;
+        }
+
+        static Cell ComputeCell(float fx, float fy)
+        {
+            Cell c = { int(fx * (1.f / CELL_SIZE) + (CELL_NUMBER / 2)), int(fy * (1.f / CELL_SIZE) + (CELL_NUMBER / 2)) };
+            return c;
+        }
+
+        bool isValid() const { return x >= 0 && x < CELL_NUMBER && y >= 0 && y < CELL_NUMBER; }
+    };
+
+    typedef std::unordered_multimap<const T*, Cell> MemberTable;
 
     MemberTable memberTable;
     Node* nodes[CELL_NUMBER][CELL_NUMBER];
@@ -74,9 +91,8 @@ public:
         {
             for (int y = low.y; y <= high.y; ++y)
             {
-                Node& node = getGrid(x, y);
-                node.insert(value);
-                memberTable.emplace(&value, &node);
+                getGrid(x, y).insert(value);
+                memberTable.emplace(&value, Cell{ x, y });
             }
         }
     }
@@ -84,38 +100,55 @@ public:
     void remove(const T& value)
     {
         for (auto& p : Trinity::Containers::MapEqualRange(memberTable, &value))
-            p.second->remove(value);
+            nodes[p.second.x][p.second.y]->remove(value);
         // Remove the member
         memberTable.erase(&value);
     }
 
-    void balance()
+    // bounds of value changed, nodes of cells it stays in are refit, only cells it enters or leaves change membership
+    void move(const T& value)
     {
-        for (int x = 0; x < CELL_NUMBER; ++x)
-            for (int y = 0; y < CELL_NUMBER; ++y)
-                if (Node* n = nodes[x][y])
-                    n->balance();
-    }
-
-    bool contains(const T& value) const { return memberTable.count(&value) > 0; }
-    bool empty() const { return memberTable.empty(); }
+        G3D::AABox bounds;
+        BoundsFunc::getBounds(value, bounds);
+        Cell low = Cell::ComputeCell(bounds.low().x, bounds.low().y);
+        Cell high = Cell::ComputeCell(bounds.high().x, bounds.high().y);
 
-    struct Cell
-    {
-        int x, y;
-        bool operator==(Cell const& c2) const
+        auto [begin, end] = memberTable.equal_range(&value);
+        for (auto itr = begin; itr != end;)
         {
-            return x == c2.x && y == c2.y;
+            Cell cell = itr->second;
+            if (cell.x >= low.x && cell.x <= high.x && cell.y >= low.y && cell.y <= high.y)
+            {
+                nodes[cell.x][cell.y]->move(value);
+                ++itr;
+            }
+            else
+            {
+                nodes[cell.x][cell.y]->remove(value);
+                itr = memberTable.erase(itr);
+            }
         }
 
-        static Cell ComputeCell(float fx, float fy)
+        for (int x = low.x; x <= high.x; ++x)
         {
-            Cell c = { int(fx * (1.f / CELL_SIZE) + (CELL_NUMBER / 2)), int(fy * (1.f / CELL_SIZE) + (CELL_NUMBER / 2)) };
-            return c;
+            for (int y = low.y; y <= high.y; ++y)
+            {
+                Cell cell = { x, y };
+                bool member = false;
+                for (auto& p : Trinity::Containers::MapEqualRange(memberTable, &value))
+                    member = member || p.second == cell;
+
+                if (member)
+                    continue;
+
+                getGrid(x, y).insert(value);
+                memberTable.emplace(&value, cell);
+            }
         }
+    }
 
-        bool isValid() const { return x >= 0 && x < CELL_NUMBER && y >= 0 && y < CELL_NUMBER; }
-    };
+    bool contains(const T& value) const { return memberTable.count(&value) > 0; }
+    bool empty() const { return memberTable.empty(); }
 
     Node& getGrid(int x, int y)
     {
@@ -24,9 +24,11 @@
 */
 
 #include "AppenderDB.h"
+#include "AuthCryptoPool.h"
 #include "AuthSocketMgr.h"
 #include "Banner.h"
 #include "Config.h"
+#include "CryptoRandom.h"
 #include "DatabaseEnv.h"
 #include "DatabaseLoader.h"
 #include "DeadlineTimer.h"
@@ -34,12 +36,14 @@
 #include "IPLocation.h"
 #include "GitRevision.h"
 #include "Locales.h"
+#include "Metric.h"
 #include "MySQLThreading.h"
 #include "OpenSSLCrypto.h"
 #include "ProcessPriority.h"
 #include "RealmList.h"
 #include "SecretMgr.h"
 #include "SharedDefines.h"
+#include "SRP6.h"
 #include "Util.h"
 #include <boost/asio/signal_set.hpp>
 #include <boost/dll/runtime_symbol_info.hpp>
@@ -49,6 +53,7 @@
 #include <openssl/opensslv.h>
 #include <iostream>
 #include <csignal>
+#include <thread>
 
 using boost::asio::ip::tcp;
 using namespace boost::program_options;
@@ -79,6 +84,8 @@ void StopDB();
 void SignalHandler(std::weak_ptr<Trinity::Asio::IoContext> ioContextRef, boost::system::error_code const& error, int signalNumber);
 void KeepDatabaseAliveHandler(std::weak_ptr<Trinity::Asio::DeadlineTimer> dbPingTimerRef, int32 dbPingInterval, boost::system::error_code const& error);
 void BanExpiryHandler(std::weak_ptr<Trinity::Asio::DeadlineTimer> banExpiryCheckTimerRef, int32 banExpiryCheckInterval, boost::system::error_code const& error);
+void MetricUpdateHandler(std::weak_ptr<Trinity::Asio::DeadlineTimer> metricUpdateTimerRef, boost::system::error_code const& error);
+int RunLoginStress(uint32 logins, uint32 addressCount);
 variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, std::string& configService);
 
 int main(int argc, char** argv)
@@ -142,6 +149,10 @@ int main(int argc, char** argv)
 
     std::shared_ptr<void> opensslHandle(nullptr, [](void*) { OpenSSLCrypto::threadsCleanup(); });
 
+    // Measure the logon crypto throughput without database and network, then exit
+    if (vm.count("stress"))
+        return RunLoginStress(vm["stress"].as<uint32>(), vm["stress-addresses"].as<uint32>());
+
     // authserver PID file creation
     std::string pidFile = sConfigMgr->GetStringDefault("PidFile", "");
     if (!pidFile.empty())
@@ -173,6 +184,20 @@ int main(int argc, char** argv)
 
     std::shared_ptr<void> sRealmListHandle(nullptr, [](void*) { sRealmList->Close(); });
 
+    sMetric->Initialize("authserver", *ioContext, []()
+    {
+        TC_METRIC_VALUE("db_queue_login", uint64(LoginDatabase.QueueSize()));
+        sAuthCryptoPool->LogStats();
+    });
+
+    TC_METRIC_EVENT("events", "Authserver started", "");
+
+    std::shared_ptr<void> sMetricHandle(nullptr, [](void*)
+    {
+        TC_METRIC_EVENT("events", "Authserver shutdown", "");
+        sMetric->Unload();
+    });
+
     if (sRealmList->GetRealms().empty())
     {
         TC_LOG_ERROR("server.authserver", "No valid realms specified.");
@@ -189,6 +214,12 @@ int main(int argc, char** argv)
 
     std::string bindIp = sConfigMgr->GetStringDefault("BindIP", "0.0.0.0");
 
+    // Stopped after the network, sessions still waiting for a crypto thread are closed by then
+    sAuthCryptoPool->Start(sConfigMgr->GetIntDefault("LoginCrypto.Threads", 2), sConfigMgr->GetIntDefault("LoginCrypto.MaxQueued", 2000),
+        sConfigMgr->GetIntDefault("LoginCrypto.MaxQueuedPerIP", 100));
+
+    std::shared_ptr<void> sAuthCryptoPoolHandle(nullptr, [](void*) { sAuthCryptoPool->Stop(); });
+
     if (!sAuthSocketMgr.StartNetwork(*ioContext, bindIp, port))
     {
         TC_LOG_ERROR("server.authserver", "Failed to initialize network");
@@ -218,6 +249,11 @@ int main(int argc, char** argv)
     banExpiryCheckTimer->expires_from_now(boost::posix_time::seconds(banExpiryCheckInterval));
     banExpiryCheckTimer->async_wait(std::bind(&BanExpiryHandler, std::weak_ptr<Trinity::Asio::DeadlineTimer>(banExpiryCheckTimer), banExpiryCheckInterval, std::placeholders::_1));
 
+    // Metric only flags the overall status interval, the status logger runs from Metric::Update
+    std::shared_ptr<Trinity::Asio::DeadlineTimer> metricUpdateTimer = std::make_shared<Trinity::Asio::DeadlineTimer>(*ioContext);
+    metricUpdateTimer->expires_from_now(boost::posix_time::seconds(1));
+    metricUpdateTimer->async_wait(std::bind(&MetricUpdateHandler, std::weak_ptr<Trinity::Asio::DeadlineTimer>(metricUpdateTimer), std::placeholders::_1));
+
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
     std::shared_ptr<Trinity::Asio::DeadlineTimer> serviceStatusWatchTimer;
     if (m_ServiceStatus != -1)
@@ -234,6 +270,7 @@ int main(int argc, char** argv)
     // Start the io service worker loop
     ioContext->run();
 
+    metricUpdateTimer->cancel();
     banExpiryCheckTimer->cancel();
     dbPingTimer->cancel();
 
@@ -308,6 +345,94 @@ void BanExpiryHandler(std::weak_ptr<Trinity::Asio::DeadlineTimer> banExpiryCheck
     }
 }
 
+void MetricUpdateHandler(std::weak_ptr<Trinity::Asio::DeadlineTimer> metricUpdateTimerRef, boost::system::error_code const& error)
+{
+    if (!error)
+    {
+        if (std::shared_ptr<Trinity::Asio::DeadlineTimer> metricUpdateTimer = metricUpdateTimerRef.lock())
+        {
+            sMetric->Update();
+
+            metricUpdateTimer->expires_from_now(boost::posix_time::seconds(1));
+            metricUpdateTimer->async_wait(std::bind(&MetricUpdateHandler, metricUpdateTimerRef, std::placeholders::_1));
+        }
+    }
+}
+
+/// Simulates a login storm on the crypto threads: every login computes a logon challenge and verifies a proof.
+/// Half of the logins come from a single address to show that the others are not delayed by it.
+int RunLoginStress(uint32 logins, uint32 addressCount)
+{
+    uint32 threads = sConfigMgr->GetIntDefault("LoginCrypto.Threads", 2);
+    addressCount = std::max(addressCount, 2u);
+    TC_LOG_INFO("server.authserver", "Stress test: {} logins from {} addresses on {} crypto threads, queue limits disabled", logins, addressCount, threads);
+
+    // every login is queued at once, like clients reconnecting after a restart
+    sAuthCryptoPool->Start(threads, 0, 0);
+
+    std::pair<Trinity::Crypto::SRP6::Salt, Trinity::Crypto::SRP6::Verifier> registration = Trinity::Crypto::SRP6::MakeRegistrationData("STRESS", "STRESS");
+    TimePoint start = std::chrono::steady_clock::now();
+    std::atomic<uint32> remaining(logins);
+    std::mutex resultLock;
+    std::vector<uint32> floodTimes;
+    std::vector<uint32> otherTimes;
+
+    for (uint32 i = 0; i < logins; ++i)
+    {
+        bool flood = (i % 2) == 0;
+        boost::asio::ip::address address = boost::asio::ip::address_v4(flood ? 0x0A000001 : 0x0A000002 + (i / 2) % (addressCount - 1));
+
+        // handshake time of a login counts from its own enqueue, like AuthSession does from the logon challenge
+        TimePoint enqueued = std::chrono::steady_clock::now();
+        sAuthCryptoPool->Enqueue(address, [&, address, flood, enqueued]()
+        {
+            std::shared_ptr<Trinity::Crypto::SRP6> srp6 = std::make_shared<Trinity::Crypto::SRP6>("STRESS", registration.first, registration.second);
+
+            // a random client key fails the proof but costs the same as a correct one
+            sAuthCryptoPool->Enqueue(address, [&, srp6, flood, enqueued]()
+            {
+                srp6->VerifyChallengeResponse(Trinity::Crypto::GetRandomBytes<Trinity::Crypto::SRP6::EPHEMERAL_KEY_LENGTH>(), Trinity::Crypto::SHA1::Digest{});
+
+                Milliseconds handshakeTime = std::chrono::duration_cast<Milliseconds>(std::chrono::steady_clock::now() - enqueued);
+                sAuthCryptoPool->RecordLogin(true, handshakeTime);
+                {
+                    std::lock_guard<std::mutex> lock(resultLock);
+                    (flood ? floodTimes : otherTimes).push_back(uint32(handshakeTime.count()));
+                }
+
+                --remaining;
+            });
+        });
+    }
+
+    while (remaining > 0)
+    {
+        std::this_thread::sleep_for(1s);
+
+        AuthCryptoStats stats = sAuthCryptoPool->ConsumeStats();
+        TC_LOG_INFO("server.authserver", "Stress test: {:.0f} logins/s, handshake p50 {} ms p99 {} ms, {} queued crypto tasks",
+            stats.LoginsPerSecond, stats.HandshakeP50, stats.HandshakeP99, stats.Queued);
+    }
+
+    float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    sAuthCryptoPool->Stop();
+
+    auto percentile = [](std::vector<uint32>& samples, uint32 pct) -> uint32
+    {
+        if (samples.empty())
+            return 0;
+
+        std::size_t index = std::min(samples.size() - 1, samples.size() * pct / 100);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    };
+
+    TC_LOG_INFO("server.authserver", "Stress test: {} logins in {:.1f} s, {:.0f} logins/s", logins, seconds, seconds > 0.0f ? logins / seconds : 0.0f);
+    TC_LOG_INFO("server.authserver", "Stress test: flooding address handshake p50 {} ms p99 {} ms, other addresses p50 {} ms p99 {} ms",
+        percentile(floodTimes, 50), percentile(floodTimes, 99), percentile(otherTimes, 50), percentile(otherTimes, 99));
+    return 0;
+}
+
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
 void ServiceStatusWatcher(std::weak_ptr<Trinity::Asio::DeadlineTimer> serviceStatusWatchTimerRef, std::weak_ptr<Trinity::Asio::IoContext> ioContextRef, boost::system::error_code const& error)
 {
@@ -335,6 +460,8 @@ variables_map GetConsoleArguments(int argc, char** argv, fs::path& configFile, s
         ("version,v", "print version build info")
         ("config,c", value<fs::path>(&configFile)->default_value(fs::absolute(_TRINITY_REALM_CONFIG)),
                      "use <arg> as configuration file")
+        ("stress", value<uint32>(), "simulate <arg> logins on the crypto threads and exit")
+        ("stress-addresses", value<uint32>()->default_value(100), "number of client addresses used by --stress")
         ;
 #if TRINITY_PLATFORM == TRINITY_PLATFORM_WINDOWS
     options_description win("Windows platform specific options");
@@ -0,0 +1,209 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuthCryptoPool.h"
+#include "Log.h"
+#include "Metric.h"
+#include <algorithm>
+
+namespace
+{
+    // samples kept between two ConsumeStats calls, bounds memory when no metrics are sent
+    constexpr std::size_t MaxSamples = 100000;
+
+    // value below which pct percent of sorted samples fall
+    uint32 GetPercentile(std::vector<uint32>& samples, uint32 pct)
+    {
+        if (samples.empty())
+            return 0;
+
+        std::size_t index = std::min(samples.size() - 1, samples.size() * pct / 100);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+AuthCryptoPool::AuthCryptoPool() : _queued(0), _maxQueued(0), _maxQueuedPerAddress(0), _stopping(false),
+    _statsStart(std::chrono::steady_clock::now()), _rejected(0), _logins(0), _failedLogins(0)
+{
+}
+
+AuthCryptoPool::~AuthCryptoPool()
+{
+    Stop();
+}
+
+AuthCryptoPool* AuthCryptoPool::Instance()
+{
+    static AuthCryptoPool instance;
+    return &instance;
+}
+
+void AuthCryptoPool::Start(uint32 threadCount, uint32 maxQueued, uint32 maxQueuedPerAddress)
+{
+    _maxQueued = maxQueued;
+    _maxQueuedPerAddress = maxQueuedPerAddress;
+    _stopping = false;
+
+    for (uint32 i = 0; i < threadCount; ++i)
+        _threads.emplace_back(&AuthCryptoPool::WorkerThread, this);
+
+    TC_LOG_INFO("server.authserver", "Started {} crypto threads (queue limit {}, per address {})", threadCount, maxQueued, maxQueuedPerAddress);
+}
+
+void AuthCryptoPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        _stopping = true;
+    }
+
+    _queueCondition.notify_all();
+
+    // queued tasks are still executed, sessions of closed sockets skip their work
+    for (std::thread& thread : _threads)
+        thread.join();
+
+    _threads.clear();
+}
+
+bool AuthCryptoPool::EnqueueWork(boost::asio::ip::address const& address, std::function<void()>&& work)
+{
+    if (_threads.empty())
+    {
+        work();
+        return true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        std::deque<QueuedTask>& queue = _queues[address];
+        if (_stopping || (_maxQueued && _queued >= _maxQueued) || (_maxQueuedPerAddress && queue.size() >= _maxQueuedPerAddress))
+        {
+            if (queue.empty())
+                _queues.erase(address);
+
+            std::lock_guard<std::mutex> statsLock(_statsLock);
+            ++_rejected;
+            return false;
+        }
+
+        if (queue.empty())
+            _readyAddresses.push_back(address);
+
+        queue.push_back({ std::move(work), std::chrono::steady_clock::now() });
+        ++_queued;
+    }
+
+    _queueCondition.notify_one();
+    return true;
+}
+
+void AuthCryptoPool::WorkerThread()
+{
+    while (true)
+    {
+        QueuedTask task;
+        {
+            std::unique_lock<std::mutex> lock(_queueLock);
+            _queueCondition.wait(lock, [this]() { return _stopping || !_readyAddresses.empty(); });
+            if (_readyAddresses.empty())
+                return;
+
+            // take the oldest task of the next address, the address goes to the back of the line
+            boost::asio::ip::address address = _readyAddresses.front();
+            _readyAddresses.pop_front();
+
+            auto itr = _queues.find(address);
+            task = std::move(itr->second.front());
+            itr->second.pop_front();
+            if (itr->second.empty())
+                _queues.erase(itr);
+            else
+                _readyAddresses.push_back(address);
+
+            --_queued;
+        }
+
+        Milliseconds waitTime = std::chrono::duration_cast<Milliseconds>(std::chrono::steady_clock::now() - task.QueueTime);
+        {
+            std::lock_guard<std::mutex> statsLock(_statsLock);
+            if (_queueWaitTimes.size() < MaxSamples)
+                _queueWaitTimes.push_back(uint32(waitTime.count()));
+        }
+
+        task.Work();
+    }
+}
+
+void AuthCryptoPool::RecordLogin(bool success, Milliseconds handshakeTime)
+{
+    std::lock_guard<std::mutex> lock(_statsLock);
+    if (success)
+        ++_logins;
+    else
+        ++_failedLogins;
+
+    if (_handshakeTimes.size() < MaxSamples)
+        _handshakeTimes.push_back(uint32(handshakeTime.count()));
+}
+
+AuthCryptoStats AuthCryptoPool::ConsumeStats()
+{
+    AuthCryptoStats stats;
+    {
+        std::lock_guard<std::mutex> lock(_queueLock);
+        stats.Queued = _queued;
+    }
+
+    std::lock_guard<std::mutex> lock(_statsLock);
+    TimePoint now = std::chrono::steady_clock::now();
+    float seconds = std::chrono::duration<float>(now - _statsStart).count();
+    _statsStart = now;
+
+    stats.Rejected = _rejected;
+    stats.Logins = _logins;
+    stats.FailedLogins = _failedLogins;
+    stats.LoginsPerSecond = seconds > 0.0f ? float(_logins) / seconds : 0.0f;
+    if (!_handshakeTimes.empty())
+        stats.HandshakeMax = *std::max_element(_handshakeTimes.begin(), _handshakeTimes.end());
+    stats.HandshakeP99 = GetPercentile(_handshakeTimes, 99);
+    stats.HandshakeP50 = GetPercentile(_handshakeTimes, 50);
+    stats.QueueWaitP99 = GetPercentile(_queueWaitTimes, 99);
+
+    _rejected = 0;
+    _logins = 0;
+    _failedLogins = 0;
+    _handshakeTimes.clear();
+    _queueWaitTimes.clear();
+    return stats;
+}
+
+void AuthCryptoPool::LogStats()
+{
+    [[maybe_unused]] AuthCryptoStats stats = ConsumeStats();
+
+    TC_METRIC_VALUE("auth_logins", stats.Logins);
+    TC_METRIC_VALUE("auth_failed_logins", stats.FailedLogins);
+    TC_METRIC_VALUE("auth_logins_per_second", stats.LoginsPerSecond);
+    TC_METRIC_VALUE("auth_handshake_p50", uint64(stats.HandshakeP50));
+    TC_METRIC_VALUE("auth_handshake_p99", uint64(stats.HandshakeP99));
+    TC_METRIC_VALUE("auth_handshake_max", uint64(stats.HandshakeMax));
+    TC_METRIC_VALUE("auth_crypto_queue", stats.Queued);
+    TC_METRIC_VALUE("auth_crypto_queue_wait_p99", uint64(stats.QueueWaitP99));
+    TC_METRIC_VALUE("auth_crypto_rejected", stats.Rejected);
+}
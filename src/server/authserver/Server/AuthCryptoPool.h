@@ -0,0 +1,116 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef AuthCryptoPool_h__
+#define AuthCryptoPool_h__
+
+#include "Define.h"
+#include "Duration.h"
+#include <boost/asio/ip/address.hpp>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct AuthCryptoStats
+{
+    uint64 Queued = 0;                      // tasks waiting for a crypto thread right now
+    uint64 Rejected = 0;                    // tasks refused because a queue limit was reached
+    uint64 Logins = 0;
+    uint64 FailedLogins = 0;
+    float LoginsPerSecond = 0.0f;
+    uint32 HandshakeP50 = 0;                // ms from logon challenge to logon proof result
+    uint32 HandshakeP99 = 0;
+    uint32 HandshakeMax = 0;
+    uint32 QueueWaitP99 = 0;                // ms a task waited for a crypto thread
+};
+
+/*
+ * Runs the SRP6 math of logon challenges and proofs outside of the network thread.
+ * Every remote address has its own queue and the crypto threads take one task per address
+ * in turn, so a single address reconnecting many clients can not delay the logins of others.
+ * With 0 threads tasks run directly on the calling thread.
+ */
+class AuthCryptoPool
+{
+public:
+    static AuthCryptoPool* Instance();
+
+    void Start(uint32 threadCount, uint32 maxQueued, uint32 maxQueuedPerAddress);
+    void Stop();
+
+    // Returns an invalid future when the task was rejected because a queue limit was reached
+    template<typename Task>
+    std::future<std::invoke_result_t<Task>> Enqueue(boost::asio::ip::address const& address, Task&& task)
+    {
+        using Result = std::invoke_result_t<Task>;
+        std::shared_ptr<std::packaged_task<Result()>> packagedTask = std::make_shared<std::packaged_task<Result()>>(std::forward<Task>(task));
+        std::future<Result> future = packagedTask->get_future();
+        if (!EnqueueWork(address, [packagedTask]() { (*packagedTask)(); }))
+            return {};
+
+        return future;
+    }
+
+    void RecordLogin(bool success, Milliseconds handshakeTime);
+
+    // Statistics since the previous call
+    AuthCryptoStats ConsumeStats();
+
+    // Sends the statistics to the metric database, called with the other overall status metrics
+    void LogStats();
+
+private:
+    struct QueuedTask
+    {
+        std::function<void()> Work;
+        TimePoint QueueTime;
+    };
+
+    AuthCryptoPool();
+    ~AuthCryptoPool();
+
+    bool EnqueueWork(boost::asio::ip::address const& address, std::function<void()>&& work);
+    void WorkerThread();
+
+    std::vector<std::thread> _threads;
+    std::mutex _queueLock;
+    std::condition_variable _queueCondition;
+    std::map<boost::asio::ip::address, std::deque<QueuedTask>> _queues;
+    std::deque<boost::asio::ip::address> _readyAddresses;  // addresses with queued tasks, in the order they are served
+    uint32 _queued;
+    uint32 _maxQueued;
+    uint32 _maxQueuedPerAddress;
+    bool _stopping;
+
+    std::mutex _statsLock;
+    TimePoint _statsStart;
+    uint64 _rejected;
+    uint64 _logins;
+    uint64 _failedLogins;
+    std::vector<uint32> _handshakeTimes;
+    std::vector<uint32> _queueWaitTimes;
+};
+
+#define sAuthCryptoPool AuthCryptoPool::Instance()
+
+#endif // AuthCryptoPool_h__
@@ -18,6 +18,7 @@
 #include "AuthSession.h"
 #include "AES.h"
 #include "AuthCodes.h"
+#include "AuthCryptoPool.h"
 #include "ByteBuffer.h"
 #include "Config.h"
 #include "CryptoGenerics.h"
@@ -112,6 +113,15 @@ static_assert(sizeof(sAuthReconnectProof_C) == (1 + 16 + 20 + 20 + 1));
 
 #pragma pack(pop)
 
+struct LogonProofData
+{
+    Trinity::Crypto::SRP6::EphemeralKey A;
+    Trinity::Crypto::SHA1::Digest ClientM;
+    Trinity::Crypto::SHA1::Digest VersionProof;
+    bool SentToken;
+    Optional<uint32> Token;
+};
+
 std::array<uint8, 16> VersionChallenge = { { 0xBA, 0xA3, 0x1E, 0x99, 0xA0, 0x0B, 0x21, 0x57, 0xFC, 0x37, 0x3F, 0xB3, 0x69, 0xCD, 0xD2, 0xF1 } };
 
 #define MAX_ACCEPTED_CHALLENGE_SIZE (sizeof(AUTH_LOGON_CHALLENGE_C) + 16)
@@ -179,6 +189,33 @@ bool AuthSession::Update()
 
     _queryProcessor.ProcessReadyCallbacks();
 
+    if (_cryptoCallback && _cryptoCallback())
+        _cryptoCallback = nullptr;
+
+    return true;
+}
+
+template<typename Task, typename Callback>
+bool AuthSession::QueueCryptoTask(Task&& task, Callback&& callback)
+{
+    // the task keeps the session alive, it must not be destroyed while a crypto thread uses it
+    auto future = sAuthCryptoPool->Enqueue(GetRemoteIpAddress(), [self = shared_from_this(), task = std::forward<Task>(task)]() mutable
+    {
+        (void)self;
+        return task();
+    });
+
+    if (!future.valid())
+        return false;
+
+    _cryptoCallback = [future = std::make_shared<decltype(future)>(std::move(future)), callback = std::forward<Callback>(callback)]() mutable
+    {
+        if (future->wait_for(0s) != std::future_status::ready)
+            return false;
+
+        callback(future->get());
+        return true;
+    };
     return true;
 }
 
@@ -299,6 +336,7 @@ bool AuthSession::HandleLogonChallenge()
         _localizationName[i] = challenge->country[4 - i - 1];
 
     _timezoneOffset = Minutes(challenge->timezone_bias);
+    _challengeTime = std::chrono::steady_clock::now();
 
     // Get the account details from the account table
     LoginDatabasePreparedStatement* stmt = LoginDatabase.GetPreparedStatement(LOGIN_SEL_LOGONCHALLENGE);
@@ -398,52 +436,76 @@ void AuthSession::LogonChallengeCallback(PreparedQueryResult result)
         }
     }
 
-    _srp6.emplace(
-        _accountInfo.Login,
-        fields[10].GetBinary<Trinity::Crypto::SRP6::SALT_LENGTH>(),
-        fields[11].GetBinary<Trinity::Crypto::SRP6::VERIFIER_LENGTH>()
-    );
-
     // Fill the response packet with the result
-    if (AuthHelper::IsAcceptedClientBuild(_build))
+    if (!AuthHelper::IsAcceptedClientBuild(_build))
     {
-        pkt << uint8(WOW_SUCCESS);
+        pkt << uint8(WOW_FAIL_VERSION_INVALID);
+        SendPacket(pkt);
+        return;
+    }
 
-        pkt.append(_srp6->B);
-        pkt << uint8(1);
-        pkt.append(_srp6->g);
-        pkt << uint8(32);
-        pkt.append(_srp6->N);
-        pkt.append(_srp6->s);
-        pkt.append(VersionChallenge.data(), VersionChallenge.size());
-        pkt << uint8(securityFlags);            // security flags (0x0...0x04)
-
-        if (securityFlags & 0x01)               // PIN input
+    // B = g^b + 3v costs a modular exponentiation, computed by a crypto thread
+    bool queued = QueueCryptoTask(
+        [this, login = _accountInfo.Login, salt = fields[10].GetBinary<Trinity::Crypto::SRP6::SALT_LENGTH>(), verifier = fields[11].GetBinary<Trinity::Crypto::SRP6::VERIFIER_LENGTH>()]()
         {
-            pkt << uint32(0);
-            pkt << uint64(0) << uint64(0);      // 16 bytes hash?
-        }
+            if (!IsOpen())
+                return false;
 
-        if (securityFlags & 0x02)               // Matrix input
+            _srp6.emplace(login, salt, verifier);
+            return true;
+        },
+        [this, securityFlags](bool created)
         {
-            pkt << uint8(0);
-            pkt << uint8(0);
-            pkt << uint8(0);
-            pkt << uint8(0);
-            pkt << uint64(0);
-        }
+            if (created)
+                SendLogonChallengeResponse(securityFlags);
+        });
+
+    if (!queued)
+    {
+        pkt << uint8(WOW_FAIL_DB_BUSY);
+        SendPacket(pkt);
+        TC_LOG_DEBUG("server.authserver", "'{}:{}' [AuthChallenge] crypto queue is full, account {} has to retry", ipAddress, port, _accountInfo.Login);
+    }
+}
+
+void AuthSession::SendLogonChallengeResponse(uint8 securityFlags)
+{
+    ByteBuffer pkt;
+    pkt << uint8(AUTH_LOGON_CHALLENGE);
+    pkt << uint8(0x00);
+    pkt << uint8(WOW_SUCCESS);
 
-        if (securityFlags & 0x04)               // Security token input
-            pkt << uint8(1);
+    pkt.append(_srp6->B);
+    pkt << uint8(1);
+    pkt.append(_srp6->g);
+    pkt << uint8(32);
+    pkt.append(_srp6->N);
+    pkt.append(_srp6->s);
+    pkt.append(VersionChallenge.data(), VersionChallenge.size());
+    pkt << uint8(securityFlags);            // security flags (0x0...0x04)
 
-        TC_LOG_DEBUG("server.authserver", "'{}:{}' [AuthChallenge] account {} is using '{}' locale ({})",
-            ipAddress, port, _accountInfo.Login, _localizationName, GetLocaleByName(_localizationName));
+    if (securityFlags & 0x01)               // PIN input
+    {
+        pkt << uint32(0);
+        pkt << uint64(0) << uint64(0);      // 16 bytes hash?
+    }
 
-        _status = STATUS_LOGON_PROOF;
+    if (securityFlags & 0x02)               // Matrix input
+    {
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint8(0);
+        pkt << uint64(0);
     }
-    else
-        pkt << uint8(WOW_FAIL_VERSION_INVALID);
 
+    if (securityFlags & 0x04)               // Security token input
+        pkt << uint8(1);
+
+    TC_LOG_DEBUG("server.authserver", "'{}:{}' [AuthChallenge] account {} is using '{}' locale ({})",
+        GetRemoteIpAddress().to_string(), GetRemotePort(), _accountInfo.Login, _localizationName, GetLocaleByName(_localizationName));
+
+    _status = STATUS_LOGON_PROOF;
     SendPacket(pkt);
 }
 
@@ -464,24 +526,64 @@ bool AuthSession::HandleLogonProof()
         return false;
     }
 
-    // Check if SRP6 results match (password is correct), else send an error
-    if (std::optional<SessionKey> K = _srp6->VerifyChallengeResponse(logonProof->A, logonProof->clientM))
+    // The read buffer is reused before the proof is verified, copy everything needed afterwards
+    LogonProofData proof;
+    proof.A = logonProof->A;
+    proof.ClientM = logonProof->clientM;
+    proof.VersionProof = logonProof->crc_hash;
+    proof.SentToken = (logonProof->securityFlags & 0x04);
+    if (proof.SentToken && _totpSecret)
     {
-        _sessionKey = *K;
+        uint8 size = *(GetReadBuffer().GetReadPointer() + sizeof(sAuthLogonProof_C));
+        std::string token(reinterpret_cast<char*>(GetReadBuffer().GetReadPointer() + sizeof(sAuthLogonProof_C) + sizeof(size)), size);
+        GetReadBuffer().ReadCompleted(sizeof(size) + size);
+
+        proof.Token = atoi(token.c_str());
+    }
+
+    // Check if SRP6 results match (password is correct), S = (Av^u)^b is computed by a crypto thread
+    bool queued = QueueCryptoTask(
+        [this, A = proof.A, clientM = proof.ClientM]() -> Optional<SessionKey>
+        {
+            if (!IsOpen())
+                return {};
+
+            return _srp6->VerifyChallengeResponse(A, clientM);
+        },
+        [this, proof](Optional<SessionKey> const& sessionKey)
+        {
+            // skipped verifications of closed sockets must not count as wrong passwords
+            if (IsOpen())
+                LogonProofCallback(sessionKey, proof);
+        });
+
+    if (!queued)
+    {
+        ByteBuffer packet;
+        packet << uint8(AUTH_LOGON_PROOF);
+        packet << uint8(WOW_FAIL_DB_BUSY);
+        packet << uint16(0);    // LoginFlags, 1 has account message
+        SendPacket(packet);
+    }
+
+    return true;
+}
+
+void AuthSession::LogonProofCallback(Optional<SessionKey> const& sessionKey, LogonProofData const& proof)
+{
+    Milliseconds handshakeTime = std::chrono::duration_cast<Milliseconds>(std::chrono::steady_clock::now() - _challengeTime);
+
+    if (sessionKey)
+    {
+        _sessionKey = *sessionKey;
         // Check auth token
         bool tokenSuccess = false;
-        bool sentToken = (logonProof->securityFlags & 0x04);
-        if (sentToken && _totpSecret)
+        if (proof.SentToken && _totpSecret)
         {
-            uint8 size = *(GetReadBuffer().GetReadPointer() + sizeof(sAuthLogonProof_C));
-            std::string token(reinterpret_cast<char*>(GetReadBuffer().GetReadPointer() + sizeof(sAuthLogonProof_C) + sizeof(size)), size);
-            GetReadBuffer().ReadCompleted(sizeof(size) + size);
-
-            uint32 incomingToken = atoi(token.c_str());
-            tokenSuccess = Trinity::Crypto::TOTP::ValidateToken(*_totpSecret, incomingToken);
+            tokenSuccess = proof.Token && Trinity::Crypto::TOTP::ValidateToken(*_totpSecret, *proof.Token);
             memset(_totpSecret->data(), 0, _totpSecret->size());
         }
-        else if (!sentToken && !_totpSecret)
+        else if (!proof.SentToken && !_totpSecret)
             tokenSuccess = true;
 
         if (!tokenSuccess)
@@ -491,16 +593,18 @@ bool AuthSession::HandleLogonProof()
             packet << uint8(WOW_FAIL_UNKNOWN_ACCOUNT);
             packet << uint16(0);    // LoginFlags, 1 has account message
             SendPacket(packet);
-            return true;
+            sAuthCryptoPool->RecordLogin(false, handshakeTime);
+            return;
         }
 
-        if (!VerifyVersion(logonProof->A.data(), logonProof->A.size(), logonProof->crc_hash, false))
+        if (!VerifyVersion(proof.A.data(), proof.A.size(), proof.VersionProof, false))
         {
             ByteBuffer packet;
             packet << uint8(AUTH_LOGON_PROOF);
             packet << uint8(WOW_FAIL_VERSION_INVALID);
             SendPacket(packet);
-            return true;
+            sAuthCryptoPool->RecordLogin(false, handshakeTime);
+            return;
         }
 
         TC_LOG_DEBUG("server.authserver", "'{}:{}' User '{}' successfully authenticated", GetRemoteIpAddress().to_string(), GetRemotePort(), _accountInfo.Login);
@@ -519,7 +623,7 @@ bool AuthSession::HandleLogonProof()
         LoginDatabase.DirectExecute(stmt);
 
         // Finish SRP6 and send the final result to the client
-        Trinity::Crypto::SHA1::Digest M2 = Trinity::Crypto::SRP6::GetSessionVerifier(logonProof->A, logonProof->clientM, _sessionKey);
+        Trinity::Crypto::SHA1::Digest M2 = Trinity::Crypto::SRP6::GetSessionVerifier(proof.A, proof.ClientM, _sessionKey);
 
         ByteBuffer packet;
         if (_expversion & POST_BC_EXP_FLAG)                 // 2.x and 3.x clients
@@ -549,6 +653,7 @@ bool AuthSession::HandleLogonProof()
 
         SendPacket(packet);
         _status = STATUS_AUTHED;
+        sAuthCryptoPool->RecordLogin(true, handshakeTime);
     }
     else
     {
@@ -557,6 +662,7 @@ bool AuthSession::HandleLogonProof()
         packet << uint8(WOW_FAIL_UNKNOWN_ACCOUNT);
         packet << uint16(0);    // LoginFlags, 1 has account message
         SendPacket(packet);
+        sAuthCryptoPool->RecordLogin(false, handshakeTime);
 
         TC_LOG_INFO("server.authserver.hack", "'{}:{}' [AuthChallenge] 账号 {} 尝试使用无效的密码登录!",
             GetRemoteIpAddress().to_string(), GetRemotePort(), _accountInfo.Login);
@@ -609,8 +715,6 @@ bool AuthSession::HandleLogonProof()
             }
         }
     }
-
-    return true;
 }
 
 bool AuthSession::HandleReconnectChallenge()
@@ -32,6 +32,7 @@ using boost::asio::ip::tcp;
 
 class ByteBuffer;
 struct AuthHandler;
+struct LogonProofData;
 
 enum AuthStatus
 {
@@ -87,6 +88,13 @@ private:
     void ReconnectChallengeCallback(PreparedQueryResult result);
     void RealmListCallback(PreparedQueryResult result);
 
+    void SendLogonChallengeResponse(uint8 securityFlags);
+    void LogonProofCallback(Optional<SessionKey> const& sessionKey, LogonProofData const& proof);
+
+    // Runs task on a crypto thread and callback from Update once it finished, false if the crypto queue is full
+    template<typename Task, typename Callback>
+    bool QueueCryptoTask(Task&& task, Callback&& callback);
+
     bool VerifyVersion(uint8 const* a, int32 aLength, Trinity::Crypto::SHA1::Digest const& versionProof, bool isReconnect);
 
     Optional<Trinity::Crypto::SRP6> _srp6;
@@ -104,6 +112,8 @@ private:
     uint8 _expversion;
 
     QueryCallbackProcessor _queryProcessor;
+    std::function<bool()> _cryptoCallback;
+    TimePoint _challengeTime;
 };
 
 #pragma pack(push, 1)
@@ -34,6 +34,7 @@
 #include "LootMgr.h"
 #include "Mail.h"
 #include "MapManager.h"
+#include "MapUnitSnapshotImpl.h"
 #include "MotionMaster.h"
 #include "ObjectMgr.h"
 #include "PathGenerator.h"
@@ -3858,7 +3859,7 @@ Unit* bot_ai::_getVehicleTarget(BotVehicleStrats /*strat*/) const
     Unit* t = nullptr;
     NearbyHostileVehicleTargetCheck check(veh, maxdist, this);
     Trinity::UnitSearcher <NearbyHostileVehicleTargetCheck> searcher(veh, t, check);
-    Cell::VisitAllObjects(veh, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(veh, searcher, maxdist);
     //veh->VisitNearbyObject(maxdist, searcher);
 
     return t;
@@ -4407,7 +4408,7 @@ std::tuple<Unit*, Unit*> bot_ai::_getTargets(bool byspell, bool ranged, bool &re
     std::list<Unit*> unitList;
     NearestHostileUnitCheck check(me, maxdist, byspell, this);
     Trinity::UnitListSearcher searcher(master->ToUnit(), unitList, check);
-    Cell::VisitAllObjects(HasBotCommandState(BOT_COMMAND_STAY) ? me->ToUnit() : master->ToUnit(), searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(HasBotCommandState(BOT_COMMAND_STAY) ? me->ToUnit() : master->ToUnit(), searcher, maxdist);
 
     if (IAmFree())
     {
@@ -6247,7 +6248,7 @@ Unit* bot_ai::FindImmunityShieldDispelTarget(float dist) const
 
     ImmunityShieldDispelTargetCheck check(me, dist, this);
     Trinity::UnitSearcher <ImmunityShieldDispelTargetCheck> searcher(me, unit, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     return unit;
@@ -6260,7 +6261,7 @@ Unit* bot_ai::FindHostileDispelTarget(float dist, bool stealable) const
 
     HostileDispelTargetCheck check(me, dist, stealable, this);
     Trinity::UnitListSearcher <HostileDispelTargetCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6294,7 +6295,7 @@ Unit* bot_ai::FindAffectedTarget(uint32 spellId, ObjectGuid caster, float dist,
 
     AffectedTargetCheck check(caster, dist, spellId, master, hostile);
     Trinity::UnitSearcher <AffectedTargetCheck> searcher(master, unit, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     return unit;
@@ -6306,7 +6307,7 @@ Unit* bot_ai::FindPolyTarget(float dist) const
 
     PolyUnitCheck check(me, dist);
     Trinity::UnitListSearcher <PolyUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6326,7 +6327,7 @@ Unit* bot_ai::FindFearTarget(float dist) const
 
     FearUnitCheck check(me, dist);
     Trinity::UnitListSearcher <FearUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6346,7 +6347,7 @@ Unit* bot_ai::FindStunTarget(float dist) const
 
     StunUnitCheck check(me, dist);
     Trinity::UnitListSearcher <StunUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6369,7 +6370,7 @@ Unit* bot_ai::FindUndeadCCTarget(float dist, uint32 spellId, bool unattacked) co
 
     UndeadCCUnitCheck check(me, dist, this, spellId, unattacked);
     Trinity::UnitListSearcher <UndeadCCUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6392,7 +6393,7 @@ Unit* bot_ai::FindRootTarget(float dist, uint32 spellId) const
 
     RootUnitCheck check(me, dist, this, spellId);
     Trinity::UnitListSearcher <RootUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (unitList.empty())
@@ -6413,7 +6414,7 @@ Unit* bot_ai::FindCastingTarget(float maxdist, float mindist, uint32 spellId, ui
 
     CastingUnitCheck check(me, mindist, maxdist, spellId, minHpPct);
     Trinity::UnitListSearcher <CastingUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 
     if (unitList.empty())
@@ -6500,7 +6501,7 @@ Unit* bot_ai::FindSplashTarget(float dist, Unit* To, float splashdist) const
 
     SecondEnemyCheck check(me, dist, splashdist, To, this);
     Trinity::UnitSearcher <SecondEnemyCheck> searcher(me, unit, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     return unit;
@@ -6518,7 +6519,7 @@ Unit* bot_ai::FindSplashTarget(float dist, Unit* To, float splashdist, uint8 min
 
     SecondEnemyCheck check(me, dist, splashdist, To, this);
     Trinity::UnitListSearcher <SecondEnemyCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, dist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, dist);
     //me->VisitNearbyObject(dist, searcher);
 
     if (uint8(unitList.size()) < minTargets)
@@ -6535,7 +6536,7 @@ Unit* bot_ai::FindTranquilTarget(float mindist, float maxdist) const
 
     TranquilTargetCheck check(me, mindist, maxdist, this);
     Trinity::UnitSearcher <TranquilTargetCheck> searcher(me, unit, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 
     return unit;
@@ -6548,7 +6549,7 @@ Unit* bot_ai::FindDistantTauntTarget(float maxdist, bool ally) const
 
     FarTauntUnitCheck check(me, maxdist, ally, this);
     Trinity::UnitListSearcher <FarTauntUnitCheck> searcher(me, unitList, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 
     if (unitList.empty())
@@ -6565,7 +6566,7 @@ Unit* bot_ai::FindDrainTarget(float maxdist) const
 
     ManaDrainUnitCheck check(me, maxdist, this);
     Trinity::UnitLastSearcher <ManaDrainUnitCheck> searcher(me, unit, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 
     return unit;
@@ -6582,7 +6583,7 @@ void bot_ai::GetNearbyTargetsList(std::list<Unit*> &targets, float maxdist, uint
 
     NearbyHostileUnitCheck check(me, maxdist, this, CCoption, source);
     Trinity::UnitListSearcher <NearbyHostileUnitCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 }
 //Find all targets within given range in cone in front of caster; angle is PI/2 (TC confirmed)
@@ -6592,7 +6593,7 @@ void bot_ai::GetNearbyTargetsInConeList(std::list<Unit*> &targets, float maxdist
 {
     NearbyHostileUnitInConeCheck check(me, maxdist, this);
     Trinity::UnitListSearcher <NearbyHostileUnitInConeCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 }
 //Finds all friendly targets within given range
@@ -6601,7 +6602,7 @@ void bot_ai::GetNearbyFriendlyTargetsList(std::list<Unit*> &targets, float maxdi
 {
     NearbyFriendlyUnitCheck check(me, maxdist, this);
     Trinity::UnitListSearcher <NearbyFriendlyUnitCheck> searcher(me, targets, check);
-    Cell::VisitAllObjects(me, searcher, maxdist);
+    MapUnitSnapshot::VisitNearbyUnits(me, searcher, maxdist);
     //me->VisitNearbyObject(maxdist, searcher);
 }
 //////////
@@ -16550,7 +16551,7 @@ void bot_ai::DoEmeraldDrakeVehicleStrats(uint32 diff)
             Trinity::AnyUnfriendlyUnitInObjectRangeCheck check(drake, drake, 60.f);
             Trinity::UnitListSearcher <Trinity::AnyUnfriendlyUnitInObjectRangeCheck> searcher(drake, targets, check);
             //drake->VisitNearbyObject(60.f, searcher);
-            Cell::VisitAllObjects(drake, searcher, 60.f);
+            MapUnitSnapshot::VisitNearbyUnits(drake, searcher, 60.f);
             targets.remove_if(BOTAI_PRED::UnitExclude(opponent));
             targets.remove_if(BOTAI_PRED::UnitCombatStateExclude(false));
             targets.remove_if(BOTAI_PRED::AuraedTargetExcludeByCaster(drakespell, drake->GetGUID(), 3));
@@ -16639,7 +16640,7 @@ void bot_ai::DoAmberDrakeVehicleStrats(uint32 diff)
             Trinity::AnyUnfriendlyUnitInObjectRangeCheck check(drake, drake, 60.f);
             Trinity::UnitListSearcher <Trinity::AnyUnfriendlyUnitInObjectRangeCheck> searcher(drake, targets, check);
             //drake->VisitNearbyObject(60.f, searcher);
-            Cell::VisitAllObjects(drake, searcher, 60.f);
+            MapUnitSnapshot::VisitNearbyUnits(drake, searcher, 60.f);
             targets.remove_if(BOTAI_PRED::UnitExclude(opponent));
 
             if (!targets.empty())
@@ -17517,7 +17518,7 @@ bool bot_ai::GlobalUpdate(uint32 diff)
             std::list<Unit*> crList;
             NearbyLootableCreatureCheck check(master, std::min(30.f, std::max(5.f, sWorld->getFloatConfig(CONFIG_GROUP_XP_DISTANCE) - 10.f)));
             Trinity::UnitListSearcher<NearbyLootableCreatureCheck> searcher(me, crList, check);
-            Cell::VisitAllObjects(me, searcher, 40.f);
+            MapUnitSnapshot::VisitNearbyUnits(me, searcher, 40.f);
             //me->VisitNearbyObject(40.f, searcher);
             for (std::list<Unit*>::iterator itr = crList.begin(); itr != crList.end();)
             {
@@ -17691,7 +17692,7 @@ bool bot_ai::GlobalUpdate(uint32 diff)
 
                 Unit* nmover = nullptr;
                 Trinity::UnitSearcher searcher(me, nmover, flag_carrier_pred);
-                Cell::VisitAllObjects(me, searcher, 80.0f);
+                MapUnitSnapshot::VisitNearbyUnits(me, searcher, 80.0f);
                 if (nmover)
                     mmover = nmover;
             }
@@ -179,9 +179,9 @@ public:
                 _illusPos[i].m_positionX = x + ((i <= 1) ? +dist : -dist); // +2+2-2-2
                 _illusPos[i].m_positionY = y + (!(i & 1) ? +dist : -dist); // +2-2+2-2
                 _illusPos[i].m_positionZ = z;
-                me->UpdateAllowedPositionZ(_illusPos[i].m_positionX, _illusPos[i].m_positionY, _illusPos[i].m_positionZ);
                 _illusPos[i].SetOrientation(o);
             }
+            me->UpdateAllowedPositionZ(_illusPos);
         }
 
     public:
@@ -8,6 +8,7 @@
 #include "Containers.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "MapUnitSnapshotImpl.h"
 #include "Group.h"
 //#include "MotionMaster.h"
 #include "Player.h"
@@ -174,7 +175,7 @@ public:
                         std::list<Unit*> units;
                         NearbyHostileUnitCheck check(me, ceradius, this, 0, c);
                         Trinity::UnitListSearcher searcher(c, units, check);
-                        Cell::VisitAllObjects(c, searcher, ceradius);
+                        MapUnitSnapshot::VisitNearbyUnits(c, searcher, ceradius);
                         if (units.size() > maxmob)
                         {
                             maxmob = units.size();
@@ -5,6 +5,7 @@
 #include "Containers.h"
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "MapUnitSnapshotImpl.h"
 #include "MotionMaster.h"
 #include "ScriptMgr.h"
 #include "SpellMgr.h"
@@ -254,7 +255,7 @@ public:
                 {
                     Trinity::AnyUnfriendlyUnitInObjectRangeCheck check(petOwner, petOwner, LOCUST_SWARM_EFFECTIVE_RADIUS);
                     Trinity::UnitListSearcher searcher(petOwner, targets, check);
-                    Cell::VisitAllObjects(petOwner, searcher, LOCUST_SWARM_EFFECTIVE_RADIUS);
+                    MapUnitSnapshot::VisitNearbyUnits(petOwner, searcher, LOCUST_SWARM_EFFECTIVE_RADIUS);
 
                     targets.remove_if([poguid = petOwner->GetGUID(), combat = petOwner->IsInCombat(), max_attackers = _attackers](Unit const* unit) {
                         Unit::AttackerSet const& attackers = unit->getAttackers();
@@ -88,6 +88,7 @@ class TC_GAME_API CreatureGroup
         bool IsLeader(Creature const* creature) const { return _leader == creature; }
 
         bool HasMember(Creature* member) const { return _members.count(member) > 0; }
+        std::unordered_map<Creature*, FormationInfo*> const& GetMembers() const { return _members; }
         void AddMember(Creature* member);
         void RemoveMember(Creature* member);
         void FormationReset(bool dismiss);
@@ -2671,12 +2671,20 @@ void GameObject::EnableCollision(bool enable)
         GetMap()->InsertGameObjectModel(*m_model);*/
 
     m_model->enable(enable ? GetPhaseMask() : 0);
+
+    if (IsInWorld())
+        GetMap()->UpdateGameObjectModelCollision(*m_model);
 }
 
 void GameObject::UpdateModel()
 {
     if (!IsInWorld())
         return;
+
+    // the old model stays in the dynamic tree until regions of a partitioned update are merged, it can't be deleted before
+    if (GetMap()->DeferToPartitionMerge([map = GetMap(), guid = GetGUID()]() { if (GameObject* go = map->GetGameObject(guid)) go->UpdateModel(); }))
+        return;
+
     if (m_model)
         if (GetMap()->ContainsGameObjectModel(*m_model))
             GetMap()->RemoveGameObjectModel(*m_model);
@@ -2893,9 +2901,8 @@ void GameObject::UpdateModelPosition()
 
     if (GetMap()->ContainsGameObjectModel(*m_model))
     {
-        GetMap()->RemoveGameObjectModel(*m_model);
         m_model->UpdatePosition();
-        GetMap()->InsertGameObjectModel(*m_model);
+        GetMap()->UpdateGameObjectModelPosition(*m_model);
     }
 }
 
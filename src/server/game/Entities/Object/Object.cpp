@@ -54,6 +54,7 @@
 #include "VMapManager2.h"
 #include "World.h"
 #include <G3D/Vector3.h>
+#include <array>
 
 //npcbot
 #include "botdatamgr.h"
@@ -976,7 +977,7 @@ elunaEvents(NULL),
 #endif
 m_movementInfo(), m_name(), m_isActive(false), m_isFarVisible(false), m_isWorldObject(isWorldObject), m_zoneScript(nullptr),
 m_transport(nullptr), m_zoneId(0), m_areaId(0), m_staticFloorZ(VMAP_INVALID_HEIGHT), m_outdoors(false), m_liquidStatus(LIQUID_MAP_NO_WATER),
-m_currMap(nullptr), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_notifyflags(0)
+m_currMap(nullptr), m_InstanceId(0), m_phaseMask(PHASEMASK_NORMAL), m_notifyflags(0), m_skippedUpdateDiff(0)
 {
     m_serverSideVisibility.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE | GHOST_VISIBILITY_GHOST);
     m_serverSideVisibilityDetect.SetValue(SERVERSIDE_VISIBILITY_GHOST, GHOST_VISIBILITY_ALIVE);
@@ -1517,6 +1518,58 @@ void WorldObject::UpdateAllowedPositionZ(float x, float y, float &z, float* grou
     }
 }
 
+void WorldObject::UpdateAllowedPositionZ(std::span<Position> positions) const
+{
+    // TODO: Allow transports to be part of dynamic vmap tree
+    if (GetTransport() || positions.empty())
+        return;
+
+    std::vector<float> groundZ(positions.size());
+    if (Unit const* unit = ToUnit())
+    {
+        float hoverOffset = unit->GetHoverOffset();
+        if (!unit->CanFly())
+        {
+            std::vector<float> maxZ(positions.size());
+            if (unit->CanSwim())
+                GetMap()->GetWaterOrGroundLevels(GetPhaseMask(), positions, maxZ, groundZ, GetCollisionHeight());
+            else
+            {
+                GetMapHeights(positions, groundZ);
+                maxZ = groundZ;
+            }
+
+            for (std::size_t i = 0; i < positions.size(); ++i)
+            {
+                if (maxZ[i] <= INVALID_HEIGHT)
+                    continue;
+
+                // hovering units cannot go below their hover height
+                float max_z = maxZ[i] + hoverOffset;
+                float ground_z = groundZ[i] + hoverOffset;
+
+                if (positions[i].m_positionZ > max_z)
+                    positions[i].m_positionZ = max_z;
+                else if (positions[i].m_positionZ < ground_z)
+                    positions[i].m_positionZ = ground_z;
+            }
+        }
+        else
+        {
+            GetMapHeights(positions, groundZ);
+            for (std::size_t i = 0; i < positions.size(); ++i)
+                positions[i].m_positionZ = std::max(positions[i].m_positionZ, groundZ[i] + hoverOffset);
+        }
+    }
+    else
+    {
+        GetMapHeights(positions, groundZ);
+        for (std::size_t i = 0; i < positions.size(); ++i)
+            if (groundZ[i] > INVALID_HEIGHT)
+                positions[i].m_positionZ = groundZ[i];
+    }
+}
+
 float WorldObject::GetGridActivationRange() const
 {
     if (isActiveObject())
@@ -1572,6 +1625,22 @@ float WorldObject::GetSightRange(WorldObject const* target) const
     return 0.0f;
 }
 
+bool WorldObject::IsVisibilityDistanceIndependent(WorldObject const* obj) const
+{
+    if (obj->IsAlwaysVisibleFor(this) || CanAlwaysSee(obj))
+        return true;
+
+    if (obj->IsVisibilityOverridden() || obj->IsFarVisible())
+        return true;
+
+    // see corpse check in CanSeeOrDetect
+    if (Player const* thisPlayer = ToPlayer())
+        if (thisPlayer->isDead() && thisPlayer->GetHealth() > 0)
+            return true;
+
+    return false;
+}
+
 bool WorldObject::CanSeeOrDetect(WorldObject const* obj, bool implicitDetect, bool distanceCheck, bool checkAlert) const
 {
     if (this == obj)
@@ -3432,14 +3501,22 @@ void WorldObject::GetNearPoint(WorldObject const* searcher, float& x, float& y,
     float first_y = y;
     float first_z = z;
 
-    // loop in a circle to look for a point in LoS using small steps
-    for (float angle = float(M_PI) / 8; angle < float(M_PI) * 2; angle += float(M_PI) / 8)
+    // loop in a circle to look for a point in LoS using small steps, heights of all points are found in one batch
+    std::array<Position, 15> points;
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        GetNearPoint2D(searcher, points[i].m_positionX, points[i].m_positionY, distance2d, absAngle + float(M_PI) / 8 * (i + 1));
+        points[i].m_positionZ = GetPositionZ();
+    }
+
+    (searcher ? searcher : this)->UpdateAllowedPositionZ(points);
+    for (Position const& point : points)
     {
-        GetNearPoint2D(searcher, x, y, distance2d, absAngle + angle);
-        z = GetPositionZ();
-        (searcher ? searcher : this)->UpdateAllowedPositionZ(x, y, z);
-        if (IsWithinLOS(x, y, z))
+        if (IsWithinLOS(point.m_positionX, point.m_positionY, point.m_positionZ))
+        {
+            point.GetPosition(x, y, z);
             return;
+        }
     }
 
     // still not in LoS, give up and return first position found
@@ -3816,6 +3893,16 @@ float WorldObject::GetMapHeight(float x, float y, float z, bool vmap/* = true*/,
     return GetMap()->GetHeight(GetPhaseMask(), x, y, z, vmap, distanceToSearch);
 }
 
+void WorldObject::GetMapHeights(std::span<Position const> positions, std::span<float> heights, bool vmap/* = true*/, float distanceToSearch/* = DEFAULT_HEIGHT_SEARCH*/) const
+{
+    std::vector<Position> searchPositions(positions.begin(), positions.end());
+    for (Position& pos : searchPositions)
+        if (pos.m_positionZ != MAX_HEIGHT)
+            pos.m_positionZ += Z_OFFSET_FIND_HEIGHT;
+
+    GetMap()->GetHeights(GetPhaseMask(), searchPositions, heights, vmap, distanceToSearch);
+}
+
 std::string WorldObject::GetDebugInfo() const
 {
     std::stringstream sstr;
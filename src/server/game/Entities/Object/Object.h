@@ -34,6 +34,7 @@
 #include "UpdateMask.h"
 #include <list>
 #include <set>
+#include <span>
 #include <unordered_map>
 
 class Corpse;
@@ -331,6 +332,8 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         virtual float GetCombatReach() const { return 0.0f; } // overridden (only) in Unit
         void UpdateGroundPositionZ(float x, float y, float &z) const;
         void UpdateAllowedPositionZ(float x, float y, float &z, float* groundZ = nullptr) const;
+        // Batch version of UpdateAllowedPositionZ for many candidate points, uses Map::GetHeights
+        void UpdateAllowedPositionZ(std::span<Position> positions) const;
 
         void GetRandomPoint(Position const& srcPos, float distance, float& rand_x, float& rand_y, float& rand_z) const;
         Position GetRandomPoint(Position const& srcPos, float distance) const;
@@ -407,6 +410,9 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         float GetVisibilityRange() const;
         float GetSightRange(WorldObject const* target = nullptr) const;
         bool CanSeeOrDetect(WorldObject const* obj, bool implicitDetect = false, bool distanceCheck = false, bool checkAlert = false) const;
+        // true if obj may be seen from outside of sight range (always visible objects, visibility overrides, ghosts seeing around
+        // their corpse). Other objects out of sight range can be skipped by notifiers without calling CanSeeOrDetect
+        bool IsVisibilityDistanceIndependent(WorldObject const* obj) const;
 
         FlaggedValuesArray32<int32, uint32, StealthType, TOTAL_STEALTH_TYPES> m_stealth;
         FlaggedValuesArray32<int32, uint32, StealthType, TOTAL_STEALTH_TYPES> m_stealthDetect;
@@ -513,6 +519,10 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         uint16 GetNotifyFlags() const { return m_notifyflags; }
         void ResetAllNotifies() { m_notifyflags = 0; }
 
+        // time not passed to Update() yet because of map update level of detail, see MapUpdateLod
+        uint32 GetSkippedUpdateDiff() const { return m_skippedUpdateDiff; }
+        void SetSkippedUpdateDiff(uint32 diff) { m_skippedUpdateDiff = diff; }
+
         bool isActiveObject() const { return m_isActive; }
         void setActive(bool isActiveObject);
         bool IsFarVisible() const { return m_isFarVisible; }
@@ -553,6 +563,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
 
         float GetMapWaterOrGroundLevel(float x, float y, float z, float* ground = nullptr) const;
         float GetMapHeight(float x, float y, float z, bool vmap = true, float distanceToSearch = 50.0f) const; // DEFAULT_HEIGHT_SEARCH in map.h
+        void GetMapHeights(std::span<Position const> positions, std::span<float> heights, bool vmap = true, float distanceToSearch = 50.0f) const; // DEFAULT_HEIGHT_SEARCH in map.h
 
         std::string GetDebugInfo() const override;
 
@@ -595,6 +606,7 @@ class TC_GAME_API WorldObject : public Object, public WorldLocation
         uint32 m_phaseMask;                               // in area phase state
 
         uint16 m_notifyflags;
+        uint32 m_skippedUpdateDiff;
         virtual bool _IsWithinDist(WorldObject const* obj, float dist2compare, bool is3D, bool incOwnRadius = true, bool incTargetRadius = true) const;
 
         bool CanNeverSee(WorldObject const* obj) const;
@@ -35,60 +35,182 @@ void UpdateData::AddOutOfRangeGUID(ObjectGuid guid)
     m_outOfRangeGUIDs.insert(guid);
 }
 
-void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+namespace
+{
+    // deflate state is allocated once per thread and only reset between packets
+    class UpdateDataDeflateContext
+    {
+        public:
+            UpdateDataDeflateContext() : _stream(), _level(0), _initialized(false) { }
+
+            ~UpdateDataDeflateContext()
+            {
+                if (_initialized)
+                    deflateEnd(&_stream);
+            }
+
+            UpdateDataDeflateContext(UpdateDataDeflateContext const&) = delete;
+            UpdateDataDeflateContext& operator=(UpdateDataDeflateContext const&) = delete;
+
+            z_stream* Acquire(int level)
+            {
+                if (!_initialized)
+                {
+                    _stream.zalloc = (alloc_func)nullptr;
+                    _stream.zfree = (free_func)nullptr;
+                    _stream.opaque = (voidpf)nullptr;
+
+                    int z_res = deflateInit(&_stream, level);
+                    if (z_res != Z_OK)
+                    {
+                        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: {} ({})", z_res, zError(z_res));
+                        return nullptr;
+                    }
+
+                    _level = level;
+                    _initialized = true;
+                    return &_stream;
+                }
+
+                int z_res = deflateReset(&_stream);
+                if (z_res == Z_OK && level != _level)
+                {
+                    z_res = deflateParams(&_stream, level, Z_DEFAULT_STRATEGY);
+                    _level = level;
+                }
+
+                if (z_res != Z_OK)
+                {
+                    TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateReset) Error code: {} ({})", z_res, zError(z_res));
+                    Release();
+                    return nullptr;
+                }
+
+                return &_stream;
+            }
+
+            // drops the state after a failure, next packet initializes a new one
+            void Release()
+            {
+                deflateEnd(&_stream);
+                _initialized = false;
+            }
+
+        private:
+            z_stream _stream;
+            int _level;
+            bool _initialized;
+    };
+
+    // adaptive compression sends packets uncompressed for a while when they stop shrinking
+    struct UpdateDataAdaptiveCompression
+    {
+        static constexpr uint32 SKIPPED_PACKETS_BEFORE_PROBE = 32;
+        static constexpr float RATIO_WEIGHT = 0.125f;
+
+        float AverageRatio = 0.0f;
+        uint32 SkipRemaining = 0;
+
+        bool ShouldCompress()
+        {
+            if (!SkipRemaining)
+                return true;
+
+            --SkipRemaining;
+            return false;
+        }
+
+        void AddSample(size_t srcSize, uint32 dstSize, float maxRatio)
+        {
+            float const ratio = float(dstSize) / float(srcSize);
+            AverageRatio = AverageRatio > 0.0f ? AverageRatio + (ratio - AverageRatio) * RATIO_WEIGHT : ratio;
+            if (AverageRatio <= maxRatio)
+                return;
+
+            // start over from the probe packet sent once skipping is done
+            AverageRatio = 0.0f;
+            SkipRemaining = SKIPPED_PACKETS_BEFORE_PROBE;
+        }
+    };
+
+    thread_local UpdateDataDeflateContext DeflateContext;
+    thread_local UpdateDataAdaptiveCompression AdaptiveCompression;
+    thread_local UpdateDataCompressionStats CompressionStats;
+}
+
+UpdateDataCompressionStats& UpdateDataCompressionStats::operator+=(UpdateDataCompressionStats const& right)
 {
-    z_stream c_stream;
+    Packets += right.Packets;
+    SkippedPackets += right.SkippedPackets;
+    BytesIn += right.BytesIn;
+    BytesOut += right.BytesOut;
+    Time += right.Time;
+    return *this;
+}
+
+UpdateDataCompressionStats UpdateDataCompressionStats::operator-(UpdateDataCompressionStats const& right) const
+{
+    UpdateDataCompressionStats result;
+    result.Packets = Packets - right.Packets;
+    result.SkippedPackets = SkippedPackets - right.SkippedPackets;
+    result.BytesIn = BytesIn - right.BytesIn;
+    result.BytesOut = BytesOut - right.BytesOut;
+    result.Time = Time - right.Time;
+    return result;
+}
+
+UpdateDataCompressionStats const& UpdateData::GetThreadCompressionStats()
+{
+    return CompressionStats;
+}
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+void UpdateData::AddThreadCompressionStats(UpdateDataCompressionStats const& stats)
+{
+    CompressionStats += stats;
+}
 
+void UpdateData::Compress(void* dst, uint32 *dst_size, void* src, int src_size)
+{
     // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld->getIntConfig(CONFIG_COMPRESSION));
-    if (z_res != Z_OK)
+    z_stream* c_stream = DeflateContext.Acquire(sWorld->getIntConfig(CONFIG_COMPRESSION));
+    if (!c_stream)
     {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateInit) Error code: {} ({})", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
+    int z_res = deflate(c_stream, Z_NO_FLUSH);
     if (z_res != Z_OK)
     {
         TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate) Error code: {} ({})", z_res, zError(z_res));
+        DeflateContext.Release();
         *dst_size = 0;
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    if (c_stream->avail_in != 0)
     {
         TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate not greedy)");
+        DeflateContext.Release();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
+    z_res = deflate(c_stream, Z_FINISH);
     if (z_res != Z_STREAM_END)
     {
         TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflate should report Z_STREAM_END instead {} ({})", z_res, zError(z_res));
+        DeflateContext.Release();
         *dst_size = 0;
         return;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
-    {
-        TC_LOG_ERROR("misc", "Can't compress update packet (zlib: deflateEnd) Error code: {} ({})", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
-    }
-
-    *dst_size = c_stream.total_out;
+    *dst_size = c_stream->total_out;
 }
 
 bool UpdateData::BuildPacket(WorldPacket* packet)
@@ -112,8 +234,18 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (pSize > 100)                                       // compress large packets
+    bool compress = pSize > sWorld->getIntConfig(CONFIG_COMPRESSION_MIN_SIZE);   // compress large packets
+    bool const adaptive = compress && sWorld->getBoolConfig(CONFIG_COMPRESSION_ADAPTIVE);
+    if (adaptive && !AdaptiveCompression.ShouldCompress())
     {
+        ++CompressionStats.SkippedPackets;
+        compress = false;
+    }
+
+    if (compress)
+    {
+        TimePoint const start = std::chrono::steady_clock::now();
+
         uint32 destsize = compressBound(pSize);
         packet->resize(destsize + sizeof(uint32));
 
@@ -124,6 +256,14 @@ bool UpdateData::BuildPacket(WorldPacket* packet)
 
         packet->resize(destsize + sizeof(uint32));
         packet->SetOpcode(SMSG_COMPRESSED_UPDATE_OBJECT);
+
+        ++CompressionStats.Packets;
+        CompressionStats.BytesIn += pSize;
+        CompressionStats.BytesOut += destsize;
+        CompressionStats.Time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+        if (adaptive)
+            AdaptiveCompression.AddSample(pSize, destsize, sWorld->getFloatConfig(CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO));
     }
     else                                                    // send small packets without compression
     {
@@ -20,6 +20,7 @@
 
 #include "Define.h"
 #include "ByteBuffer.h"
+#include "Duration.h"
 #include "ObjectGuid.h"
 #include <set>
 
@@ -50,6 +51,19 @@ enum OBJECT_UPDATE_FLAGS
     UPDATEFLAG_ROTATION             = 0x0200
 };
 
+// Compression counters of UpdateData::BuildPacket, kept per thread
+struct UpdateDataCompressionStats
+{
+    uint32 Packets = 0;                                     // compressed packets
+    uint32 SkippedPackets = 0;                              // large packets sent uncompressed by adaptive compression
+    uint64 BytesIn = 0;
+    uint64 BytesOut = 0;
+    std::chrono::microseconds Time = std::chrono::microseconds::zero();
+
+    UpdateDataCompressionStats& operator+=(UpdateDataCompressionStats const& right);
+    UpdateDataCompressionStats operator-(UpdateDataCompressionStats const& right) const;
+};
+
 class UpdateData
 {
     public:
@@ -70,6 +84,10 @@ class UpdateData
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        static UpdateDataCompressionStats const& GetThreadCompressionStats();
+        // merges counters gathered on another thread into the calling thread ones
+        static void AddThreadCompressionStats(UpdateDataCompressionStats const& stats);
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
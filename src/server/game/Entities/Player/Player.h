@@ -23,6 +23,7 @@
 #include "DatabaseEnvFwd.h"
 #include "DBCEnums.h"
 #include "EquipmentSet.h"
+#include "FlatSet.h"
 #include "GroupReference.h"
 #include "ItemDefines.h"
 #include "ItemEnchantmentMgr.h"
@@ -30,6 +31,7 @@
 #include "PetDefines.h"
 #include "PlayerTaxi.h"
 #include "QuestDef.h"
+#include "VisibilityDiff.h"
 #include <memory>
 #include <queue>
 #include <unordered_set>
@@ -73,6 +75,7 @@ class PlayerAI;
 class PlayerMenu;
 class PlayerSocial;
 class ReputationMgr;
+class SharedWorldPacket;
 class SpellCastTargets;
 class TradeData;
 
@@ -1897,6 +1900,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SendInitWorldStates(uint32 zoneId, uint32 areaId);
         void SendUpdateWorldState(uint32 variable, uint32 value) const;
         void SendDirectMessage(WorldPacket const* data) const;
+        void SendDirectMessage(SharedWorldPacket& data) const;
         void SendBGWeekendWorldStates() const;
         void SendBattlefieldWorldStates() const;
 
@@ -2026,8 +2030,12 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
 
         WorldLocation GetStartPosition() const;
 
-        // currently visible objects at player client
-        GuidUnorderedSet m_clientGUIDs;
+        // currently visible objects at player client, sorted for merging with visibility passes
+        Trinity::Containers::FlatSet<ObjectGuid> m_clientGUIDs;
+
+        // scratch buffers of Trinity::VisibleNotifier, kept between passes to reuse their memory
+        Trinity::VisibilityDiff m_visibilityPassDiff;
+        std::vector<Unit*> m_visibilityPassVisibleNow;
 
         bool HaveAtClient(Object const* u) const;
 
@@ -2043,7 +2051,7 @@ class TC_GAME_API Player : public Unit, public GridObject<Player>
         void SetPhaseMask(uint32 newPhaseMask, bool update) override;// overwrite Unit::SetPhaseMask
 
         template<class T>
-        void UpdateVisibilityOf(T* target, UpdateData& data, std::set<Unit*>& visibleNow);
+        void UpdateVisibilityOf(T* target, UpdateData& data, std::vector<Unit*>& visibleNow);
 
         bool HasAtLoginFlag(AtLoginFlags f) const { return (m_atLoginFlags & f) != 0; }
         void SetAtLoginFlag(AtLoginFlags f) { m_atLoginFlags |= f; }
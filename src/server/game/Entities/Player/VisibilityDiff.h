@@ -0,0 +1,94 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_VISIBILITY_DIFF_H
+#define TRINITY_VISIBILITY_DIFF_H
+
+#include "ObjectGuid.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+namespace Trinity
+{
+    // Scratch state of one visibility pass of a player.
+    // Guids of visited objects are collected unsorted, sorted once at the end of the pass and merged
+    // against the objects known by client at the start of the pass to find the ones that left visibility.
+    // Buffers keep their capacity between passes so steady state passes do not allocate.
+    class VisibilityDiff
+    {
+        public:
+            void Clear()
+            {
+                _visited.clear();
+                _known.clear();
+                _left.clear();
+                _sortedCount = 0;
+            }
+
+            void AddVisited(ObjectGuid const& guid)
+            {
+                _visited.push_back(guid);
+            }
+
+            // Sorts the guids visited so far, call before a series of IsVisited lookups
+            void SortVisited()
+            {
+                if (_sortedCount == _visited.size())
+                    return;
+
+                std::sort(_visited.begin(), _visited.end());
+                _sortedCount = _visited.size();
+            }
+
+            // Only guids added before the last SortVisited call are found
+            bool IsVisited(ObjectGuid const& guid) const
+            {
+                return std::binary_search(_visited.begin(), _visited.begin() + _sortedCount, guid);
+            }
+
+            // Objects known by client when the pass starts, known must be sorted (Trinity::Containers::FlatSet)
+            template<class SortedGuids>
+            void SetKnown(SortedGuids const& known)
+            {
+                _known.assign(known.begin(), known.end());
+            }
+
+            // Objects known at the start of the pass that were not visited and are still in known.
+            // Objects added to known meanwhile (nested pass of the same player) are never reported,
+            // result is valid until next Clear
+            template<class SortedGuids>
+            std::vector<ObjectGuid> const& ComputeLeft(SortedGuids const& known)
+            {
+                SortVisited();
+                _left.clear();
+                std::set_difference(_known.begin(), _known.end(), _visited.begin(), _visited.end(), std::back_inserter(_left));
+                std::erase_if(_left, [&known](ObjectGuid const& guid) { return !std::binary_search(known.begin(), known.end(), guid); });
+                return _left;
+            }
+
+            std::size_t GetVisitedCount() const { return _visited.size(); }
+
+        private:
+            std::vector<ObjectGuid> _visited;
+            std::vector<ObjectGuid> _known;
+            std::vector<ObjectGuid> _left;
+            std::size_t _sortedCount = 0;             // size of the sorted prefix of _visited
+    };
+}
+
+#endif
@@ -240,10 +240,15 @@ void Transport::Update(uint32 diff)
 
 void Transport::DelayedUpdate(uint32 /*diff*/)
 {
-    if (GetKeyFrames().size() <= 1)
+    if (GetKeyFrames().size() <= 1 || !_delayedTeleport)
         return;
 
-    DelayedTeleportTransport();
+    // map change adds transport to another map, which may be in its own delayed update right now
+    sMapMgr->AddDelayedCrossMapOperation([map = GetMap(), guid = GetGUID()]()
+    {
+        if (Transport* transport = map->GetTransport(guid))
+            transport->DelayedTeleportTransport();
+    });
 }
 
 void Transport::AddPassenger(WorldObject* passenger)
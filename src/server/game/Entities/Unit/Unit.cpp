@@ -10009,6 +10009,12 @@ void Unit::AIUpdateTick(uint32 diff)
 {
     if (UnitAI* ai = GetAI())
     {
+        //npcbot: bot AI time is reported separately by map tick profiler
+        Optional<MapTickProfiler::Scope> botProfile;
+        if (IsNPCBotOrPet())
+            botProfile.emplace(GetMap()->GetTickProfiler(), MAP_TICK_PHASE_BOT_AI);
+        //end npcbot
+
         m_aiLocked = true;
         ai->UpdateAI(diff);
         m_aiLocked = false;
@@ -17,6 +17,8 @@
 
 #include "GridNotifiers.h"
 #include "GridNotifiersImpl.h"
+#include "MapUpdateLod.h"
+#include "MapUpdatePartition.h"
 #include "WorldPacket.h"
 #include "WorldSession.h"
 #include "UpdateData.h"
@@ -26,17 +28,38 @@
 
 using namespace Trinity;
 
+VisibleNotifier::VisibleNotifier(Player &player) : i_player(player), i_viewPoint(player.GetViewpoint()), i_sightRange(player.GetSightRange())
+{
+    if (!i_viewPoint)
+        i_viewPoint = &player;
+
+    // borrow buffers of previous passes, nested passes for the same player just start with empty ones
+    std::swap(i_diff, player.m_visibilityPassDiff);
+    std::swap(i_visibleNow, player.m_visibilityPassVisibleNow);
+    i_diff.Clear();
+    i_diff.SetKnown(player.m_clientGUIDs);
+    i_visibleNow.clear();
+}
+
+VisibleNotifier::~VisibleNotifier()
+{
+    std::swap(i_diff, i_player.m_visibilityPassDiff);
+    std::swap(i_visibleNow, i_player.m_visibilityPassVisibleNow);
+}
+
 void VisibleNotifier::SendToSelf()
 {
     // at this moment i_clientGUIDs have guids that not iterate at grid level checks
     // but exist one case when this possible and object not out of range: transports
     if (Transport* transport = i_player.GetTransport())
     {
+        // passengers are unique, the ones added below never need to be looked up again
+        i_diff.SortVisited();
         for (Transport::PassengerSet::const_iterator itr = transport->GetPassengers().begin(); itr != transport->GetPassengers().end(); ++itr)
         {
-            if (vis_guids.find((*itr)->GetGUID()) != vis_guids.end())
+            if (i_player.HaveAtClient(*itr) && !i_diff.IsVisited((*itr)->GetGUID()))
             {
-                vis_guids.erase((*itr)->GetGUID());
+                i_diff.AddVisited((*itr)->GetGUID());
 
                 switch ((*itr)->GetTypeId())
                 {
@@ -61,14 +84,14 @@ void VisibleNotifier::SendToSelf()
         }
     }
 
-    for (auto it = vis_guids.begin(); it != vis_guids.end(); ++it)
+    for (ObjectGuid const& guid : i_diff.ComputeLeft(i_player.m_clientGUIDs))
     {
-        i_player.m_clientGUIDs.erase(*it);
-        i_data.AddOutOfRangeGUID(*it);
+        i_player.m_clientGUIDs.erase(guid);
+        i_data.AddOutOfRangeGUID(guid);
 
-        if (it->IsPlayer())
+        if (guid.IsPlayer())
         {
-            Player* player = ObjectAccessor::FindPlayer(*it);
+            Player* player = ObjectAccessor::FindPlayer(guid);
             if (player && !player->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
                 player->UpdateVisibilityOf(&i_player);
         }
@@ -81,8 +104,8 @@ void VisibleNotifier::SendToSelf()
     i_data.BuildPacket(&packet);
     i_player.SendDirectMessage(&packet);
 
-    for (std::set<Unit*>::const_iterator it = i_visibleNow.begin(); it != i_visibleNow.end(); ++it)
-        i_player.SendInitialVisiblePackets(*it);
+    for (Unit* unit : i_visibleNow)
+        i_player.SendInitialVisiblePackets(unit);
 }
 
 void VisibleChangesNotifier::Visit(PlayerMapType &m)
@@ -146,7 +169,7 @@ void PlayerRelocationNotifier::Visit(PlayerMapType &m)
     {
         Player* player = iter->GetSource();
 
-        vis_guids.erase(player->GetGUID());
+        i_diff.AddVisited(player->GetGUID());
 
         i_player.UpdateVisibilityOf(player, i_data, i_visibleNow);
 
@@ -161,11 +184,24 @@ void PlayerRelocationNotifier::Visit(CreatureMapType &m)
 {
     bool relocated_for_ai = (&i_player == i_player.m_seer);
 
-    for (CreatureMapType::iterator iter=m.begin(); iter != m.end(); ++iter)
+    // creatures look for the player with their own sight distance, batch range covers both directions
+    bool const cull = !relocated_for_ai || i_viewPoint == &i_player;
+    float const range = i_sightRange + i_viewPoint->GetCombatReach() + VisitCandidates::RANGE_TOLERANCE;
+    float const playerReach = i_player.GetCombatReach() + VisitCandidates::RANGE_TOLERANCE;
+    i_candidates.Gather(m, i_viewPoint, [range, playerReach, relocated_for_ai](Creature const* c)
     {
-        Creature* c = iter->GetSource();
+        return std::max(range, relocated_for_ai ? c->m_SightDistance + playerReach : 0.0f) + c->GetCombatReach();
+    });
+
+    for (std::size_t i = 0; i < i_candidates.Objects.size(); ++i)
+    {
+        Creature* c = static_cast<Creature*>(i_candidates.Objects[i]);
+
+        if (cull && !i_candidates.InRange[i] && !i_player.HaveAtClient(c)
+            && !i_player.IsVisibilityDistanceIndependent(c) && (!relocated_for_ai || !c->IsVisibilityDistanceIndependent(&i_player)))
+            continue;
 
-        vis_guids.erase(c->GetGUID());
+        i_diff.AddVisited(c->GetGUID());
 
         i_player.UpdateVisibilityOf(c, i_data, i_visibleNow);
 
@@ -192,9 +228,20 @@ void CreatureRelocationNotifier::Visit(CreatureMapType &m)
     if (!i_creature.IsAlive())
         return;
 
-    for (CreatureMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
+    float const reach = i_creature.GetCombatReach() + VisitCandidates::RANGE_TOLERANCE;
+    i_candidates.Gather(m, &i_creature, [this, reach](Creature const* c)
     {
-        Creature* c = iter->GetSource();
+        return std::max(i_creature.m_SightDistance, c->m_SightDistance) + reach + c->GetCombatReach();
+    });
+
+    for (std::size_t i = 0; i < i_candidates.Objects.size(); ++i)
+    {
+        Creature* c = static_cast<Creature*>(i_candidates.Objects[i]);
+
+        // both sides can only notice each other within their sight distance
+        if (!i_candidates.InRange[i] && (!c->IsAlive() || (!i_creature.IsVisibilityDistanceIndependent(c) && !c->IsVisibilityDistanceIndependent(&i_creature))))
+            continue;
+
         CreatureUnitRelocationWorker(&i_creature, c);
 
         if (!c->isNeedNotify(NOTIFY_VISIBILITY_CHANGED))
@@ -425,8 +472,29 @@ template<class T>
 void ObjectUpdater::Visit(GridRefManager<T> &m)
 {
     for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
-        if (iter->GetSource()->IsInWorld())
-            iter->GetSource()->Update(i_timeDiff);
+    {
+        T* obj = iter->GetSource();
+        if (i_region && obj->IsInWorld() && !i_region->CanUpdateInParallel(obj))
+        {
+            i_region->MergeUpdates.push_back(obj);
+            continue;
+        }
+
+        Update(obj);
+    }
+}
+
+template<class T>
+void ObjectUpdater::Update(T* obj)
+{
+    if (!obj->IsInWorld())
+        return;
+
+    uint32 diff = i_timeDiff;
+    if (i_lod && !i_lod->ShouldUpdate(obj, diff))
+        return;
+
+    obj->Update(diff);
 }
 
 bool AnyDeadUnitObjectInRangeCheck::operator()(Player* u)
@@ -462,3 +530,6 @@ bool AnyDeadUnitSpellTargetInRangeCheck::operator()(Creature* u)
 template void ObjectUpdater::Visit<Creature>(CreatureMapType&);
 template void ObjectUpdater::Visit<GameObject>(GameObjectMapType&);
 template void ObjectUpdater::Visit<DynamicObject>(DynamicObjectMapType&);
+template void ObjectUpdater::Update<Creature>(Creature*);
+template void ObjectUpdater::Update<GameObject>(GameObject*);
+template void ObjectUpdater::Update<DynamicObject>(DynamicObject*);
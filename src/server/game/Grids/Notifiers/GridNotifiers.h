@@ -25,21 +25,57 @@
 #include "GameObject.h"
 #include "Group.h"
 #include "Player.h"
+#include "PositionBatch.h"
 #include "Spell.h"
 #include "SpellInfo.h"
 #include "UnitAI.h"
 #include "UpdateData.h"
+#include "WorldPacket.h"
+
+class MapUpdateLod;
+struct MapUpdateRegion;
 
 namespace Trinity
 {
+    // Objects of a visited cell container and their positions, far candidates are culled
+    // with a single batched distance pass before the per object visibility checks
+    struct VisitCandidates
+    {
+        // CanSeeOrDetect compares distances in doubles and adds combat reach of both sides
+        static constexpr float RANGE_TOLERANCE = 1.0f;
+
+        std::vector<WorldObject*> Objects;
+        PositionBatch Positions;
+        std::vector<uint8> InRange;
+
+        template<class T, class RangeGetter>
+        void Gather(GridRefManager<T> &m, WorldObject const* center, RangeGetter&& getRange)
+        {
+            Objects.clear();
+            Positions.Clear();
+            for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+            {
+                T* obj = iter->GetSource();
+                Objects.push_back(obj);
+                Positions.Add(obj->GetPositionX(), obj->GetPositionY(), getRange(obj));
+            }
+
+            Positions.FilterInRange(center->GetPositionX(), center->GetPositionY(), InRange);
+        }
+    };
+
     struct TC_GAME_API VisibleNotifier
     {
         Player &i_player;
         UpdateData i_data;
-        std::set<Unit*> i_visibleNow;
-        GuidUnorderedSet vis_guids;
-
-        VisibleNotifier(Player &player) : i_player(player), vis_guids(player.m_clientGUIDs) { }
+        std::vector<Unit*> i_visibleNow;
+        VisibilityDiff i_diff;
+        WorldObject const* i_viewPoint;
+        float i_sightRange;
+        VisitCandidates i_candidates;
+
+        VisibleNotifier(Player &player);
+        ~VisibleNotifier();
         template<class T> void Visit(GridRefManager<T> &m);
         void SendToSelf(void);
     };
@@ -67,6 +103,7 @@ namespace Trinity
     struct TC_GAME_API CreatureRelocationNotifier
     {
         Creature &i_creature;
+        VisitCandidates i_candidates;
         CreatureRelocationNotifier(Creature &c) : i_creature(c) { }
         template<class T> void Visit(GridRefManager<T> &) { }
         void Visit(CreatureMapType &);
@@ -117,7 +154,7 @@ namespace Trinity
     struct TC_GAME_API MessageDistDeliverer
     {
         WorldObject const* i_source;
-        WorldPacket const* i_message;
+        SharedWorldPacket i_message;
         uint32 i_phaseMask;
         float i_distSq;
         uint32 team;
@@ -155,7 +192,7 @@ namespace Trinity
     struct TC_GAME_API MessageDistDelivererToHostile
     {
         Unit* i_source;
-        WorldPacket const* i_message;
+        SharedWorldPacket i_message;
         uint32 i_phaseMask;
         float i_distSq;
 
@@ -182,10 +219,13 @@ namespace Trinity
     struct ObjectUpdater
     {
         uint32 i_timeDiff;
-        explicit ObjectUpdater(const uint32 diff) : i_timeDiff(diff) { }
+        MapUpdateLod* i_lod;
+        MapUpdateRegion* i_region;  // objects reaching out of it are left for the merge of a partitioned update
+        explicit ObjectUpdater(const uint32 diff, MapUpdateLod* lod = nullptr, MapUpdateRegion* region = nullptr) : i_timeDiff(diff), i_lod(lod), i_region(region) { }
         template<class T> void Visit(GridRefManager<T> &m);
         void Visit(PlayerMapType &) { }
         void Visit(CorpseMapType &) { }
+        template<class T> void Update(T* obj);
     };
 
     // SEARCHERS & LIST SEARCHERS & WORKERS
@@ -421,6 +461,9 @@ namespace Trinity
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
 
+        // MapUnitSnapshot visit, returns false when search is done
+        bool VisitUnit(Unit* unit);
+
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) { }
     };
 
@@ -437,6 +480,7 @@ namespace Trinity
 
         void Visit(CreatureMapType &m);
         void Visit(PlayerMapType &m);
+        bool VisitUnit(Unit* unit);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) { }
     };
@@ -455,6 +499,7 @@ namespace Trinity
 
         void Visit(PlayerMapType &m);
         void Visit(CreatureMapType &m);
+        bool VisitUnit(Unit* unit);
 
         template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED> &) { }
     };
@@ -1650,6 +1695,7 @@ namespace Trinity
         private:
             Builder& i_builder;
             std::vector<WorldPacket*> i_data_cache;         // 0 = default, i => i-1 locale index
+            std::vector<SharedWorldPacket> i_shared_cache;  // payloads shared by all receivers of a locale, same indexes
     };
 
     // Prepare using Builder localized packets with caching and send to player
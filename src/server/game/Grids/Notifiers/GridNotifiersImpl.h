@@ -30,10 +30,19 @@
 template<class T>
 inline void Trinity::VisibleNotifier::Visit(GridRefManager<T> &m)
 {
-    for (typename GridRefManager<T>::iterator iter = m.begin(); iter != m.end(); ++iter)
+    float const range = i_sightRange + i_viewPoint->GetCombatReach() + VisitCandidates::RANGE_TOLERANCE;
+    i_candidates.Gather(m, i_viewPoint, [range](T const* target) { return range + target->GetCombatReach(); });
+
+    for (std::size_t i = 0; i < i_candidates.Objects.size(); ++i)
     {
-        vis_guids.erase(iter->GetSource()->GetGUID());
-        i_player.UpdateVisibilityOf(iter->GetSource(), i_data, i_visibleNow);
+        T* target = static_cast<T*>(i_candidates.Objects[i]);
+
+        // objects out of sight range that are not at client can't become visible
+        if (!i_candidates.InRange[i] && !i_player.HaveAtClient(target) && !i_player.IsVisibilityDistanceIndependent(target))
+            continue;
+
+        i_diff.AddVisited(target->GetGUID());
+        i_player.UpdateVisibilityOf(target, i_data, i_visibleNow);
     }
 }
 
@@ -377,6 +386,25 @@ void Trinity::UnitSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+bool Trinity::UnitSearcher<Check>::VisitUnit(Unit* unit)
+{
+    // already found
+    if (i_object)
+        return false;
+
+    if (!unit->InSamePhase(i_phaseMask))
+        return true;
+
+    if (i_check(unit))
+    {
+        i_object = unit;
+        return false;
+    }
+
+    return true;
+}
+
 template<class Check>
 void Trinity::UnitLastSearcher<Check>::Visit(CreatureMapType &m)
 {
@@ -403,6 +431,15 @@ void Trinity::UnitLastSearcher<Check>::Visit(PlayerMapType &m)
     }
 }
 
+template<class Check>
+bool Trinity::UnitLastSearcher<Check>::VisitUnit(Unit* unit)
+{
+    if (unit->InSamePhase(i_phaseMask) && i_check(unit))
+        i_object = unit;
+
+    return true;
+}
+
 template<class Check>
 void Trinity::UnitListSearcher<Check>::Visit(PlayerMapType &m)
 {
@@ -421,6 +458,16 @@ void Trinity::UnitListSearcher<Check>::Visit(CreatureMapType &m)
                 Insert(itr->GetSource());
 }
 
+template<class Check>
+bool Trinity::UnitListSearcher<Check>::VisitUnit(Unit* unit)
+{
+    if (unit->InSamePhase(i_phaseMask))
+        if (i_check(unit))
+            Insert(unit);
+
+    return true;
+}
+
 // Creature searchers
 
 template<class Check>
@@ -512,24 +559,25 @@ void Trinity::LocalizedPacketDo<Builder>::operator()(Player* p)
 {
     LocaleConstant loc_idx = p->GetSession()->GetSessionDbLocaleIndex();
     uint32 cache_idx = loc_idx+1;
-    WorldPacket* data;
 
     // create if not cached yet
     if (i_data_cache.size() < cache_idx + 1 || !i_data_cache[cache_idx])
     {
         if (i_data_cache.size() < cache_idx + 1)
+        {
             i_data_cache.resize(cache_idx + 1);
+            i_shared_cache.resize(cache_idx + 1);
+        }
 
-        data = new WorldPacket();
+        WorldPacket* data = new WorldPacket();
 
         i_builder(*data, loc_idx);
 
         i_data_cache[cache_idx] = data;
+        i_shared_cache[cache_idx] = SharedWorldPacket(data);
     }
-    else
-        data = i_data_cache[cache_idx];
 
-    p->SendDirectMessage(data);
+    p->SendDirectMessage(i_shared_cache[cache_idx]);
 }
 
 template<class Builder>
@@ -0,0 +1,82 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PositionBatch.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRINITY_POSITION_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+using namespace Trinity;
+
+void PositionBatch::Clear()
+{
+    _x.clear();
+    _y.clear();
+    _rangeSq.clear();
+}
+
+void PositionBatch::Add(float x, float y, float range)
+{
+    _x.push_back(x);
+    _y.push_back(y);
+    _rangeSq.push_back(range * range);
+}
+
+void PositionBatch::FilterInRange(float x, float y, std::vector<uint8>& inRange) const
+{
+    std::size_t const size = Size();
+    inRange.resize(size);
+
+    std::size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256 const centerX = _mm256_set1_ps(x);
+    __m256 const centerY = _mm256_set1_ps(y);
+    for (; i + 8 <= size; i += 8)
+    {
+        __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(&_x[i]), centerX);
+        __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(&_y[i]), centerY);
+        __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        int mask = _mm256_movemask_ps(_mm256_cmp_ps(distSq, _mm256_loadu_ps(&_rangeSq[i]), _CMP_LE_OQ));
+        for (std::size_t j = 0; j < 8; ++j)
+            inRange[i + j] = uint8((mask >> j) & 1);
+    }
+#elif defined(TRINITY_POSITION_BATCH_SSE2)
+    __m128 const centerX = _mm_set1_ps(x);
+    __m128 const centerY = _mm_set1_ps(y);
+    for (; i + 4 <= size; i += 4)
+    {
+        __m128 dx = _mm_sub_ps(_mm_loadu_ps(&_x[i]), centerX);
+        __m128 dy = _mm_sub_ps(_mm_loadu_ps(&_y[i]), centerY);
+        __m128 distSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(distSq, _mm_loadu_ps(&_rangeSq[i])));
+        for (std::size_t j = 0; j < 4; ++j)
+            inRange[i + j] = uint8((mask >> j) & 1);
+    }
+#endif
+
+    for (; i < size; ++i)
+    {
+        float dx = _x[i] - x;
+        float dy = _y[i] - y;
+        inRange[i] = uint8(dx * dx + dy * dy <= _rangeSq[i]);
+    }
+}
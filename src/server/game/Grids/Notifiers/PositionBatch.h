@@ -0,0 +1,46 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_POSITION_BATCH_H
+#define TRINITY_POSITION_BATCH_H
+
+#include "Define.h"
+#include <vector>
+
+namespace Trinity
+{
+    // Candidate positions of a grid visit stored as structure of arrays,
+    // lets notifiers drop far candidates with one vectorized pass before the per object checks
+    class TC_GAME_API PositionBatch
+    {
+        public:
+            void Clear();
+            void Add(float x, float y, float range);
+
+            std::size_t Size() const { return _x.size(); }
+
+            // inRange[i] is set when candidate i is within its own range of (x, y), 2d
+            void FilterInRange(float x, float y, std::vector<uint8>& inRange) const;
+
+        private:
+            std::vector<float> _x;
+            std::vector<float> _y;
+            std::vector<float> _rangeSq;
+    };
+}
+
+#endif
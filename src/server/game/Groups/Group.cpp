@@ -2119,6 +2119,7 @@ void Group::UpdatePlayerOutOfRange(Player* player)
 
 void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRaid, int group /*= -1*/, ObjectGuid ignoredPlayer /*= ObjectGuid::Empty*/)
 {
+    SharedWorldPacket sharedPacket(packet);
     for (GroupReference* itr = GetFirstMember(); itr != nullptr; itr = itr->next())
     {
         Player* player = itr->GetSource();
@@ -2126,7 +2127,7 @@ void Group::BroadcastPacket(WorldPacket const* packet, bool ignorePlayersInBGRai
             continue;
 
         if (player->GetSession() && (group == -1 || itr->getSubGroup() == group))
-            player->SendDirectMessage(packet);
+            player->SendDirectMessage(sharedPacket);
     }
 }
 
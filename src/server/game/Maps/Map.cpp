@@ -31,6 +31,7 @@
 #include "Log.h"
 #include "MapInstanced.h"
 #include "MapManager.h"
+#include "MapUpdatePartition.h"
 #include "Metric.h"
 #include "MiscPackets.h"
 #include "MMapFactory.h"
@@ -38,10 +39,15 @@
 #include "ObjectAccessor.h"
 #include "ObjectGridLoader.h"
 #include "ObjectMgr.h"
+#include "LineOfSightCache.h"
+#include "PathCache.h"
+#include "PathRequestQueue.h"
 #include "Pet.h"
 #include "PoolMgr.h"
 #include "ScriptMgr.h"
+#include "ThreadPool.h"
 #include "Transport.h"
+#include "UpdateData.h"
 #include "Vehicle.h"
 #include "VMapFactory.h"
 #ifdef ELUNA
@@ -52,6 +58,9 @@
 #include "WeatherMgr.h"
 #include "World.h"
 #include <boost/heap/fibonacci_heap.hpp>
+#include <G3D/AABox.h>
+#include <future>
+#include <type_traits>
 #include <unordered_set>
 #include <vector>
 
@@ -192,6 +201,8 @@ void Map::LoadVMap(int gx, int gy)
     {
         case VMAP::VMAP_LOAD_RESULT_OK:
             TC_LOG_DEBUG("maps", "VMAP loaded name:{}, id:{}, x:{}, y:{} (vmap rep.: x:{}, y:{})", GetMapName(), GetId(), gx, gy, gx, gy);
+            // results cached while the tile was missing saw no static geometry
+            InvalidateLineOfSightCache(gx, gy);
             break;
         case VMAP::VMAP_LOAD_RESULT_ERROR:
             TC_LOG_ERROR("maps", "Could not load VMAP name:{}, id:{}, x:{}, y:{} (vmap rep.: x:{}, y:{})", GetMapName(), GetId(), gx, gy, gx, gy);
@@ -202,6 +213,17 @@ void Map::LoadVMap(int gx, int gy)
     }
 }
 
+void Map::InvalidateLineOfSightCache(int gx, int gy)
+{
+    if (!_losCache)
+        return;
+
+    // inverse of Map::GetGrid, GridMaps[gx][gy] covers x in ((31 - gx) * SIZE_OF_GRIDS, (32 - gx) * SIZE_OF_GRIDS]
+    G3D::Vector3 low((CENTER_GRID_ID - 1 - gx) * SIZE_OF_GRIDS, (CENTER_GRID_ID - 1 - gy) * SIZE_OF_GRIDS, INVALID_HEIGHT);
+    G3D::Vector3 high((CENTER_GRID_ID - gx) * SIZE_OF_GRIDS, (CENTER_GRID_ID - gy) * SIZE_OF_GRIDS, MAX_HEIGHT);
+    _losCache->Invalidate(G3D::AABox(low, high));
+}
+
 void Map::LoadMap(int gx, int gy, bool reload)
 {
     if (i_InstanceId != 0)
@@ -277,13 +299,13 @@ void Map::DeleteStateMachine()
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId, uint8 SpawnMode, Map* _parent):
-_creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMoveLock(false),
+_creatureToMoveLock(false), _gameObjectsToMoveLock(false), _dynamicObjectsToMoveLock(false), _partitionedUpdate(false),
 i_mapEntry(sMapStore.LookupEntry(id)), i_spawnMode(SpawnMode), i_InstanceId(InstanceId),
-m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE),
+m_unloadTimer(0), m_VisibleDistance(DEFAULT_VISIBILITY_DISTANCE), _unitSnapshot(*this),
 m_VisibilityNotifyPeriod(DEFAULT_VISIBILITY_NOTIFY_PERIOD),
 m_activeNonPlayersIter(m_activeNonPlayers.end()), _transportsUpdateIter(_transports.end()),
 i_gridExpiry(expiry),
-i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0)
+i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _respawnCheckTimer(0), _updateCost(0)
 {
     m_parentMap = (_parent ? _parent : this);
     for (unsigned int idx=0; idx < MAX_NUMBER_OF_GRIDS; ++idx)
@@ -304,6 +326,19 @@ i_scriptLock(false), _respawnTimes(std::make_unique<RespawnListContainer>()), _r
     _weatherUpdateTimer.SetInterval(time_t(1 * IN_MILLISECONDS));
 
     MMAP::MMapFactory::createOrGetMMapManager()->loadMapInstance(sWorld->GetDataPath(), GetId(), GetInstanceId());
+
+    if (uint32 pathCacheSize = sWorld->getIntConfig(CONFIG_MMAP_PATH_CACHE_SIZE))
+        if (DisableMgr::IsPathfindingEnabled(GetId()))
+            _pathCache = std::make_unique<PathCache>(pathCacheSize);
+
+    if (sMapMgr->GetPathfindingPool() && DisableMgr::IsPathfindingEnabled(GetId()))
+        _pathRequests = std::make_unique<PathRequestQueue>();
+
+    if (uint32 losCacheSize = sWorld->getIntConfig(CONFIG_VMAP_LOS_CACHE_SIZE))
+    {
+        _losCache = std::make_unique<LineOfSightCache>(losCacheSize, sWorld->getIntConfig(CONFIG_VMAP_LOS_CACHE_TTL));
+        _dynamicTree.setLineOfSightCache(_losCache.get());
+    }
 }
 
 void Map::InitVisibilityDistance()
@@ -322,6 +357,9 @@ void Map::AddToGrid(T* obj, Cell const& cell)
         grid->GetGridType(cell.CellX(), cell.CellY()).template AddWorldObject<T>(obj);
     else
         grid->GetGridType(cell.CellX(), cell.CellY()).template AddGridObject<T>(obj);
+
+    if constexpr (std::is_same_v<T, Player>)
+        _unitSnapshot.InvalidateCell(cell.GetCellCoord());
 }
 
 template<>
@@ -334,6 +372,8 @@ void Map::AddToGrid(Creature* obj, Cell const& cell)
         grid->GetGridType(cell.CellX(), cell.CellY()).AddGridObject(obj);
 
     obj->SetCurrentCell(cell);
+
+    _unitSnapshot.InvalidateCell(cell.GetCellCoord());
 }
 
 template<>
@@ -552,7 +592,7 @@ bool Map::EnsureGridLoaded(Cell const& cell)
         ObjectGridLoader loader(*grid, this, cell);
         loader.LoadN();
 
-        Balance();
+        _unitSnapshot.Invalidate();
         return true;
     }
 
@@ -636,6 +676,7 @@ void Map::InitializeObject(GameObject* obj)
 template<class T>
 bool Map::AddToMap(T* obj)
 {
+    auto lock = LockForPartitionedUpdate();
     /// @todo Needs clean up. An object should not be added to map twice.
     if (obj->IsInWorld())
     {
@@ -751,6 +792,212 @@ void Map::VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::Obj
     }
 }
 
+bool Map::UpdateRegions(uint32 t_diff)
+{
+    Trinity::ThreadPool* pool = sMapMgr->GetPartitionPool();
+    if (!pool || Instanceable() || m_mapRefManager.getSize() < 2)
+        return false;
+
+    // players are updated first so regions are built from their final positions
+    std::vector<WorldObject*> roots;
+    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
+    {
+        Player* player = m_mapRefIter->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_PLAYERS);
+        player->Update(t_diff);
+    }
+
+    for (MapRefManager::iterator itr = m_mapRefManager.begin(); itr != m_mapRefManager.end(); ++itr)
+    {
+        Player* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        roots.push_back(player);
+        if (WorldObject* viewPoint = player->GetViewpoint())
+            roots.push_back(viewPoint);
+    }
+
+    for (WorldObject* obj : m_activeNonPlayers)
+        if (obj && obj->IsInWorld())
+            roots.push_back(obj);
+
+    std::vector<MapUpdateRegion> regions;
+    MapUpdatePartition::BuildRegions(this, roots, std::max(sWorld->getFloatConfig(CONFIG_MAP_UPDATE_PARTITION_MARGIN), GetVisibilityRange()), regions);
+    if (regions.size() < 2)
+        return true;
+
+    // only cells around roots at the time of the split are visited here, objects that moved
+    // are picked up by the regular serial pass in Map::Update
+    auto updateRegion = [this, t_diff](MapUpdateRegion& region)
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_CELLS);
+
+        Trinity::ObjectUpdater updater(t_diff, _updateLod.IsEnabled() ? &_updateLod : nullptr, &region);
+        TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> gridVisitor(updater);
+        TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> worldVisitor(updater);
+
+        for (CellArea const& area : region.RootAreas)
+        {
+            for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            {
+                for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                {
+                    if (!region.MarkCell(x, y))
+                        continue;
+
+                    Cell cell(CellCoord(x, y));
+                    cell.SetNoCreate();
+                    Visit(cell, gridVisitor);
+                    Visit(cell, worldVisitor);
+                }
+            }
+        }
+    };
+
+    _unitSnapshot.Suspend();
+    _partitionedUpdate = true;
+
+    // update packets built by pool threads are accounted to this map tick
+    std::vector<UpdateDataCompressionStats> regionCompressionStats(regions.size());
+
+    std::vector<std::future<void>> pendingRegions;
+    pendingRegions.reserve(regions.size() - 1);
+    for (std::size_t i = 1; i < regions.size(); ++i)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>([&updateRegion, region = &regions[i], stats = &regionCompressionStats[i]]()
+        {
+            UpdateDataCompressionStats const compressionStart = UpdateData::GetThreadCompressionStats();
+            updateRegion(*region);
+            *stats = UpdateData::GetThreadCompressionStats() - compressionStart;
+        });
+        pendingRegions.push_back(task->get_future());
+        pool->PostWork([task]() { (*task)(); });
+    }
+
+    updateRegion(regions.front());
+
+    for (std::future<void>& pending : pendingRegions)
+        pending.get();
+
+    for (UpdateDataCompressionStats const& stats : regionCompressionStats)
+        UpdateData::AddThreadCompressionStats(stats);
+
+    _partitionedUpdate = false;
+    _unitSnapshot.Resume();
+
+    // merge: what the regions queued for other regions or for shared state is applied single threaded,
+    // then objects whose update reaches into another region get their update
+    std::vector<std::function<void()>> mergeActions;
+    std::swap(mergeActions, _partitionMergeActions);
+    _partitionModelPresence.clear();
+    for (std::function<void()> const& action : mergeActions)
+        action();
+
+    Trinity::ObjectUpdater updater(t_diff, _updateLod.IsEnabled() ? &_updateLod : nullptr);
+    uint64 mergeUpdates = 0;
+    for (MapUpdateRegion& region : regions)
+    {
+        region.ForEachVisitedCell([this](uint32 x, uint32 y) { markCell(y * TOTAL_NUMBER_OF_CELLS_PER_MAP + x); });
+
+        mergeUpdates += region.MergeUpdates.size();
+        for (WorldObject* obj : region.MergeUpdates)
+        {
+            switch (obj->GetTypeId())
+            {
+                case TYPEID_UNIT:
+                    updater.Update(obj->ToCreature());
+                    break;
+                case TYPEID_GAMEOBJECT:
+                    updater.Update(obj->ToGameObject());
+                    break;
+                case TYPEID_DYNAMICOBJECT:
+                    updater.Update(obj->ToDynObject());
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    TC_METRIC_VALUE("map_update_regions", uint64(regions.size()),
+        TC_METRIC_TAG("map_id", std::to_string(GetId())),
+        TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+    TC_METRIC_VALUE("map_update_region_merges", uint64(mergeActions.size()) + mergeUpdates,
+        TC_METRIC_TAG("map_id", std::to_string(GetId())),
+        TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+    return true;
+}
+
+bool Map::DeferToPartitionMerge(std::function<void()> action)
+{
+    if (!_partitionedUpdate)
+        return false;
+
+    std::lock_guard<std::recursive_mutex> lock(_partitionLock);
+    _partitionMergeActions.push_back(std::move(action));
+    return true;
+}
+
+void Map::RemoveGameObjectModel(GameObjectModel const& model)
+{
+    if (_partitionedUpdate)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_partitionLock);
+        _partitionModelPresence[&model] = false;
+        _partitionMergeActions.push_back([this, model = &model]() { _dynamicTree.remove(*model); });
+        return;
+    }
+
+    _dynamicTree.remove(model);
+}
+
+void Map::InsertGameObjectModel(GameObjectModel const& model)
+{
+    if (_partitionedUpdate)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_partitionLock);
+        _partitionModelPresence[&model] = true;
+        _partitionMergeActions.push_back([this, model = &model]() { _dynamicTree.insert(*model); });
+        return;
+    }
+
+    _dynamicTree.insert(model);
+}
+
+void Map::UpdateGameObjectModelPosition(GameObjectModel const& model)
+{
+    if (DeferToPartitionMerge([this, model = &model]() { _dynamicTree.move(*model); }))
+        return;
+
+    _dynamicTree.move(model);
+}
+
+void Map::UpdateGameObjectModelCollision(GameObjectModel const& model)
+{
+    if (DeferToPartitionMerge([this, model = &model]() { _dynamicTree.collisionChanged(*model); }))
+        return;
+
+    _dynamicTree.collisionChanged(model);
+}
+
+bool Map::ContainsGameObjectModel(GameObjectModel const& model) const
+{
+    if (_partitionedUpdate)
+    {
+        std::lock_guard<std::recursive_mutex> lock(_partitionLock);
+        auto itr = _partitionModelPresence.find(&model);
+        if (itr != _partitionModelPresence.end())
+            return itr->second;
+    }
+
+    return _dynamicTree.contains(model);
+}
+
 void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 {
     // Nothing to do if no change
@@ -768,23 +1015,45 @@ void Map::UpdatePlayerZoneStats(uint32 oldZone, uint32 newZone)
 
 void Map::Update(uint32 t_diff)
 {
-    _dynamicTree.update(t_diff);
+    UpdateDataCompressionStats const compressionStart = UpdateData::GetThreadCompressionStats();
+
+    _tickProfiler.BeginTick();
+
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_DYNAMIC_TREE);
+        DynamicMapTreeStats const treeStats = _dynamicTree.getStats();
+        if (treeStats.Inserts || treeStats.Removes || treeStats.Moves)
+        {
+            TC_METRIC_VALUE("map_dynamic_tree_update_time", treeStats.UpdateTime / 1000,
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+            TC_METRIC_VALUE("map_dynamic_tree_moves", treeStats.Moves,
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+            _dynamicTree.resetStats();
+        }
+    }
+
     /// update worldsessions for existing players
-    for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
     {
-        Player* player = m_mapRefIter->GetSource();
-        if (player && player->IsInWorld())
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_SESSIONS);
+        for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
         {
-            //player->Update(t_diff);
-            WorldSession* session = player->GetSession();
-            MapSessionFilter updater(session);
-            session->Update(t_diff, updater);
+            Player* player = m_mapRefIter->GetSource();
+            if (player && player->IsInWorld())
+            {
+                //player->Update(t_diff);
+                WorldSession* session = player->GetSession();
+                MapSessionFilter updater(session);
+                session->Update(t_diff, updater);
+            }
         }
     }
 
     /// process any due respawns
     if (_respawnCheckTimer <= t_diff)
     {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_RESPAWNS);
         ProcessRespawns();
         _respawnCheckTimer = sWorld->getIntConfig(CONFIG_RESPAWN_MINCHECKINTERVALMS);
     }
@@ -794,7 +1063,15 @@ void Map::Update(uint32 t_diff)
     /// update active cells around players and active objects
     resetMarkedCells();
 
-    Trinity::ObjectUpdater updater(t_diff);
+    _unitSnapshot.BeginTick();
+    _updateLod.BeginTick(*this);
+
+    Optional<MapTickProfiler::Scope> objectsProfile(std::in_place, _tickProfiler, MAP_TICK_PHASE_OBJECTS);
+
+    // busy continents update distant groups of players in parallel, the loop below only handles what is left
+    bool const playersUpdated = UpdateRegions(t_diff);
+
+    Trinity::ObjectUpdater updater(t_diff, _updateLod.IsEnabled() ? &_updateLod : nullptr);
     // for creature
     TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer  > grid_object_update(updater);
     // for pets
@@ -810,7 +1087,13 @@ void Map::Update(uint32 t_diff)
             continue;
 
         // update players at tick
-        player->Update(t_diff);
+        if (!playersUpdated)
+        {
+            MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_PLAYERS);
+            player->Update(t_diff);
+        }
+
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_CELLS);
 
         VisitNearbyCellsOf(player, grid_object_update, world_object_update);
 
@@ -866,6 +1149,7 @@ void Map::Update(uint32 t_diff)
         if (!obj || !obj->IsInWorld())
             continue;
 
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_CELLS);
         VisitNearbyCellsOf(obj, grid_object_update, world_object_update);
     }
 
@@ -877,14 +1161,36 @@ void Map::Update(uint32 t_diff)
         if (!obj->IsInWorld())
             continue;
 
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_TRANSPORTS);
         obj->Update(t_diff);
     }
 
-    SendObjectUpdates();
+    objectsProfile.reset();
+
+    // paths requested by movement generators during this update, used by them on next update
+    if (_pathRequests)
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_PATH_REQUESTS);
+        if (uint32 pathRequests = _pathRequests->Process(*sMapMgr->GetPathfindingPool(), sMapMgr->GetPathfindingThreads()))
+        {
+            TC_METRIC_VALUE("map_path_requests", uint64(pathRequests),
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+        }
+    }
+
+    _unitSnapshot.EndTick();
+    _updateLod.EndTick(*this);
+
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_OBJECT_UPDATES);
+        SendObjectUpdates();
+    }
 
     ///- Process necessary scripts
     if (!m_scriptSchedule.empty())
     {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_SCRIPTS);
         i_scriptLock = true;
         ScriptsProcess();
         i_scriptLock = false;
@@ -900,13 +1206,24 @@ void Map::Update(uint32 t_diff)
         _weatherUpdateTimer.Reset();
     }
 
-    MoveAllCreaturesInMoveList();
-    MoveAllGameObjectsInMoveList();
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_MOVE_LISTS);
+        MoveAllCreaturesInMoveList();
+        MoveAllGameObjectsInMoveList();
+    }
 
     if (!m_mapRefManager.isEmpty() || !m_activeNonPlayers.empty())
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_RELOCATION_NOTIFIES);
         ProcessRelocationNotifies(t_diff);
+    }
+
+    {
+        MapTickProfiler::Scope profile(_tickProfiler, MAP_TICK_PHASE_SCRIPT_HOOKS);
+        sScriptMgr->OnMapUpdate(this, t_diff);
+    }
 
-    sScriptMgr->OnMapUpdate(this, t_diff);
+    _tickProfiler.EndTick(*this);
 
     TC_METRIC_VALUE("map_creatures", uint64(GetObjectsStore().Size<Creature>()),
         TC_METRIC_TAG("map_id", std::to_string(GetId())),
@@ -915,6 +1232,45 @@ void Map::Update(uint32 t_diff)
     TC_METRIC_VALUE("map_gameobjects", uint64(GetObjectsStore().Size<GameObject>()),
         TC_METRIC_TAG("map_id", std::to_string(GetId())),
         TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+    if (_pathCache)
+    {
+        PathCacheStats pathCacheStats = _pathCache->ConsumeStats();
+        if (pathCacheStats.Hits || pathCacheStats.Misses)
+        {
+            TC_METRIC_VALUE("map_path_cache_hits", uint64(pathCacheStats.Hits),
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+            TC_METRIC_VALUE("map_path_cache_misses", uint64(pathCacheStats.Misses),
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+            TC_METRIC_VALUE("map_path_cache_evictions", uint64(pathCacheStats.Evictions),
+                TC_METRIC_TAG("map_id", std::to_string(GetId())),
+                TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+        }
+    }
+
+    UpdateDataCompressionStats const compression = UpdateData::GetThreadCompressionStats() - compressionStart;
+    if (compression.Packets || compression.SkippedPackets)
+    {
+        TC_METRIC_VALUE("map_update_compression_time", uint64(compression.Time.count()),
+            TC_METRIC_TAG("map_id", std::to_string(GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+        TC_METRIC_VALUE("map_update_compression_bytes_in", compression.BytesIn,
+            TC_METRIC_TAG("map_id", std::to_string(GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+        TC_METRIC_VALUE("map_update_compression_bytes_out", compression.BytesOut,
+            TC_METRIC_TAG("map_id", std::to_string(GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+
+        TC_METRIC_VALUE("map_update_compression_skipped", uint64(compression.SkippedPackets),
+            TC_METRIC_TAG("map_id", std::to_string(GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(GetInstanceId())));
+    }
 }
 
 struct ResetNotifier
@@ -1026,6 +1382,8 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
     else
         ASSERT(remove); //maybe deleted in logoutplayer when player is not in a map
 
+    _unitSnapshot.Invalidate();
+
     if (remove)
         DeleteFromWorld(player);
 }
@@ -1033,6 +1391,7 @@ void Map::RemovePlayerFromMap(Player* player, bool remove)
 template<class T>
 void Map::RemoveFromMap(T *obj, bool remove)
 {
+    auto lock = LockForPartitionedUpdate();
     bool const inWorld = obj->IsInWorld() && obj->GetTypeId() >= TYPEID_UNIT && obj->GetTypeId() <= TYPEID_GAMEOBJECT;
     obj->RemoveFromWorld();
 
@@ -1044,6 +1403,9 @@ void Map::RemoveFromMap(T *obj, bool remove)
 
     obj->RemoveFromGrid();
 
+    if (obj->isType(TYPEMASK_UNIT))
+        _unitSnapshot.Invalidate();
+
     obj->ResetMap();
 
     if (remove)
@@ -1101,6 +1463,7 @@ void Map::PlayerRelocation(Player* player, float x, float y, float z, float orie
         TC_LOG_DEBUG("maps", "Player {} relocation grid[{}, {}]cell[{}, {}]->grid[{}, {}]cell[{}, {}]", player->GetName(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 
         player->RemoveFromGrid();
+        _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
 
         if (old_cell.DiffGrid(new_cell))
             EnsureGridLoadedForActiveObject(new_cell, player);
@@ -1213,6 +1576,7 @@ void Map::DynamicObjectRelocation(DynamicObject* dynObj, float x, float y, float
 
 void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float ang)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1223,6 +1587,7 @@ void Map::AddCreatureToMoveList(Creature* c, float x, float y, float z, float an
 
 void Map::RemoveCreatureFromMoveList(Creature* c)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_creatureToMoveLock) //can this happen?
         return;
 
@@ -1232,6 +1597,7 @@ void Map::RemoveCreatureFromMoveList(Creature* c)
 
 void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, float ang)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1242,6 +1608,7 @@ void Map::AddGameObjectToMoveList(GameObject* go, float x, float y, float z, flo
 
 void Map::RemoveGameObjectFromMoveList(GameObject* go)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_gameObjectsToMoveLock) //can this happen?
         return;
 
@@ -1251,6 +1618,7 @@ void Map::RemoveGameObjectFromMoveList(GameObject* go)
 
 void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, float z, float ang)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1261,6 +1629,7 @@ void Map::AddDynamicObjectToMoveList(DynamicObject* dynObj, float x, float y, fl
 
 void Map::RemoveDynamicObjectFromMoveList(DynamicObject* dynObj)
 {
+    auto lock = LockForPartitionedUpdate();
     if (_dynamicObjectsToMoveLock) //can this happen?
         return;
 
@@ -1422,6 +1791,7 @@ bool Map::CreatureCellRelocation(Creature* c, Cell new_cell)
             TC_LOG_DEBUG("maps", "Creature {} moved in grid[{}, {}] from cell[{}, {}] to cell[{}, {}].", c->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.CellX(), new_cell.CellY());
 #endif
 
+            _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
             c->RemoveFromGrid();
             AddToGrid(c, new_cell);
         }
@@ -1444,6 +1814,7 @@ bool Map::CreatureCellRelocation(Creature* c, Cell new_cell)
         TC_LOG_DEBUG("maps", "Active creature {} moved from grid[{}, {}]cell[{}, {}] to grid[{}, {}]cell[{}, {}].", c->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 #endif
 
+        _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
         c->RemoveFromGrid();
         AddToGrid(c, new_cell);
 
@@ -1460,6 +1831,7 @@ bool Map::CreatureCellRelocation(Creature* c, Cell new_cell)
             TC_LOG_DEBUG("maps", "Creature {} moved from grid[{}, {}]cell[{}, {}] to grid[{}, {}]cell[{}, {}].", c->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
         #endif
 
+        _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
         c->RemoveFromGrid();
         EnsureGridCreated(GridCoord(new_cell.GridX(), new_cell.GridY()));
         AddToGrid(c, new_cell);
@@ -1486,6 +1858,7 @@ bool Map::GameObjectCellRelocation(GameObject* go, Cell new_cell)
             TC_LOG_DEBUG("maps", "GameObject {} moved in grid[{}, {}] from cell[{}, {}] to cell[{}, {}].", go->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.CellX(), new_cell.CellY());
 #endif
 
+            _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
             go->RemoveFromGrid();
             AddToGrid(go, new_cell);
         }
@@ -1508,6 +1881,7 @@ bool Map::GameObjectCellRelocation(GameObject* go, Cell new_cell)
         TC_LOG_DEBUG("maps", "Active GameObject {} moved from grid[{}, {}]cell[{}, {}] to grid[{}, {}]cell[{}, {}].", go->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 #endif
 
+        _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
         go->RemoveFromGrid();
         AddToGrid(go, new_cell);
 
@@ -1521,6 +1895,7 @@ bool Map::GameObjectCellRelocation(GameObject* go, Cell new_cell)
         TC_LOG_DEBUG("maps", "GameObject {} moved from grid[{}, {}]cell[{}, {}] to grid[{}, {}]cell[{}, {}].", go->GetGUID().ToString(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 #endif
 
+        _unitSnapshot.InvalidateCell(old_cell.GetCellCoord());
         go->RemoveFromGrid();
         EnsureGridCreated(GridCoord(new_cell.GridX(), new_cell.GridY()));
         AddToGrid(go, new_cell);
@@ -1727,6 +2102,8 @@ bool Map::UnloadGrid(NGridType& ngrid, bool unloadAll)
             ((MapInstanced*)m_parentMap)->RemoveGridMapReference(GridCoord(gx, gy));
 
         GridMaps[gx][gy] = nullptr;
+
+        InvalidateLineOfSightCache(gx, gy);
     }
     TC_LOG_DEBUG("maps", "Unloading grid[{}, {}] for map {} finished", x, y, GetId());
     return true;
@@ -2294,6 +2671,63 @@ float GridMap::getHeightFromUint16(float x, float y) const
     return (float)((a * x) + (b * y) + c)*_gridIntHeightMultiplier + _gridHeight;
 }
 
+template<typename T>
+void GridMap::getHeightsFrom(T const* V9, T const* V8, std::span<Position const> positions, std::span<float> heights) const
+{
+    // int formats are solved in int32 like getHeightFromUint8/16, so every point gets the exact same value as from getHeight
+    using Sample = std::conditional_t<std::is_floating_point_v<T>, float, int32>;
+
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        float x = MAP_RESOLUTION * (CENTER_GRID_ID - positions[i].GetPositionX() / SIZE_OF_GRIDS);
+        float y = MAP_RESOLUTION * (CENTER_GRID_ID - positions[i].GetPositionY() / SIZE_OF_GRIDS);
+
+        int x_int = (int)x;
+        int y_int = (int)y;
+        x -= x_int;
+        y -= y_int;
+        x_int &= (MAP_RESOLUTION - 1);
+        y_int &= (MAP_RESOLUTION - 1);
+
+        // see getHeightFromFloat for the triangle layout, all 5 points are loaded
+        // and the triangle is selected without branches so the loop body stays straight
+        T const* V9_h1_ptr = &V9[x_int * 129 + y_int];
+        Sample h1 = V9_h1_ptr[0];
+        Sample h2 = V9_h1_ptr[129];
+        Sample h3 = V9_h1_ptr[1];
+        Sample h4 = V9_h1_ptr[130];
+        Sample h5 = 2 * V8[x_int * 128 + y_int];
+
+        bool const upper = x + y < 1;
+        bool const right = x > y;
+        Sample a = upper ? (right ? h2 - h1 : h5 - h1 - h3) : (right ? h2 + h4 - h5 : h4 - h3);
+        Sample b = upper ? (right ? h5 - h1 - h2 : h3 - h1) : (right ? h4 - h2 : h3 + h4 - h5);
+        Sample c = upper ? h1 : h5 - h4;
+
+        float height;
+        if constexpr (std::is_floating_point_v<T>)
+            height = a * x + b * y + c;
+        else
+            height = (float)((a * x) + (b * y) + c) * _gridIntHeightMultiplier + _gridHeight;
+
+        heights[i] = isHole(x_int, y_int) ? INVALID_HEIGHT : height;
+    }
+}
+
+void GridMap::getHeights(std::span<Position const> positions, std::span<float> heights) const
+{
+    ASSERT(positions.size() == heights.size());
+
+    if (_gridGetHeight == &GridMap::getHeightFromFloat && m_V8 && m_V9)
+        getHeightsFrom(m_V9, m_V8, positions, heights);
+    else if (_gridGetHeight == &GridMap::getHeightFromUint16 && m_uint16_V8 && m_uint16_V9)
+        getHeightsFrom(m_uint16_V9, m_uint16_V8, positions, heights);
+    else if (_gridGetHeight == &GridMap::getHeightFromUint8 && m_uint8_V8 && m_uint8_V9)
+        getHeightsFrom(m_uint8_V9, m_uint8_V8, positions, heights);
+    else
+        std::fill(heights.begin(), heights.end(), _gridHeight);
+}
+
 bool GridMap::isHole(int row, int col) const
 {
     if (!_holes)
@@ -2488,13 +2922,105 @@ float Map::GetWaterOrGroundLevel(uint32 phasemask, float x, float y, float z, fl
     return VMAP_INVALID_HEIGHT_VALUE;
 }
 
+void Map::GetWaterOrGroundLevels(uint32 phasemask, std::span<Position const> positions, std::span<float> levels, std::span<float> grounds, float collisionHeight /*= DEFAULT_COLLISION_HEIGHT*/) const
+{
+    ASSERT(positions.size() == levels.size());
+    ASSERT(positions.size() == grounds.size());
+
+    // we need ground level (including grid height version) for proper return water level in point
+    std::vector<Position> searchPositions(positions.begin(), positions.end());
+    for (Position& pos : searchPositions)
+        pos.m_positionZ += Z_OFFSET_FIND_HEIGHT;
+
+    GetHeights(phasemask, searchPositions, grounds, true, 50.0f);
+
+    for (std::size_t i = 0; i < searchPositions.size(); ++i)
+        searchPositions[i].m_positionZ = grounds[i];
+
+    std::vector<ZLiquidStatus> statuses(positions.size());
+    std::vector<LiquidData> liquids(positions.size());
+    GetLiquidStatus(phasemask, searchPositions, MAP_ALL_LIQUIDS, statuses, liquids, collisionHeight);
+
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        switch (statuses[i])
+        {
+            case LIQUID_MAP_ABOVE_WATER:
+                levels[i] = std::max<float>(liquids[i].level, grounds[i]);
+                break;
+            case LIQUID_MAP_NO_WATER:
+                levels[i] = grounds[i];
+                break;
+            default:
+                levels[i] = liquids[i].level;
+                break;
+        }
+    }
+
+    // same as GetWaterOrGroundLevel for points without grid data
+    VisitGridRuns(positions, [&](GridMap const* gmap, std::size_t first, std::size_t count)
+    {
+        if (!gmap)
+            std::fill_n(levels.begin() + first, count, VMAP_INVALID_HEIGHT_VALUE);
+    });
+}
+
+template<class Worker>
+void Map::VisitGridRuns(std::span<Position const> positions, Worker&& worker) const
+{
+    std::size_t first = 0;
+    while (first < positions.size())
+    {
+        // same grid coordinates as GetGrid
+        int gx = (int)(CENTER_GRID_ID - positions[first].GetPositionX() / SIZE_OF_GRIDS);
+        int gy = (int)(CENTER_GRID_ID - positions[first].GetPositionY() / SIZE_OF_GRIDS);
+
+        std::size_t last = first + 1;
+        while (last < positions.size()
+            && (int)(CENTER_GRID_ID - positions[last].GetPositionX() / SIZE_OF_GRIDS) == gx
+            && (int)(CENTER_GRID_ID - positions[last].GetPositionY() / SIZE_OF_GRIDS) == gy)
+            ++last;
+
+        worker(const_cast<Map*>(this)->GetGrid(positions[first].GetPositionX(), positions[first].GetPositionY()), first, last - first);
+        first = last;
+    }
+}
+
+namespace
+{
+    float SelectTerrainHeight(float z, float gridHeight, float vmapHeight)
+    {
+        // find raw .map surface under Z coordinates
+        float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
+        if (G3D::fuzzyGe(z, gridHeight - GROUND_HEIGHT_TOLERANCE))
+            mapHeight = gridHeight;
+
+        // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
+        // vmapheight set for any under Z value or <= INVALID_HEIGHT
+        if (vmapHeight > INVALID_HEIGHT)
+        {
+            if (mapHeight > INVALID_HEIGHT)
+            {
+                // we have mapheight and vmapheight and must select more appropriate
+
+                // vmap height above map height
+                // or if the distance of the vmap height is less the land height distance
+                if (vmapHeight > mapHeight || std::fabs(mapHeight - z) > std::fabs(vmapHeight - z))
+                    return vmapHeight;
+
+                return mapHeight;                           // better use .map surface height
+            }
+
+            return vmapHeight;                              // we have only vmapHeight (if have)
+        }
+
+        return mapHeight;                               // explicitly use map data
+    }
+}
+
 float Map::GetHeight(float x, float y, float z, bool checkVMap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
 {
-    // find raw .map surface under Z coordinates
-    float mapHeight = VMAP_INVALID_HEIGHT_VALUE;
     float gridHeight = GetGridHeight(x, y);
-    if (G3D::fuzzyGe(z, gridHeight - GROUND_HEIGHT_TOLERANCE))
-        mapHeight = gridHeight;
 
     float vmapHeight = VMAP_INVALID_HEIGHT_VALUE;
     if (checkVMap)
@@ -2504,26 +3030,43 @@ float Map::GetHeight(float x, float y, float z, bool checkVMap /*= true*/, float
             vmapHeight = vmgr->getHeight(GetId(), x, y, z, maxSearchDist);
     }
 
-    // mapHeight set for any above raw ground Z or <= INVALID_HEIGHT
-    // vmapheight set for any under Z value or <= INVALID_HEIGHT
-    if (vmapHeight > INVALID_HEIGHT)
+    return SelectTerrainHeight(z, gridHeight, vmapHeight);
+}
+
+void Map::GetHeights(uint32 phasemask, std::span<Position const> positions, std::span<float> heights, bool vmap /*= true*/, float maxSearchDist /*= DEFAULT_HEIGHT_SEARCH*/) const
+{
+    ASSERT(positions.size() == heights.size());
+
+    std::vector<float> gridHeights(positions.size());
+    VisitGridRuns(positions, [&](GridMap const* gmap, std::size_t first, std::size_t count)
     {
-        if (mapHeight > INVALID_HEIGHT)
-        {
-            // we have mapheight and vmapheight and must select more appropriate
+        if (gmap)
+            gmap->getHeights(positions.subspan(first, count), std::span(gridHeights).subspan(first, count));
+        else
+            std::fill_n(gridHeights.begin() + first, count, VMAP_INVALID_HEIGHT_VALUE);
+    });
 
-            // vmap height above map height
-            // or if the distance of the vmap height is less the land height distance
-            if (vmapHeight > mapHeight || std::fabs(mapHeight - z) > std::fabs(vmapHeight - z))
-                return vmapHeight;
+    std::vector<float> vmapHeights(positions.size(), VMAP_INVALID_HEIGHT_VALUE);
+    if (vmap)
+    {
+        VMAP::VMapManager2* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+        if (vmgr->isHeightCalcEnabled())
+        {
+            std::vector<G3D::Vector3> points;
+            points.reserve(positions.size());
+            for (Position const& pos : positions)
+                points.emplace_back(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ());
 
-            return mapHeight;                           // better use .map surface height
+            vmgr->getHeights(GetId(), points, vmapHeights, maxSearchDist);
         }
-
-        return vmapHeight;                              // we have only vmapHeight (if have)
     }
 
-    return mapHeight;                               // explicitly use map data
+    for (std::size_t i = 0; i < positions.size(); ++i)
+    {
+        Position const& pos = positions[i];
+        float height = SelectTerrainHeight(pos.GetPositionZ(), gridHeights[i], vmapHeights[i]);
+        heights[i] = std::max<float>(height, GetGameObjectFloor(phasemask, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), maxSearchDist));
+    }
 }
 
 float Map::GetGridHeight(float x, float y) const
@@ -2649,6 +3192,27 @@ void Map::GetZoneAndAreaId(uint32 phaseMask, uint32& zoneid, uint32& areaid, flo
 }
 
 ZLiquidStatus Map::GetLiquidStatus(uint32 phaseMask, float x, float y, float z, uint8 ReqLiquidType, LiquidData* data, float collisionHeight) const
+{
+    return GetLiquidStatusForGrid(const_cast<Map*>(this)->GetGrid(x, y), phaseMask, x, y, z, ReqLiquidType, data, collisionHeight);
+}
+
+void Map::GetLiquidStatus(uint32 phaseMask, std::span<Position const> positions, uint8 ReqLiquidType, std::span<ZLiquidStatus> results, std::span<LiquidData> data /*= {}*/, float collisionHeight /*= DEFAULT_COLLISION_HEIGHT*/) const
+{
+    ASSERT(positions.size() == results.size());
+    ASSERT(data.empty() || positions.size() == data.size());
+
+    VisitGridRuns(positions, [&](GridMap* gmap, std::size_t first, std::size_t count)
+    {
+        for (std::size_t i = first; i < first + count; ++i)
+        {
+            Position const& pos = positions[i];
+            results[i] = GetLiquidStatusForGrid(gmap, phaseMask, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), ReqLiquidType,
+                data.empty() ? nullptr : &data[i], collisionHeight);
+        }
+    });
+}
+
+ZLiquidStatus Map::GetLiquidStatusForGrid(GridMap* gmap, uint32 phaseMask, float x, float y, float z, uint8 ReqLiquidType, LiquidData* data, float collisionHeight) const
 {
     ZLiquidStatus result = LIQUID_MAP_NO_WATER;
     VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
@@ -2717,7 +3281,7 @@ ZLiquidStatus Map::GetLiquidStatus(uint32 phaseMask, float x, float y, float z,
 
     if (useGridLiquid)
     {
-        if (GridMap* gmap = const_cast<Map*>(this)->GetGrid(x, y))
+        if (gmap)
         {
             LiquidData map_data;
             ZLiquidStatus map_result = gmap->GetLiquidStatus(x, y, z, ReqLiquidType, &map_data, collisionHeight);
@@ -2887,6 +3451,23 @@ float Map::GetWaterLevel(float x, float y) const
 }
 
 bool Map::isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
+{
+    if (!_losCache)
+        return CalculateLineOfSight(x1, y1, z1, x2, y2, z2, phasemask, checks, ignoreFlags);
+
+    LineOfSightCache::Key key = LineOfSightCache::MakeKey(x1, y1, z1, x2, y2, z2, phasemask, uint32(checks) | (uint32(ignoreFlags) << 8));
+    uint32 const now = GameTime::GetGameTimeMS();
+    bool result;
+    if (_losCache->Find(key, now, result))
+        return result;
+
+    std::chrono::steady_clock::time_point const start = std::chrono::steady_clock::now();
+    result = CalculateLineOfSight(x1, y1, z1, x2, y2, z2, phasemask, checks, ignoreFlags);
+    _losCache->Store(key, now, result, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    return result;
+}
+
+bool Map::CalculateLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const
 {
     if ((checks & LINEOFSIGHT_CHECK_VMAP)
       && !VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), x1, y1, z1, x2, y2, z2, ignoreFlags))
@@ -3213,6 +3794,7 @@ void Map::UnloadAllRespawnInfos() // delete everything from memory
 
 void Map::DeleteRespawnInfo(RespawnInfo* info, CharacterDatabaseTransaction dbTrans)
 {
+    auto lock = LockForPartitionedUpdate();
     // Delete from all relevant containers to ensure consistency
     ASSERT(info);
 
@@ -3572,6 +4154,7 @@ void Map::DelayedUpdate(uint32 t_diff)
 
 void Map::AddObjectToRemoveList(WorldObject* obj)
 {
+    auto lock = LockForPartitionedUpdate();
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
 
 #ifdef ELUNA
@@ -3588,6 +4171,7 @@ void Map::AddObjectToRemoveList(WorldObject* obj)
 
 void Map::AddObjectToSwitchList(WorldObject* obj, bool on)
 {
+    auto lock = LockForPartitionedUpdate();
     ASSERT(obj->GetMapId() == GetId() && obj->GetInstanceId() == GetInstanceId());
     // i_objectsToSwitch is iterated only in Map::RemoveAllObjectsInRemoveList() and it uses
     // the contained objects only if GetTypeId() == TYPEID_UNIT , so we can return in all other cases
@@ -3747,6 +4331,7 @@ bool Map::ActiveObjectsNearGrid(NGridType const& ngrid) const
 
 void Map::AddToActive(WorldObject* obj)
 {
+    auto lock = LockForPartitionedUpdate();
     AddToActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -3790,6 +4375,7 @@ void Map::AddToActive(WorldObject* obj)
 
 void Map::RemoveFromActive(WorldObject* obj)
 {
+    auto lock = LockForPartitionedUpdate();
     RemoveFromActiveHelper(obj);
 
     Optional<Position> respawnLocation;
@@ -4434,16 +5020,19 @@ Player* Map::GetPlayer(ObjectGuid const& guid)
 
 Corpse* Map::GetCorpse(ObjectGuid const& guid)
 {
+    auto lock = LockForPartitionedUpdate();
     return _objectsStore.Find<Corpse>(guid);
 }
 
 Creature* Map::GetCreature(ObjectGuid const& guid)
 {
+    auto lock = LockForPartitionedUpdate();
     return _objectsStore.Find<Creature>(guid);
 }
 
 Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto lock = LockForPartitionedUpdate();
     auto const bounds = GetCreatureBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -4458,6 +5047,7 @@ Creature* Map::GetCreatureBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 {
+    auto lock = LockForPartitionedUpdate();
     auto const bounds = GetGameObjectBySpawnIdStore().equal_range(spawnId);
     if (bounds.first == bounds.second)
         return nullptr;
@@ -4472,11 +5062,13 @@ GameObject* Map::GetGameObjectBySpawnId(ObjectGuid::LowType spawnId) const
 
 GameObject* Map::GetGameObject(ObjectGuid const& guid)
 {
+    auto lock = LockForPartitionedUpdate();
     return _objectsStore.Find<GameObject>(guid);
 }
 
 Pet* Map::GetPet(ObjectGuid const& guid)
 {
+    auto lock = LockForPartitionedUpdate();
     return _objectsStore.Find<Pet>(guid);
 }
 
@@ -4491,6 +5083,7 @@ Transport* Map::GetTransport(ObjectGuid const& guid)
 
 DynamicObject* Map::GetDynamicObject(ObjectGuid const& guid)
 {
+    auto lock = LockForPartitionedUpdate();
     return _objectsStore.Find<DynamicObject>(guid);
 }
 
@@ -4502,6 +5095,7 @@ void Map::UpdateIteratorBack(Player* player)
 
 void Map::SaveRespawnTime(SpawnObjectType type, ObjectGuid::LowType spawnId, uint32 entry, time_t respawnTime, uint32 gridId, CharacterDatabaseTransaction dbTrans, bool startup)
 {
+    auto lock = LockForPartitionedUpdate();
     SpawnMetadata const* data = sObjectMgr->GetSpawnMetadata(type, spawnId);
     if (!data)
     {
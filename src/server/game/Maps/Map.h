@@ -25,6 +25,9 @@
 #include "GridDefines.h"
 #include "GridRefManager.h"
 #include "MapRefManager.h"
+#include "MapTickProfiler.h"
+#include "MapUpdateLod.h"
+#include "MapUnitSnapshot.h"
 #include "MPSCQueue.h"
 #include "ObjectGuid.h"
 #include "Optional.h"
@@ -34,9 +37,11 @@
 #include "Transaction.h"
 #include "UniqueTrackablePtr.h"
 #include <bitset>
+#include <functional>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <span>
 
 class Battleground;
 class BattlegroundMap;
@@ -48,6 +53,9 @@ class InstanceSave;
 class InstanceScript;
 class MapInstanced;
 class Object;
+class LineOfSightCache;
+class PathCache;
+class PathRequestQueue;
 class Player;
 class TempSummon;
 class Transport;
@@ -239,6 +247,10 @@ class TC_GAME_API GridMap
     float getHeightFromUint8(float x, float y) const;
     float getHeightFromFlat(float x, float y) const;
 
+    // Batch version of getHeightFrom* shared by all height formats, T is the storage type of V9/V8
+    template<typename T>
+    void getHeightsFrom(T const* V9, T const* V8, std::span<Position const> positions, std::span<float> heights) const;
+
 public:
     GridMap();
     ~GridMap();
@@ -247,6 +259,8 @@ public:
 
     uint16 getArea(float x, float y) const;
     inline float getHeight(float x, float y) const {return (this->*_gridGetHeight)(x, y);}
+    // Same as getHeight for every position, height format is resolved once for the whole batch
+    void getHeights(std::span<Position const> positions, std::span<float> heights) const;
     float getMinHeight(float x, float y) const;
     float getLiquidLevel(float x, float y) const;
     ZLiquidStatus GetLiquidStatus(float x, float y, float z, uint8 ReqLiquidType, LiquidData* data = 0, float collisionHeight = 2.03128f); // DEFAULT_COLLISION_HEIGHT in Object.h
@@ -351,6 +365,10 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void VisitNearbyCellsOf(WorldObject* obj, TypeContainerVisitor<Trinity::ObjectUpdater, GridTypeMapContainer> &gridVisitor, TypeContainerVisitor<Trinity::ObjectUpdater, WorldTypeMapContainer> &worldVisitor);
         virtual void Update(uint32);
 
+        // moving average of Map::Update duration in microseconds, MapUpdater dispatches expensive maps first
+        uint32 GetUpdateCost() const { return _updateCost; }
+        void RecordUpdateCost(uint32 microseconds) { _updateCost = (_updateCost * 3 + microseconds) / 4; }
+
         float GetVisibilityRange() const { return m_VisibleDistance; }
         //function for setting up visibility distance for maps on per-type/per-Id basis
         virtual void InitVisibilityDistance();
@@ -360,6 +378,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void GameObjectRelocation(GameObject* go, float x, float y, float z, float orientation, bool respawnRelocationOnFail = true);
         void DynamicObjectRelocation(DynamicObject* go, float x, float y, float z, float orientation);
 
+        MapUnitSnapshot& GetUnitSnapshot() { return _unitSnapshot; }
+        MapTickProfiler& GetTickProfiler() { return _tickProfiler; }
+        PathCache* GetPathCache() const { return _pathCache.get(); }
+        // nullptr when paths are calculated immediately (mmap.AsyncPathfinding.Threads)
+        PathRequestQueue* GetPathRequestQueue() const { return _pathRequests.get(); }
+        LineOfSightCache* GetLineOfSightCache() const { return _losCache.get(); }
+
         template<class T, class CONTAINER>
         void Visit(Cell const& cell, TypeContainerVisitor<T, CONTAINER>& visitor);
 
@@ -401,6 +426,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void GetFullTerrainStatusForPosition(uint32 phaseMask, float x, float y, float z, PositionFullTerrainStatus& data, uint8 reqLiquidType, float collisionHeight) const;
         ZLiquidStatus GetLiquidStatus(uint32 phaseMask, float x, float y, float z, uint8 ReqLiquidType, LiquidData* data = nullptr, float collisionHeight = 2.03128f) const; // DEFAULT_COLLISION_HEIGHT in Object.h
+        // Batch version of GetLiquidStatus, data is optional and must match positions in size otherwise
+        void GetLiquidStatus(uint32 phaseMask, std::span<Position const> positions, uint8 ReqLiquidType, std::span<ZLiquidStatus> results, std::span<LiquidData> data = {}, float collisionHeight = 2.03128f) const; // DEFAULT_COLLISION_HEIGHT in Object.h
 
         bool GetAreaInfo(uint32 phaseMask, float x, float y, float z, uint32& mogpflags, int32& adtId, int32& rootId, int32& groupId) const;
         uint32 GetAreaId(uint32 phaseMask, float x, float y, float z) const;
@@ -480,8 +507,8 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint32 GetPlayersCountExceptGMs() const;
         bool ActiveObjectsNearGrid(NGridType const& ngrid) const;
 
-        void AddWorldObject(WorldObject* obj) { i_worldObjects.insert(obj); }
-        void RemoveWorldObject(WorldObject* obj) { i_worldObjects.erase(obj); }
+        void AddWorldObject(WorldObject* obj) { auto lock = LockForPartitionedUpdate(); i_worldObjects.insert(obj); }
+        void RemoveWorldObject(WorldObject* obj) { auto lock = LockForPartitionedUpdate(); i_worldObjects.erase(obj); }
 
         void SendToPlayers(WorldPacket const* data) const;
 
@@ -565,17 +592,23 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         BattlegroundMap const* ToBattlegroundMap() const { if (IsBattlegroundOrArena()) return reinterpret_cast<BattlegroundMap const*>(this); return nullptr; }
 
         float GetWaterOrGroundLevel(uint32 phasemask, float x, float y, float z, float* ground = nullptr, bool swim = false, float collisionHeight = 2.03128f) const; // DEFAULT_COLLISION_HEIGHT in Object.h
+        void GetWaterOrGroundLevels(uint32 phasemask, std::span<Position const> positions, std::span<float> levels, std::span<float> grounds, float collisionHeight = 2.03128f) const; // DEFAULT_COLLISION_HEIGHT in Object.h
         float GetMinHeight(float x, float y) const;
         float GetHeight(float x, float y, float z, bool checkVMap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         float GetGridHeight(float x, float y) const;
         float GetHeight(Position const& pos, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return GetHeight(pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), vmap, maxSearchDist); }
         float GetHeight(uint32 phasemask, float x, float y, float z, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return std::max<float>(GetHeight(x, y, z, vmap, maxSearchDist), GetGameObjectFloor(phasemask, x, y, z, maxSearchDist)); }
         float GetHeight(uint32 phasemask, Position const& pos, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const { return GetHeight(phasemask, pos.GetPositionX(), pos.GetPositionY(), pos.GetPositionZ(), vmap, maxSearchDist); }
+        // Same as GetHeight(phasemask, pos, ...) for every position: grids are looked up once per run of positions on the same grid
+        // and vmap rays are traced in packets, callers sampling many points around one spot should prefer it
+        void GetHeights(uint32 phasemask, std::span<Position const> positions, std::span<float> heights, bool vmap = true, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const;
         bool isInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
-        void Balance() { _dynamicTree.balance(); }
-        void RemoveGameObjectModel(GameObjectModel const& model) { _dynamicTree.remove(model); }
-        void InsertGameObjectModel(GameObjectModel const& model) { _dynamicTree.insert(model); }
-        bool ContainsGameObjectModel(GameObjectModel const& model) const { return _dynamicTree.contains(model);}
+        // the dynamic tree is read without locks, changes made while regions are updated in parallel wait for the merge
+        void RemoveGameObjectModel(GameObjectModel const& model);
+        void InsertGameObjectModel(GameObjectModel const& model);
+        void UpdateGameObjectModelPosition(GameObjectModel const& model);
+        void UpdateGameObjectModelCollision(GameObjectModel const& model);
+        bool ContainsGameObjectModel(GameObjectModel const& model) const;
         float GetGameObjectFloor(uint32 phasemask, float x, float y, float z, float maxSearchDist = DEFAULT_HEIGHT_SEARCH) const
         {
             return _dynamicTree.getHeight(x, y, z, maxSearchDist, phasemask);
@@ -627,6 +660,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         inline ObjectGuid::LowType GenerateLowGuid()
         {
             static_assert(ObjectGuidTraits<high>::MapSpecific, "Only map specific guid can be generated in Map context");
+            auto lock = LockForPartitionedUpdate();
             return GetGuidSequenceGenerator(high).Generate();
         }
 
@@ -639,19 +673,38 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
 
         void AddUpdateObject(Object* obj)
         {
+            auto lock = LockForPartitionedUpdate();
             _updateObjects.insert(obj);
         }
 
         void RemoveUpdateObject(Object* obj)
         {
+            auto lock = LockForPartitionedUpdate();
             _updateObjects.erase(obj);
         }
 
+        // Shared map state is only locked while regions of a continent are updated in parallel
+        std::unique_lock<std::recursive_mutex> LockForPartitionedUpdate() const
+        {
+            if (!_partitionedUpdate)
+                return std::unique_lock<std::recursive_mutex>();
+            return std::unique_lock<std::recursive_mutex>(_partitionLock);
+        }
+
+        // Queues action to run single threaded once regions updated in parallel are merged,
+        // returns false without queueing if no partitioned update is running
+        bool DeferToPartitionMerge(std::function<void()> action);
+
         size_t GetActiveNonPlayersCount() const
         {
             return m_activeNonPlayers.size();
         }
 
+        std::set<WorldObject*> const& GetActiveNonPlayers() const
+        {
+            return m_activeNonPlayers;
+        }
+
         virtual std::string GetDebugInfo() const;
 
     private:
@@ -659,7 +712,15 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         void LoadVMap(int gx, int gy);
         void LoadMap(int gx, int gy, bool reload = false);
         void LoadMMap(int gx, int gy);
+        // drops cached line of sight results crossing the grid whose static geometry was loaded or unloaded
+        void InvalidateLineOfSightCache(int gx, int gy);
         GridMap* GetGrid(float x, float y);
+        // Calls worker(GridMap*, first, count) for every run of consecutive positions on the same grid
+        template<class Worker>
+        void VisitGridRuns(std::span<Position const> positions, Worker&& worker) const;
+        ZLiquidStatus GetLiquidStatusForGrid(GridMap* gmap, uint32 phaseMask, float x, float y, float z, uint8 ReqLiquidType, LiquidData* data, float collisionHeight) const;
+
+        bool CalculateLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2, uint32 phasemask, LineOfSightChecks checks, VMAP::ModelIgnoreFlags ignoreFlags) const;
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -686,6 +747,13 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         bool _dynamicObjectsToMoveLock;
         std::vector<DynamicObject*> _dynamicObjectsToMove;
 
+        bool UpdateRegions(uint32 t_diff);
+
+        mutable std::recursive_mutex _partitionLock;
+        bool _partitionedUpdate;
+        std::vector<std::function<void()>> _partitionMergeActions;
+        std::unordered_map<GameObjectModel const*, bool> _partitionModelPresence;  // in the dynamic tree after the merge
+
         bool IsGridLoaded(GridCoord const&) const;
         void EnsureGridCreated(GridCoord const&);
         void EnsureGridCreated_i(GridCoord const&);
@@ -718,6 +786,12 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         uint32 m_unloadTimer;
         float m_VisibleDistance;
         DynamicMapTree _dynamicTree;
+        MapUnitSnapshot _unitSnapshot;
+        MapUpdateLod _updateLod;
+        MapTickProfiler _tickProfiler;
+        std::unique_ptr<PathCache> _pathCache;
+        std::unique_ptr<PathRequestQueue> _pathRequests;
+        std::unique_ptr<LineOfSightCache> _losCache;
 
         MapRefManager m_mapRefManager;
         MapRefManager::iterator m_mapRefIter;
@@ -882,6 +956,7 @@ class TC_GAME_API Map : public GridRefManager<NGridType>
         std::unordered_set<uint32> _toggledSpawnGroupIds;
 
         uint32 _respawnCheckTimer;
+        uint32 _updateCost;
         std::unordered_map<uint32, uint32> _zonePlayerCountMap;
 
         ZoneDynamicInfoMap _zoneDynamicInfo;
@@ -78,10 +78,17 @@ void MapInstanced::Update(uint32 t)
 
 void MapInstanced::DelayedUpdate(uint32 diff)
 {
-    for (InstancedMaps::iterator i = m_InstancedMaps.begin(); i != m_InstancedMaps.end(); ++i)
-        i->second->DelayedUpdate(diff);
-
+    // the grid state machine of the parent reads unload locks set by instances,
+    // so it must be done before any instance can unload its grids
     Map::DelayedUpdate(diff); // this may be removed
+
+    for (InstancedMaps::iterator i = m_InstancedMaps.begin(); i != m_InstancedMaps.end(); ++i)
+    {
+        if (sMapMgr->GetMapUpdater()->activated())
+            sMapMgr->GetMapUpdater()->schedule_delayed_update(*i->second, diff);
+        else
+            i->second->DelayedUpdate(diff);
+    }
 }
 
 /*
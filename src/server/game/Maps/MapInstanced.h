@@ -22,6 +22,7 @@
 #include "InstanceSaveMgr.h"
 #include "Map.h"
 #include "UniqueTrackablePtr.h"
+#include <mutex>
 
 class TC_GAME_API MapInstanced : public Map
 {
@@ -47,14 +48,17 @@ class TC_GAME_API MapInstanced : public Map
         }
         bool DestroyInstance(InstancedMaps::iterator &itr);
 
+        // called by instances loading and unloading grids, which may run on different map update threads
         void AddGridMapReference(GridCoord const& p)
         {
+            std::lock_guard<std::mutex> lock(_gridMapReferenceLock);
             ++GridMapReference[p.x_coord][p.y_coord];
             SetUnloadReferenceLock(GridCoord((MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord), true);
         }
 
         void RemoveGridMapReference(GridCoord const& p)
         {
+            std::lock_guard<std::mutex> lock(_gridMapReferenceLock);
             --GridMapReference[p.x_coord][p.y_coord];
             if (!GridMapReference[p.x_coord][p.y_coord])
                 SetUnloadReferenceLock(GridCoord((MAX_NUMBER_OF_GRIDS - 1) - p.x_coord, (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord), false);
@@ -70,5 +74,6 @@ class TC_GAME_API MapInstanced : public Map
         InstancedMaps m_InstancedMaps;
 
         uint16 GridMapReference[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        std::mutex _gridMapReferenceLock;
 };
 #endif
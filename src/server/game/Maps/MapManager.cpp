@@ -34,6 +34,8 @@
 #include "WorldSession.h"
 #include "Opcodes.h"
 #include "ScriptMgr.h"
+#include "ThreadPool.h"
+#include <algorithm>
 #include <numeric>
 #ifdef ELUNA
 #include "LuaEngine.h"
@@ -45,13 +47,13 @@
 //end npcbot
 
 MapManager::MapManager()
-    : _nextInstanceId(0), _scheduledScripts(0)
+    : _nextInstanceId(0), _pathfindingThreads(0), _scheduledScripts(0)
 {
     i_gridCleanUpDelay = sWorld->getIntConfig(CONFIG_INTERVAL_GRIDCLEAN);
     i_timer.SetInterval(sWorld->getIntConfig(CONFIG_INTERVAL_MAPUPDATE));
 }
 
-MapManager::~MapManager() { }
+MapManager::~MapManager() = default;
 
 void MapManager::Initialize()
 {
@@ -71,6 +73,20 @@ void MapManager::Initialize()
     if (num_threads > 0)
         m_updater.activate(num_threads);
 
+#ifndef ELUNA
+    // Regions of busy continents are updated by a separate pool, see Map::UpdateRegions
+    if (uint32 partitionThreads = sWorld->getIntConfig(CONFIG_MAP_UPDATE_PARTITION_THREADS))
+        _partitionPool = std::make_unique<Trinity::ThreadPool>(partitionThreads);
+#endif
+
+    // Paths requested by movement generators are calculated in batches, see PathRequestQueue
+    uint32 pathfindingThreads = sWorld->getIntConfig(CONFIG_MMAP_ASYNC_PATHFINDING_THREADS);
+    if (pathfindingThreads && sWorld->getBoolConfig(CONFIG_ENABLE_MMAPS))
+    {
+        _pathfindingPool = std::make_unique<Trinity::ThreadPool>(pathfindingThreads);
+        _pathfindingThreads = pathfindingThreads;
+    }
+
     //npcbot: load bots
     BotMgr::Initialize();
     //end npcbot
@@ -244,26 +260,67 @@ void MapManager::Update(uint32 diff)
         return;
 
     MapMapType::iterator iter = i_maps.begin();
-    for (; iter != i_maps.end(); ++iter)
+    if (m_updater.activated())
     {
-        if (m_updater.activated())
-            m_updater.schedule_update(*iter->second, uint32(i_timer.GetCurrent()));
-        else
+        // schedule most expensive maps first so they do not end up being the tail of the tick
+        std::vector<Map*> maps;
+        maps.reserve(i_maps.size());
+        for (; iter != i_maps.end(); ++iter)
+            maps.push_back(iter->second.get());
+
+        std::stable_sort(maps.begin(), maps.end(), [](Map const* left, Map const* right) { return left->GetUpdateCost() > right->GetUpdateCost(); });
+
+        for (Map* map : maps)
+            m_updater.schedule_update(*map, uint32(i_timer.GetCurrent()));
+
+        m_updater.wait();
+    }
+    else
+    {
+        for (; iter != i_maps.end(); ++iter)
             iter->second->Update(uint32(i_timer.GetCurrent()));
     }
-    if (m_updater.activated())
-        m_updater.wait();
 
     //npcbot
     BotMgr::HandleDelayedTeleports();
     //end npcbot
 
-    for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
+    if (m_updater.activated())
+    {
+        for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            m_updater.schedule_delayed_update(*iter->second, uint32(i_timer.GetCurrent()));
+
+        m_updater.wait();
+    }
+    else
+    {
+        for (iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->DelayedUpdate(uint32(i_timer.GetCurrent()));
+    }
+
+    ProcessDelayedCrossMapOperations();
 
     i_timer.SetCurrent(0);
 }
 
+void MapManager::AddDelayedCrossMapOperation(std::function<void()>&& operation)
+{
+    std::lock_guard<std::mutex> lock(_crossMapOperationsLock);
+    _crossMapOperations.push_back(std::move(operation));
+}
+
+void MapManager::ProcessDelayedCrossMapOperations()
+{
+    std::vector<std::function<void()>> operations;
+    {
+        std::lock_guard<std::mutex> lock(_crossMapOperationsLock);
+        std::swap(operations, _crossMapOperations);
+    }
+
+    for (std::function<void()>& operation : operations)
+        operation();
+}
+
 void MapManager::DoDelayedMovesAndRemoves() { }
 
 bool MapManager::ExistMapAndVMap(uint32 mapid, float x, float y)
@@ -304,6 +361,18 @@ void MapManager::UnloadAll()
     if (m_updater.activated())
         m_updater.deactivate();
 
+    if (_partitionPool)
+    {
+        _partitionPool->Join();
+        _partitionPool.reset();
+    }
+
+    if (_pathfindingPool)
+    {
+        _pathfindingPool->Join();
+        _pathfindingPool.reset();
+    }
+
     Map::DeleteStateMachine();
 }
 
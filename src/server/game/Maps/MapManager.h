@@ -25,10 +25,16 @@
 #include "MapUpdater.h"
 #include "UniqueTrackablePtr.h"
 #include <boost/dynamic_bitset.hpp>
+#include <functional>
 
 class Transport;
 struct TransportCreatureProto;
 
+namespace Trinity
+{
+    class ThreadPool;
+}
+
 class TC_GAME_API MapManager
 {
     public:
@@ -64,6 +70,10 @@ class TC_GAME_API MapManager
         void Initialize(void);
         void Update(uint32);
 
+        // Work started from Map::DelayedUpdate that touches other maps (transport map changes),
+        // executed on the world thread once all maps finished their delayed update
+        void AddDelayedCrossMapOperation(std::function<void()>&& operation);
+
         void SetGridCleanUpDelay(uint32 t)
         {
             if (t < MIN_GRID_DELAY)
@@ -128,6 +138,9 @@ class TC_GAME_API MapManager
         void FreeInstanceId(uint32 instanceId);
 
         MapUpdater * GetMapUpdater() { return &m_updater; }
+        Trinity::ThreadPool* GetPartitionPool() const { return _partitionPool.get(); }
+        Trinity::ThreadPool* GetPathfindingPool() const { return _pathfindingPool.get(); }
+        uint32 GetPathfindingThreads() const { return _pathfindingThreads; }
 
         template<typename Worker>
         void DoForAllMaps(Worker&& worker);
@@ -165,6 +178,14 @@ class TC_GAME_API MapManager
         uint32 _nextInstanceId;
         MapUpdater m_updater;
 
+        void ProcessDelayedCrossMapOperations();
+
+        std::mutex _crossMapOperationsLock;
+        std::vector<std::function<void()>> _crossMapOperations;
+        std::unique_ptr<Trinity::ThreadPool> _partitionPool;
+        std::unique_ptr<Trinity::ThreadPool> _pathfindingPool;
+        uint32 _pathfindingThreads;
+
         // atomic op counter for active scripts amount
         std::atomic<std::size_t> _scheduledScripts;
 };
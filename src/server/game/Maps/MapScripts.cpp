@@ -46,28 +46,35 @@ void Map::ScriptsStart(std::map<uint32, std::multimap<uint32, ScriptInfo>> const
 
     ///- Schedule script execution for all scripts in the script map
     ScriptMap const* s2 = &(s->second);
-    bool immedScript = false;
-    for (ScriptMap::const_iterator iter = s2->begin(); iter != s2->end(); ++iter)
+    auto schedule = [this, s2, sourceGUID, targetGUID, ownerGUID]()
     {
-        ScriptAction sa;
-        sa.sourceGUID = sourceGUID;
-        sa.targetGUID = targetGUID;
-        sa.ownerGUID  = ownerGUID;
+        bool immedScript = false;
+        for (ScriptMap::const_iterator iter = s2->begin(); iter != s2->end(); ++iter)
+        {
+            ScriptAction sa;
+            sa.sourceGUID = sourceGUID;
+            sa.targetGUID = targetGUID;
+            sa.ownerGUID  = ownerGUID;
 
-        sa.script = &iter->second;
-        m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(GameTime::GetGameTime() + iter->first), sa));
-        if (iter->first == 0)
-            immedScript = true;
+            sa.script = &iter->second;
+            m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(GameTime::GetGameTime() + iter->first), sa));
+            if (iter->first == 0)
+                immedScript = true;
 
-        sMapMgr->IncreaseScheduledScriptsCount();
-    }
-    ///- If one of the effects should be immediate, launch the script execution
-    if (/*start &&*/ immedScript && !i_scriptLock)
-    {
-        i_scriptLock = true;
-        ScriptsProcess();
-        i_scriptLock = false;
-    }
+            sMapMgr->IncreaseScheduledScriptsCount();
+        }
+        ///- If one of the effects should be immediate, launch the script execution
+        if (/*start &&*/ immedScript && !i_scriptLock)
+        {
+            i_scriptLock = true;
+            ScriptsProcess();
+            i_scriptLock = false;
+        }
+    };
+
+    // the schedule is shared by all regions of a partitioned update, their scripts start after the merge
+    if (!DeferToPartitionMerge(schedule))
+        schedule();
 }
 
 void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* source, Object* target)
@@ -85,17 +92,25 @@ void Map::ScriptCommandStart(ScriptInfo const& script, uint32 delay, Object* sou
     sa.ownerGUID  = ownerGUID;
 
     sa.script = &script;
-    m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(GameTime::GetGameTime() + delay), sa));
 
-    sMapMgr->IncreaseScheduledScriptsCount();
-
-    ///- If effects should be immediate, launch the script execution
-    if (delay == 0 && !i_scriptLock)
+    auto schedule = [this, sa, delay]()
     {
-        i_scriptLock = true;
-        ScriptsProcess();
-        i_scriptLock = false;
-    }
+        m_scriptSchedule.insert(ScriptScheduleMap::value_type(time_t(GameTime::GetGameTime() + delay), sa));
+
+        sMapMgr->IncreaseScheduledScriptsCount();
+
+        ///- If effects should be immediate, launch the script execution
+        if (delay == 0 && !i_scriptLock)
+        {
+            i_scriptLock = true;
+            ScriptsProcess();
+            i_scriptLock = false;
+        }
+    };
+
+    // see ScriptsStart
+    if (!DeferToPartitionMerge(schedule))
+        schedule();
 }
 
 // Helpers for ScriptProcess method.
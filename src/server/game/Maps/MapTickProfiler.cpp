@@ -0,0 +1,123 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapTickProfiler.h"
+#include "Map.h"
+#include "Metric.h"
+#include "World.h"
+#include <algorithm>
+
+namespace
+{
+    char const* const MapTickPhasePaths[MAX_MAP_TICK_PHASES] =
+    {
+        "total",
+        "total/dynamic_tree",
+        "total/sessions",
+        "total/respawns",
+        "total/objects",
+        "total/objects/players",
+        "total/objects/cells",
+        "total/objects/cells/bot_ai",
+        "total/objects/transports",
+        "total/object_updates",
+        "total/scripts",
+        "total/move_lists",
+        "total/relocation_notifies",
+        "total/script_hooks",
+        "total/path_requests"
+    };
+
+    // value below which pct percent of sorted samples fall
+    uint32 GetPercentile(std::vector<uint32>& samples, uint32 pct)
+    {
+        std::size_t index = std::min(samples.size() - 1, samples.size() * pct / 100);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+        return samples[index];
+    }
+}
+
+MapTickProfiler::MapTickProfiler() : _enabled(false), _tickStart(), _lastReport(std::chrono::steady_clock::now())
+{
+    for (std::atomic<uint64>& tickTime : _tickTimes)
+        tickTime.store(0, std::memory_order_relaxed);
+}
+
+char const* MapTickProfiler::GetPhasePath(MapTickPhase phase)
+{
+    return phase < MAX_MAP_TICK_PHASES ? MapTickPhasePaths[phase] : "unknown";
+}
+
+void MapTickProfiler::BeginTick()
+{
+    bool enabled = sWorld->getBoolConfig(CONFIG_MAP_UPDATE_PROFILER_ENABLE);
+    if (_enabled && !enabled)
+        for (std::vector<uint32>& samples : _samples)
+            samples.clear();
+
+    _enabled = enabled;
+    if (_enabled)
+        _tickStart = std::chrono::steady_clock::now();
+}
+
+void MapTickProfiler::EndTick(Map const& map)
+{
+    if (!_enabled)
+        return;
+
+    TimePoint now = std::chrono::steady_clock::now();
+    AddTime(MAP_TICK_PHASE_TOTAL, now - _tickStart);
+
+    for (uint8 phase = 0; phase < MAX_MAP_TICK_PHASES; ++phase)
+        _samples[phase].push_back(uint32(_tickTimes[phase].exchange(0, std::memory_order_relaxed) / 1000));
+
+    if (now - _lastReport < Milliseconds(sWorld->getIntConfig(CONFIG_MAP_UPDATE_PROFILER_INTERVAL)))
+        return;
+
+    _lastReport = now;
+    Report(map);
+}
+
+void MapTickProfiler::Report(Map const& map)
+{
+    for (uint8 phase = 0; phase < MAX_MAP_TICK_PHASES; ++phase)
+    {
+        std::vector<uint32>& samples = _samples[phase];
+        if (samples.empty())
+            continue;
+
+        [[maybe_unused]] uint32 const max = *std::max_element(samples.begin(), samples.end());
+        [[maybe_unused]] uint32 const p99 = GetPercentile(samples, 99);
+        [[maybe_unused]] uint32 const p50 = GetPercentile(samples, 50);
+        samples.clear();
+
+        TC_METRIC_VALUE("map_tick_phase_p50", uint64(p50),
+            TC_METRIC_TAG("map_id", std::to_string(map.GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(map.GetInstanceId())),
+            TC_METRIC_TAG("phase", GetPhasePath(MapTickPhase(phase))));
+
+        TC_METRIC_VALUE("map_tick_phase_p99", uint64(p99),
+            TC_METRIC_TAG("map_id", std::to_string(map.GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(map.GetInstanceId())),
+            TC_METRIC_TAG("phase", GetPhasePath(MapTickPhase(phase))));
+
+        TC_METRIC_VALUE("map_tick_phase_max", uint64(max),
+            TC_METRIC_TAG("map_id", std::to_string(map.GetId())),
+            TC_METRIC_TAG("map_instanceid", std::to_string(map.GetInstanceId())),
+            TC_METRIC_TAG("phase", GetPhasePath(MapTickPhase(phase))));
+    }
+}
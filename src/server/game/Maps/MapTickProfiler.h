@@ -0,0 +1,110 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_TICK_PROFILER_H
+#define TRINITY_MAP_TICK_PROFILER_H
+
+#include "Define.h"
+#include "Duration.h"
+#include <array>
+#include <atomic>
+#include <vector>
+
+class Map;
+
+enum MapTickPhase : uint8
+{
+    MAP_TICK_PHASE_TOTAL                = 0,
+    MAP_TICK_PHASE_DYNAMIC_TREE         = 1,
+    MAP_TICK_PHASE_SESSIONS             = 2,
+    MAP_TICK_PHASE_RESPAWNS             = 3,
+    MAP_TICK_PHASE_OBJECTS              = 4,
+    MAP_TICK_PHASE_PLAYERS              = 5,    // child of MAP_TICK_PHASE_OBJECTS
+    MAP_TICK_PHASE_CELLS                = 6,    // child of MAP_TICK_PHASE_OBJECTS
+    MAP_TICK_PHASE_BOT_AI               = 7,    // child of MAP_TICK_PHASE_CELLS
+    MAP_TICK_PHASE_TRANSPORTS           = 8,    // child of MAP_TICK_PHASE_OBJECTS
+    MAP_TICK_PHASE_OBJECT_UPDATES       = 9,
+    MAP_TICK_PHASE_SCRIPTS              = 10,
+    MAP_TICK_PHASE_MOVE_LISTS           = 11,
+    MAP_TICK_PHASE_RELOCATION_NOTIFIES  = 12,
+    MAP_TICK_PHASE_SCRIPT_HOOKS         = 13,
+    MAP_TICK_PHASE_PATH_REQUESTS        = 14,
+
+    MAX_MAP_TICK_PHASES
+};
+
+// Scoped per-phase timers of Map::Update (MapUpdate.Profiler.* config).
+// Time spent in every phase is summed over a tick, per tick totals are kept until the
+// report interval passes and then exported as p50/p99/max metrics tagged by phase path.
+// Phases nest: time of a child phase is also part of its parent, total is measured
+// from BeginTick to EndTick.
+class TC_GAME_API MapTickProfiler
+{
+    public:
+        class Scope
+        {
+            public:
+                Scope(MapTickProfiler& profiler, MapTickPhase phase) : _profiler(profiler.IsEnabled() ? &profiler : nullptr), _phase(phase)
+                {
+                    if (_profiler)
+                        _start = std::chrono::steady_clock::now();
+                }
+
+                ~Scope()
+                {
+                    if (_profiler)
+                        _profiler->AddTime(_phase, std::chrono::steady_clock::now() - _start);
+                }
+
+                Scope(Scope const&) = delete;
+                Scope& operator=(Scope const&) = delete;
+
+            private:
+                MapTickProfiler* _profiler;
+                MapTickPhase _phase;
+                TimePoint _start;
+        };
+
+        MapTickProfiler();
+
+        MapTickProfiler(MapTickProfiler const&) = delete;
+        MapTickProfiler& operator=(MapTickProfiler const&) = delete;
+
+        void BeginTick();
+        void EndTick(Map const& map);
+
+        bool IsEnabled() const { return _enabled; }
+
+        // phases may be entered from several threads at once, see Map::UpdateRegions
+        void AddTime(MapTickPhase phase, std::chrono::steady_clock::duration duration)
+        {
+            _tickTimes[phase].fetch_add(uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()), std::memory_order_relaxed);
+        }
+
+        static char const* GetPhasePath(MapTickPhase phase);
+
+    private:
+        void Report(Map const& map);
+
+        bool _enabled;
+        TimePoint _tickStart;
+        TimePoint _lastReport;
+        std::array<std::atomic<uint64>, MAX_MAP_TICK_PHASES> _tickTimes;           // nanoseconds of current tick
+        std::array<std::vector<uint32>, MAX_MAP_TICK_PHASES> _samples;             // microseconds per tick since last report
+};
+
+#endif
@@ -0,0 +1,138 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUnitSnapshot.h"
+#include "CellImpl.h"
+#include "Creature.h"
+#include "Map.h"
+#include "Metric.h"
+#include "Player.h"
+
+namespace
+{
+    struct UnitSnapshotCellFiller
+    {
+        std::vector<Unit*>& i_units;
+
+        explicit UnitSnapshotCellFiller(std::vector<Unit*>& units) : i_units(units) { }
+
+        void Add(Unit* unit)
+        {
+            if (unit->IsInWorld())
+                i_units.push_back(unit);
+        }
+
+        void Visit(CreatureMapType& m)
+        {
+            for (CreatureMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource());
+        }
+
+        void Visit(PlayerMapType& m)
+        {
+            for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+                Add(itr->GetSource());
+        }
+
+        template<class NOT_INTERESTED> void Visit(GridRefManager<NOT_INTERESTED>&) { }
+    };
+}
+
+MapUnitSnapshot::MapUnitSnapshot(Map& map) : _map(map), _updateThread(std::thread::id()), _suspended(false), _cellQueries(0), _cellVisits(0)
+{
+}
+
+void MapUnitSnapshot::BeginTick()
+{
+    _units.clear();
+    _buckets.clear();
+    _cellQueries = 0;
+    _cellVisits = 0;
+    _updateThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void MapUnitSnapshot::EndTick()
+{
+    _updateThread.store(std::thread::id(), std::memory_order_relaxed);
+
+    if (!_cellQueries)
+        return;
+
+    TC_METRIC_VALUE("map_unit_snapshot_cell_queries", uint64(_cellQueries),
+        TC_METRIC_TAG("map_id", std::to_string(_map.GetId())),
+        TC_METRIC_TAG("map_instanceid", std::to_string(_map.GetInstanceId())));
+
+    TC_METRIC_VALUE("map_unit_snapshot_cell_visits", uint64(_cellVisits),
+        TC_METRIC_TAG("map_id", std::to_string(_map.GetId())),
+        TC_METRIC_TAG("map_instanceid", std::to_string(_map.GetInstanceId())));
+}
+
+void MapUnitSnapshot::Suspend()
+{
+    _suspended.store(true, std::memory_order_relaxed);
+    _updateThread.store(std::thread::id(), std::memory_order_relaxed);
+}
+
+void MapUnitSnapshot::Resume()
+{
+    _buckets.clear();
+    _suspended.store(false, std::memory_order_relaxed);
+    _updateThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+}
+
+void MapUnitSnapshot::Invalidate()
+{
+    if (_suspended.load(std::memory_order_relaxed))
+        return;
+
+    // entries are left in place until next tick, only the lookup is dropped
+    _buckets.clear();
+}
+
+void MapUnitSnapshot::InvalidateCell(CellCoord const& cellCoord)
+{
+    if (_suspended.load(std::memory_order_relaxed))
+        return;
+
+    _buckets.erase(cellCoord.GetId());
+}
+
+MapUnitSnapshot::Bucket const& MapUnitSnapshot::GetBucket(CellCoord const& cellCoord)
+{
+    ++_cellQueries;
+
+    auto [itr, inserted] = _buckets.try_emplace(cellCoord.GetId());
+    if (!inserted)
+        return itr->second;
+
+    ++_cellVisits;
+
+    Bucket& bucket = itr->second;
+    bucket.first = uint32(_units.size());
+
+    Cell cell(cellCoord);
+    cell.SetNoCreate();
+
+    UnitSnapshotCellFiller filler(_units);
+    TypeContainerVisitor<UnitSnapshotCellFiller, GridTypeMapContainer> gridVisitor(filler);
+    TypeContainerVisitor<UnitSnapshotCellFiller, WorldTypeMapContainer> worldVisitor(filler);
+    _map.Visit(cell, gridVisitor);
+    _map.Visit(cell, worldVisitor);
+
+    bucket.count = uint32(_units.size()) - bucket.first;
+    return bucket;
+}
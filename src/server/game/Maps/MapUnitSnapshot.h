@@ -0,0 +1,93 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UNIT_SNAPSHOT_H
+#define TRINITY_MAP_UNIT_SNAPSHOT_H
+
+#include "Define.h"
+#include "GridDefines.h"
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+class Map;
+class Unit;
+class WorldObject;
+
+// Per-tick list of the units found in grid cells of a map.
+// Cells are captured lazily the first time a search touches them during Map::Update
+// so repeated unit searches over the same area (npcbots) walk the grid only once per tick.
+// Only cell membership is captured, distances are checked against live unit positions.
+// Entries hold raw pointers: any unit removal from the map invalidates the snapshot.
+class TC_GAME_API MapUnitSnapshot
+{
+    public:
+        explicit MapUnitSnapshot(Map& map);
+
+        MapUnitSnapshot(MapUnitSnapshot const&) = delete;
+        MapUnitSnapshot& operator=(MapUnitSnapshot const&) = delete;
+
+        void BeginTick();
+        void EndTick();
+
+        void Invalidate();
+        void InvalidateCell(CellCoord const& cellCoord);
+
+        // Disables the snapshot while map cells are updated from several threads, Resume drops all captured cells
+        void Suspend();
+        void Resume();
+
+        // Snapshot is only usable from the thread currently updating its map
+        bool IsActive() const { return _updateThread.load(std::memory_order_relaxed) == std::this_thread::get_id(); }
+
+        // Calls pred(Unit*) for every unit in range, pred returns false to stop the search
+        template<class Pred>
+        void VisitUnits(float x, float y, float radius, Pred&& pred);
+
+        // Snapshot counterpart of Cell::VisitAllObjects for unit searchers (visitor.VisitUnit(Unit*))
+        template<class T>
+        void Visit(WorldObject const* center, T& visitor, float radius);
+
+        // Uses snapshot of center's map when called from its update, regular grid visit otherwise
+        template<class T>
+        static void VisitNearbyUnits(WorldObject const* center, T& visitor, float radius);
+
+        uint32 GetCellQueries() const { return _cellQueries; }
+        uint32 GetCellVisits() const { return _cellVisits; }
+
+    private:
+        struct Bucket
+        {
+            uint32 first;
+            uint32 count;
+        };
+
+        Bucket const& GetBucket(CellCoord const& cellCoord);
+
+        Map& _map;
+        std::vector<Unit*> _units;
+        std::unordered_map<uint32 /*cellId*/, Bucket> _buckets;
+        std::atomic<std::thread::id> _updateThread;
+        std::atomic<bool> _suspended;
+
+        // cells requested by searchers (grid walks without snapshot) and cells actually walked
+        uint32 _cellQueries;
+        uint32 _cellVisits;
+};
+
+#endif
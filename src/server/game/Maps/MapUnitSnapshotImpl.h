@@ -0,0 +1,75 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UNIT_SNAPSHOT_IMPL_H
+#define TRINITY_MAP_UNIT_SNAPSHOT_IMPL_H
+
+#include "MapUnitSnapshot.h"
+#include "CellImpl.h"
+#include "Map.h"
+#include "Unit.h"
+
+template<class Pred>
+void MapUnitSnapshot::VisitUnits(float x, float y, float radius, Pred&& pred)
+{
+    //same limit as Cell::Visit
+    if (radius > SIZE_OF_GRIDS)
+        radius = SIZE_OF_GRIDS;
+
+    CellArea area = Cell::CalculateCellArea(x, y, radius);
+    for (uint32 cx = area.low_bound.x_coord; cx <= area.high_bound.x_coord; ++cx)
+    {
+        for (uint32 cy = area.low_bound.y_coord; cy <= area.high_bound.y_coord; ++cy)
+        {
+            Bucket const& bucket = GetBucket(CellCoord(cx, cy));
+            for (uint32 i = bucket.first; i != bucket.first + bucket.count; ++i)
+            {
+                Unit* unit = _units[i];
+                float const dx = unit->GetPositionX() - x;
+                float const dy = unit->GetPositionY() - y;
+                float const dist = radius + unit->GetCombatReach();
+                if (dx * dx + dy * dy > dist * dist)
+                    continue;
+
+                if (!pred(unit))
+                    return;
+            }
+        }
+    }
+}
+
+template<class T>
+void MapUnitSnapshot::Visit(WorldObject const* center, T& visitor, float radius)
+{
+    //we should increase search radius by object's radius, see Cell::Visit
+    VisitUnits(center->GetPositionX(), center->GetPositionY(), radius + center->GetCombatReach(), [&visitor](Unit* unit)
+    {
+        return visitor.VisitUnit(unit);
+    });
+}
+
+template<class T>
+void MapUnitSnapshot::VisitNearbyUnits(WorldObject const* center, T& visitor, float radius)
+{
+    MapUnitSnapshot& snapshot = center->GetMap()->GetUnitSnapshot();
+    if (snapshot.IsActive())
+        snapshot.Visit(center, visitor, radius);
+    else
+        Cell::VisitAllObjects(center, visitor, radius);
+}
+
+#endif
@@ -0,0 +1,176 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUpdateLod.h"
+#include "CellImpl.h"
+#include "Creature.h"
+#include "GameObject.h"
+#include "Map.h"
+#include "Metric.h"
+#include "Player.h"
+#include "World.h"
+
+namespace
+{
+    char const* const BandNames[MAX_MAP_UPDATE_LOD_BANDS] = { "near", "mid", "far" };
+}
+
+MapUpdateLod::MapUpdateLod() : _enabled(false), _tick(0), _rates()
+{
+    for (std::atomic<uint32>& count : _updated)
+        count = 0;
+    for (std::atomic<uint32>& count : _skipped)
+        count = 0;
+}
+
+void MapUpdateLod::BeginTick(Map const& map)
+{
+    _enabled = sWorld->getBoolConfig(CONFIG_MAP_UPDATE_LOD_ENABLE) && !map.Instanceable();
+    if (!_enabled)
+    {
+        _nearCells.reset();
+        _midCells.reset();
+        return;
+    }
+
+    ++_tick;
+    _rates[MAP_UPDATE_LOD_BAND_NEAR] = 1;
+    _rates[MAP_UPDATE_LOD_BAND_MID] = sWorld->getIntConfig(CONFIG_MAP_UPDATE_LOD_MID_RATE);
+    _rates[MAP_UPDATE_LOD_BAND_FAR] = sWorld->getIntConfig(CONFIG_MAP_UPDATE_LOD_FAR_RATE);
+
+    if (!_nearCells)
+    {
+        _nearCells = std::make_unique<CellMask>();
+        _midCells = std::make_unique<CellMask>();
+    }
+    else
+    {
+        _nearCells->reset();
+        _midCells->reset();
+    }
+
+    float const nearDistance = sWorld->getFloatConfig(CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE);
+    float const farDistance = sWorld->getFloatConfig(CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE);
+
+    auto markArea = [](CellMask& mask, CellArea const& area)
+    {
+        for (uint32 x = area.low_bound.x_coord; x <= area.high_bound.x_coord; ++x)
+            for (uint32 y = area.low_bound.y_coord; y <= area.high_bound.y_coord; ++y)
+                mask.set(y * TOTAL_NUMBER_OF_CELLS_PER_MAP + x);
+    };
+
+    Map::PlayerList const& players = map.GetPlayers();
+    for (Map::PlayerList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+    {
+        Player const* player = itr->GetSource();
+        if (!player || !player->IsInWorld())
+            continue;
+
+        markArea(*_nearCells, Cell::CalculateCellArea(player->GetPositionX(), player->GetPositionY(), nearDistance));
+        markArea(*_midCells, Cell::CalculateCellArea(player->GetPositionX(), player->GetPositionY(), farDistance));
+
+        // far sight and mind vision make remote areas just as important
+        if (WorldObject const* viewPoint = player->GetViewpoint())
+            markArea(*_nearCells, Cell::CalculateCellArea(viewPoint->GetPositionX(), viewPoint->GetPositionY(), nearDistance));
+    }
+
+    // active objects keep their grids running without players (escorts, event npcs, wandering bots),
+    // their surroundings are updated as if a player was there
+    for (WorldObject const* obj : map.GetActiveNonPlayers())
+    {
+        if (!obj->IsInWorld())
+            continue;
+
+        markArea(*_nearCells, Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), nearDistance));
+        markArea(*_midCells, Cell::CalculateCellArea(obj->GetPositionX(), obj->GetPositionY(), farDistance));
+    }
+}
+
+void MapUpdateLod::EndTick(Map const& map)
+{
+    if (!_enabled)
+        return;
+
+    for (uint8 band = 0; band < MAX_MAP_UPDATE_LOD_BANDS; ++band)
+    {
+        TC_METRIC_VALUE("map_update_lod_updated", uint64(_updated[band].exchange(0)),
+            TC_METRIC_TAG("map_id", std::to_string(map.GetId())),
+            TC_METRIC_TAG("band", BandNames[band]));
+
+        uint32 skipped = _skipped[band].exchange(0);
+        if (band != MAP_UPDATE_LOD_BAND_NEAR)
+            TC_METRIC_VALUE("map_update_lod_skipped", uint64(skipped),
+                TC_METRIC_TAG("map_id", std::to_string(map.GetId())),
+                TC_METRIC_TAG("band", BandNames[band]));
+    }
+}
+
+MapUpdateLodBand MapUpdateLod::GetBand(WorldObject const* obj) const
+{
+    CellCoord cellCoord = Trinity::ComputeCellCoord(obj->GetPositionX(), obj->GetPositionY());
+    if (!cellCoord.IsCoordValid())
+        return MAP_UPDATE_LOD_BAND_NEAR;
+
+    uint32 cellId = cellCoord.GetId();
+    if (_nearCells->test(cellId))
+        return MAP_UPDATE_LOD_BAND_NEAR;
+    if (_midCells->test(cellId))
+        return MAP_UPDATE_LOD_BAND_MID;
+    return MAP_UPDATE_LOD_BAND_FAR;
+}
+
+bool MapUpdateLod::UpdateOrSkip(WorldObject* obj, MapUpdateLodBand band, uint32& diff)
+{
+    // objects of a band are spread over its ticks by guid, grid loads would make them update in bursts otherwise
+    uint32 const rate = _rates[band];
+    if (rate > 1 && (_tick + obj->GetGUID().GetCounter()) % rate)
+    {
+        obj->SetSkippedUpdateDiff(obj->GetSkippedUpdateDiff() + diff);
+        _skipped[band].fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    diff += obj->GetSkippedUpdateDiff();
+    obj->SetSkippedUpdateDiff(0);
+    _updated[band].fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool MapUpdateLod::RequiresFullRate(Creature const* creature)
+{
+    if (creature->isActiveObject() || creature->IsInCombat() || creature->HasUnitState(UNIT_STATE_CASTING | UNIT_STATE_EVADE))
+        return true;
+
+    if (!creature->GetCharmerOrOwnerGUID().IsEmpty() || creature->IsSummon() || creature->GetVehicleKit() || creature->GetVehicle() || creature->GetTransport())
+        return true;
+
+    //npcbot: bots of players follow their masters, only free (wandering) bots can be throttled
+    if (creature->IsNPCBotOrPet())
+        return !creature->IsFreeBot();
+    //end npcbot
+
+    // scripted creatures may rely on their AI timers
+    return creature->GetScriptId() || !creature->GetAIName().empty();
+}
+
+bool MapUpdateLod::RequiresFullRate(GameObject const* go)
+{
+    if (go->isActiveObject() || go->IsTransport() || !go->GetOwnerGUID().IsEmpty() || go->GetGoType() == GAMEOBJECT_TYPE_TRAP)
+        return true;
+
+    return go->GetScriptId() || !go->GetAIName().empty();
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UPDATE_LOD_H
+#define TRINITY_MAP_UPDATE_LOD_H
+
+#include "Define.h"
+#include "GridDefines.h"
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
+
+class Creature;
+class DynamicObject;
+class GameObject;
+class Map;
+class WorldObject;
+
+enum MapUpdateLodBand : uint8
+{
+    MAP_UPDATE_LOD_BAND_NEAR    = 0,
+    MAP_UPDATE_LOD_BAND_MID     = 1,
+    MAP_UPDATE_LOD_BAND_FAR     = 2,
+
+    MAX_MAP_UPDATE_LOD_BANDS
+};
+
+// Level of detail of object updates on continents (MapUpdate.LOD.* config).
+// Grid cells are sorted into distance bands around players once per tick. Objects of
+// mid and far bands skip updates and receive the accumulated diff when they run again.
+class TC_GAME_API MapUpdateLod
+{
+    public:
+        MapUpdateLod();
+
+        MapUpdateLod(MapUpdateLod const&) = delete;
+        MapUpdateLod& operator=(MapUpdateLod const&) = delete;
+
+        void BeginTick(Map const& map);
+        void EndTick(Map const& map);
+
+        bool IsEnabled() const { return _enabled; }
+
+        // returns false if update of obj is skipped this tick, otherwise diff is increased by skipped time
+        template<class T>
+        bool ShouldUpdate(T* obj, uint32& diff);
+
+    private:
+        typedef std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP * TOTAL_NUMBER_OF_CELLS_PER_MAP> CellMask;
+
+        MapUpdateLodBand GetBand(WorldObject const* obj) const;
+        bool UpdateOrSkip(WorldObject* obj, MapUpdateLodBand band, uint32& diff);
+
+        static bool RequiresFullRate(Creature const* creature);
+        static bool RequiresFullRate(GameObject const* go);
+        static bool RequiresFullRate(DynamicObject const* /*dynObj*/) { return true; }
+
+        bool _enabled;
+        uint32 _tick;
+        std::array<uint32, MAX_MAP_UPDATE_LOD_BANDS> _rates;
+        std::unique_ptr<CellMask> _nearCells;
+        std::unique_ptr<CellMask> _midCells;
+
+        // cells of a continent may be updated from several threads, see Map::UpdateRegions
+        std::array<std::atomic<uint32>, MAX_MAP_UPDATE_LOD_BANDS> _updated;
+        std::array<std::atomic<uint32>, MAX_MAP_UPDATE_LOD_BANDS> _skipped;
+};
+
+template<class T>
+bool MapUpdateLod::ShouldUpdate(T* obj, uint32& diff)
+{
+    MapUpdateLodBand band = GetBand(obj);
+    if (band != MAP_UPDATE_LOD_BAND_NEAR && RequiresFullRate(obj))
+        band = MAP_UPDATE_LOD_BAND_NEAR;
+
+    return UpdateOrSkip(obj, band, diff);
+}
+
+#endif
@@ -0,0 +1,261 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MapUpdatePartition.h"
+#include "CellImpl.h"
+#include "CombatManager.h"
+#include "Creature.h"
+#include "CreatureGroups.h"
+#include "DynamicObject.h"
+#include "GameObject.h"
+#include "ObjectMgr.h"
+#include "Player.h"
+#include "Spell.h"
+#include "SpellAuras.h"
+#include "SpellInfo.h"
+#include "SpellMgr.h"
+#include <numeric>
+
+namespace
+{
+    // spell scripts can search and modify anything, otherwise a spell acts within its range and radius
+    bool SpellReaches(SpellInfo const* spellInfo, float reach, bool checkTriggered = true)
+    {
+        if (!spellInfo)
+            return false;
+
+        SpellScriptsBounds const scripts = sObjectMgr->GetSpellScriptsBounds(spellInfo->Id);
+        if (scripts.first != scripts.second)
+            return true;
+
+        if (spellInfo->GetMaxRange(false) >= reach || spellInfo->GetMaxRange(true) >= reach)
+            return true;
+
+        for (SpellEffectInfo const& effect : spellInfo->GetEffects())
+        {
+            if (effect.HasRadius() && effect.CalcRadius() >= reach)
+                return true;
+
+            if (checkTriggered && effect.TriggerSpell && SpellReaches(sSpellMgr->GetSpellInfo(effect.TriggerSpell), reach, false))
+                return true;
+        }
+
+        return false;
+    }
+
+    struct RootArea
+    {
+        CellArea Visit;
+        CellArea Expanded;
+    };
+
+    bool Overlaps(CellArea const& left, CellArea const& right)
+    {
+        return left.low_bound.x_coord <= right.high_bound.x_coord && right.low_bound.x_coord <= left.high_bound.x_coord
+            && left.low_bound.y_coord <= right.high_bound.y_coord && right.low_bound.y_coord <= left.high_bound.y_coord;
+    }
+
+    uint32 FindRoot(std::vector<uint32>& parents, uint32 index)
+    {
+        while (parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+        return index;
+    }
+}
+
+bool MapUpdateRegion::MarkCell(uint32 x, uint32 y)
+{
+    if (x < LowBound.x_coord || x > HighBound.x_coord || y < LowBound.y_coord || y > HighBound.y_coord)
+        return false;
+
+    uint32 const width = HighBound.x_coord - LowBound.x_coord + 1;
+    std::vector<bool>::reference visited = VisitedCells[(y - LowBound.y_coord) * width + (x - LowBound.x_coord)];
+    if (visited)
+        return false;
+
+    visited = true;
+    return true;
+}
+
+bool MapUpdateRegion::Contains(float x, float y) const
+{
+    CellCoord const cell = Trinity::ComputeCellCoord(x, y);
+    for (CellArea const& area : OwnedAreas)
+        if (cell.x_coord >= area.low_bound.x_coord && cell.x_coord <= area.high_bound.x_coord
+            && cell.y_coord >= area.low_bound.y_coord && cell.y_coord <= area.high_bound.y_coord)
+            return true;
+
+    return false;
+}
+
+bool MapUpdateRegion::Contains(WorldObject const* obj) const
+{
+    return obj->FindMap() == RegionMap && Contains(obj->GetPositionX(), obj->GetPositionY());
+}
+
+bool MapUpdateRegion::CanUpdateInParallel(WorldObject* obj) const
+{
+    auto reachesOut = [this](WorldObject const* other) { return other && !Contains(other); };
+
+    if (GameObject* go = obj->ToGameObject())
+    {
+        if (go->GetScriptId() || !go->GetAIName().empty() || reachesOut(go->GetOwner()))
+            return false;
+
+        if (go->GetGoType() == GAMEOBJECT_TYPE_TRAP)
+        {
+            GameObjectTemplate const* goInfo = go->GetGOInfo();
+            if (goInfo->trap.diameter * 0.5f >= Reach || SpellReaches(sSpellMgr->GetSpellInfo(goInfo->trap.spellId), Reach))
+                return false;
+        }
+
+        return true;
+    }
+
+    if (DynamicObject* dynObj = obj->ToDynObject())
+        return dynObj->GetRadius() < Reach && !reachesOut(dynObj->GetCaster());
+
+    Unit* unit = obj->ToUnit();
+    if (!unit)
+        return true;
+
+    if (reachesOut(unit->GetVictim()) || reachesOut(unit->GetCharmerOrOwner()))
+        return false;
+
+    for (Unit const* controlled : unit->m_Controlled)
+        if (reachesOut(controlled))
+            return false;
+
+    for (auto const& [guid, ref] : unit->GetCombatManager().GetPvECombatRefs())
+        if (reachesOut(ref->GetOther(unit)))
+            return false;
+
+    for (auto const& [guid, ref] : unit->GetCombatManager().GetPvPCombatRefs())
+        if (reachesOut(ref->GetOther(unit)))
+            return false;
+
+    for (auto const& [spellId, aurApp] : unit->GetAppliedAuras())
+    {
+        Aura* aura = aurApp->GetBase();
+        if (aura->GetCasterGUID() != unit->GetGUID() && (reachesOut(aura->GetOwner()) || reachesOut(aura->GetCaster())))
+            return false;
+    }
+
+    // owned auras tick during the update: periodic triggers and area auras act within their radius
+    for (auto const& [spellId, aura] : unit->GetOwnedAuras())
+    {
+        if (aura->GetCasterGUID() != unit->GetGUID() && reachesOut(aura->GetCaster()))
+            return false;
+
+        if (SpellReaches(aura->GetSpellInfo(), Reach))
+            return false;
+
+        for (auto const& [guid, aurApp] : aura->GetApplicationMap())
+            if (reachesOut(aurApp->GetTarget()))
+                return false;
+    }
+
+    for (uint32 i = 0; i < CURRENT_MAX_SPELL; ++i)
+        if (Spell const* spell = unit->GetCurrentSpell(i))
+            if (reachesOut(spell->m_targets.GetObjectTarget()) || SpellReaches(spell->GetSpellInfo(), Reach))
+                return false;
+
+    if (Creature* creature = unit->ToCreature())
+    {
+        //npcbot: bot AI and BotMgr keep state shared by all regions
+        if (creature->IsNPCBotOrPet())
+            return false;
+        //end npcbot
+
+        // scripted AI can search and act on anything on the map
+        if (creature->GetScriptId() || !creature->GetAIName().empty())
+            return false;
+
+        for (uint32 spellId : creature->m_spells)
+            if (spellId && SpellReaches(sSpellMgr->GetSpellInfo(spellId), Reach))
+                return false;
+
+        // the leader moves its members and members pull each other into combat
+        if (CreatureGroup const* formation = creature->GetFormation())
+            for (auto const& [member, formationInfo] : formation->GetMembers())
+                if (reachesOut(member))
+                    return false;
+    }
+
+    return true;
+}
+
+void MapUpdatePartition::BuildRegions(Map const* map, std::vector<WorldObject*> const& roots, float margin, std::vector<MapUpdateRegion>& regions)
+{
+    regions.clear();
+    if (roots.empty())
+        return;
+
+    // areas of two roots in different regions are expanded by half of the margin each, so they must not overlap
+    uint32 const expand = uint32(std::ceil(margin * 0.5f / SIZE_OF_GRID_CELL));
+
+    std::vector<RootArea> areas;
+    areas.reserve(roots.size());
+    for (WorldObject const* root : roots)
+    {
+        RootArea& area = areas.emplace_back();
+        area.Visit = Cell::CalculateCellArea(root->GetPositionX(), root->GetPositionY(), root->GetGridActivationRange());
+        area.Expanded = area.Visit;
+        area.Expanded.low_bound.x_coord = area.Visit.low_bound.x_coord >= expand ? area.Visit.low_bound.x_coord - expand : 0;
+        area.Expanded.low_bound.y_coord = area.Visit.low_bound.y_coord >= expand ? area.Visit.low_bound.y_coord - expand : 0;
+        area.Expanded.high_bound.x_coord += expand;
+        area.Expanded.high_bound.y_coord += expand;
+    }
+
+    std::vector<uint32> parents(roots.size());
+    std::iota(parents.begin(), parents.end(), 0u);
+
+    for (uint32 i = 0; i < roots.size(); ++i)
+        for (uint32 j = i + 1; j < roots.size(); ++j)
+            if (Overlaps(areas[i].Expanded, areas[j].Expanded))
+                parents[FindRoot(parents, j)] = FindRoot(parents, i);
+
+    std::vector<int32> regionIndexes(roots.size(), -1);
+    for (uint32 i = 0; i < roots.size(); ++i)
+    {
+        uint32 parent = FindRoot(parents, i);
+        if (regionIndexes[parent] < 0)
+        {
+            regionIndexes[parent] = int32(regions.size());
+            MapUpdateRegion& region = regions.emplace_back();
+            region.RegionMap = map;
+            region.Reach = margin * 0.5f;
+            region.LowBound = areas[i].Visit.low_bound;
+            region.HighBound = areas[i].Visit.high_bound;
+        }
+
+        MapUpdateRegion& region = regions[regionIndexes[parent]];
+        region.Roots.push_back(roots[i]);
+        region.RootAreas.push_back(areas[i].Visit);
+        region.OwnedAreas.push_back(areas[i].Expanded);
+        region.LowBound.x_coord = std::min(region.LowBound.x_coord, areas[i].Visit.low_bound.x_coord);
+        region.LowBound.y_coord = std::min(region.LowBound.y_coord, areas[i].Visit.low_bound.y_coord);
+        region.HighBound.x_coord = std::max(region.HighBound.x_coord, areas[i].Visit.high_bound.x_coord);
+        region.HighBound.y_coord = std::max(region.HighBound.y_coord, areas[i].Visit.high_bound.y_coord);
+    }
+
+    for (MapUpdateRegion& region : regions)
+        region.VisitedCells.assign((region.HighBound.x_coord - region.LowBound.x_coord + 1) * (region.HighBound.y_coord - region.LowBound.y_coord + 1), false);
+}
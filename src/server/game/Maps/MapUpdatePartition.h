@@ -0,0 +1,70 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_MAP_UPDATE_PARTITION_H
+#define TRINITY_MAP_UPDATE_PARTITION_H
+
+#include "Define.h"
+#include "Cell.h"
+#include <vector>
+
+class Map;
+class WorldObject;
+
+// Group of update roots (players, active objects) of a continent that can be updated
+// independently from all other regions: update areas of two regions are at least
+// MapUpdate.Partition.Margin apart so objects of one region can not reach another one
+struct TC_GAME_API MapUpdateRegion
+{
+    Map const* RegionMap = nullptr;
+    std::vector<WorldObject*> Roots;
+    std::vector<CellArea> RootAreas;        // cells around roots at the time regions were built
+    std::vector<CellArea> OwnedAreas;       // root areas expanded by half of the margin, never overlap with other regions
+    CellCoord LowBound;
+    CellCoord HighBound;
+    std::vector<bool> VisitedCells;
+    std::vector<WorldObject*> MergeUpdates; // objects reaching into other regions, updated after the parallel phase
+    float Reach = 0.0f;                     // half of the margin, farthest distance an object may act on during the parallel phase
+
+    // returns false if cell is outside of the region or was already visited
+    bool MarkCell(uint32 x, uint32 y);
+
+    bool Contains(float x, float y) const;
+    bool Contains(WorldObject const* obj) const;
+
+    // false if the update of obj can touch objects of other regions or state shared by all regions:
+    // victim, combat references, auras cast on or by it, owner and controlled units, current spell targets,
+    // scripts and AI names, spells and auras reaching farther than Reach, npcbots (BotMgr)
+    bool CanUpdateInParallel(WorldObject* obj) const;
+
+    template<class Worker>
+    void ForEachVisitedCell(Worker&& worker) const
+    {
+        uint32 const width = HighBound.x_coord - LowBound.x_coord + 1;
+        for (size_t i = 0; i < VisitedCells.size(); ++i)
+            if (VisitedCells[i])
+                worker(LowBound.x_coord + uint32(i % width), LowBound.y_coord + uint32(i / width));
+    }
+};
+
+namespace MapUpdatePartition
+{
+    TC_GAME_API void BuildRegions(Map const* map, std::vector<WorldObject*> const& roots, float margin, std::vector<MapUpdateRegion>& regions);
+
+}
+
+#endif
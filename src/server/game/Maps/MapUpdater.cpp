@@ -20,6 +20,7 @@
 #include "Map.h"
 #include "Metric.h"
 
+#include <algorithm>
 #include <mutex>
 
 class MapUpdateRequest
@@ -27,29 +28,46 @@ class MapUpdateRequest
     private:
 
         Map& m_map;
-        MapUpdater& m_updater;
         uint32 m_diff;
+        uint32 m_cost;
+        bool m_delayed;
 
     public:
 
-        MapUpdateRequest(Map& m, MapUpdater& u, uint32 d)
-            : m_map(m), m_updater(u), m_diff(d)
+        MapUpdateRequest(Map& m, uint32 d, bool delayed)
+            : m_map(m), m_diff(d), m_cost(m.GetUpdateCost()), m_delayed(delayed)
         {
         }
 
-        void call()
+        uint32 GetCost() const { return m_cost; }
+
+        // returns time spent in Map::Update (or Map::DelayedUpdate) in microseconds
+        uint32 call()
         {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            if (m_delayed)
+            {
+                TC_METRIC_TIMER("map_delayed_update_time_diff", TC_METRIC_TAG("map_id", std::to_string(m_map.GetId())));
+                m_map.DelayedUpdate(m_diff);
+                return uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            }
+
             TC_METRIC_TIMER("map_update_time_diff", TC_METRIC_TAG("map_id", std::to_string(m_map.GetId())));
             m_map.Update (m_diff);
-            m_updater.update_finished();
+            uint32 duration = uint32(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+            m_map.RecordUpdateCost(duration);
+            return duration;
         }
 };
 
 void MapUpdater::activate(size_t num_threads)
 {
+    for (size_t i = 0; i < num_threads; ++i)
+        _workerQueues.push_back(std::make_unique<WorkerQueue>());
+
     for (size_t i = 0; i < num_threads; ++i)
     {
-        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this));
+        _workerThreads.push_back(std::thread(&MapUpdater::WorkerThread, this, i));
     }
 }
 
@@ -59,12 +77,18 @@ void MapUpdater::deactivate()
 
     wait();
 
-    _queue.Cancel();
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _workCondition.notify_all();
+    }
 
     for (auto& thread : _workerThreads)
     {
         thread.join();
     }
+
+    _workerThreads.clear();
+    _workerQueues.clear();
 }
 
 void MapUpdater::wait()
@@ -74,16 +98,54 @@ void MapUpdater::wait()
     while (pending_requests > 0)
         _condition.wait(lock);
 
+    std::chrono::steady_clock::time_point tickStart = _tickStart;
+    _tickStart = std::chrono::steady_clock::time_point();
+
     lock.unlock();
+
+    if (tickStart == std::chrono::steady_clock::time_point())
+        return;
+
+    uint64 elapsed = uint64(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - tickStart).count());
+    for (size_t i = 0; i < _workerQueues.size(); ++i)
+    {
+        WorkerQueue& queue = *_workerQueues[i];
+        uint64 busyTime = queue.BusyTime.exchange(0);
+        uint32 steals = queue.Steals.exchange(0);
+
+        TC_METRIC_VALUE("map_updater_thread_utilization", elapsed ? std::min<uint64>(busyTime * 100 / elapsed, 100) : uint64(0),
+            TC_METRIC_TAG("thread", std::to_string(i)));
+        TC_METRIC_VALUE("map_updater_thread_steals", steals,
+            TC_METRIC_TAG("thread", std::to_string(i)));
+    }
 }
 
 void MapUpdater::schedule_update(Map& map, uint32 diff)
 {
-    std::lock_guard<std::mutex> lock(_lock);
+    schedule_request(new MapUpdateRequest(map, diff, false));
+}
+
+void MapUpdater::schedule_delayed_update(Map& map, uint32 diff)
+{
+    schedule_request(new MapUpdateRequest(map, diff, true));
+}
+
+void MapUpdater::schedule_request(MapUpdateRequest* request)
+{
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+
+        if (!pending_requests)
+            _tickStart = std::chrono::steady_clock::now();
+
+        ++pending_requests;
+    }
 
-    ++pending_requests;
+    push_request(request);
 
-    _queue.Push(new MapUpdateRequest(map, *this, diff));
+    // notified under _lock, a worker can not miss the request between checking _queuedRequests and waiting
+    std::lock_guard<std::mutex> lock(_lock);
+    _workCondition.notify_one();
 }
 
 bool MapUpdater::activated()
@@ -100,23 +162,96 @@ void MapUpdater::update_finished()
     _condition.notify_all();
 }
 
-void MapUpdater::WorkerThread()
+void MapUpdater::push_request(MapUpdateRequest* request)
+{
+    // least loaded worker gets the request (longest processing time first)
+    WorkerQueue* target = _workerQueues.front().get();
+    for (std::unique_ptr<WorkerQueue> const& queue : _workerQueues)
+        if (queue->QueuedCost < target->QueuedCost)
+            target = queue.get();
+
+    std::lock_guard<std::mutex> lock(target->Lock);
+    auto itr = std::find_if(target->Requests.begin(), target->Requests.end(), [request](MapUpdateRequest const* queued)
+    {
+        return queued->GetCost() < request->GetCost();
+    });
+    target->Requests.insert(itr, request);
+    target->QueuedCost += request->GetCost();
+    // changed under the queue lock only, so it never counts a request that is not in a queue
+    ++_queuedRequests;
+}
+
+MapUpdateRequest* MapUpdater::pop_request(size_t workerIndex)
+{
+    auto popFront = [this](WorkerQueue& queue) -> MapUpdateRequest*
+    {
+        std::lock_guard<std::mutex> lock(queue.Lock);
+        if (queue.Requests.empty())
+            return nullptr;
+
+        MapUpdateRequest* request = queue.Requests.front();
+        queue.Requests.pop_front();
+        queue.QueuedCost -= request->GetCost();
+        --_queuedRequests;
+        return request;
+    };
+
+    if (MapUpdateRequest* request = popFront(*_workerQueues[workerIndex]))
+        return request;
+
+    if (!_queuedRequests)
+        return nullptr;
+
+    // own queue is empty, steal the most expensive pending map from the busiest worker
+    WorkerQueue* victim = nullptr;
+    for (std::unique_ptr<WorkerQueue> const& queue : _workerQueues)
+        if (queue.get() != _workerQueues[workerIndex].get() && (!victim || queue->QueuedCost > victim->QueuedCost))
+            victim = queue.get();
+
+    if (!victim)
+        return nullptr;
+
+    if (MapUpdateRequest* request = popFront(*victim))
+    {
+        ++_workerQueues[workerIndex]->Steals;
+        return request;
+    }
+
+    // costs may be zero for maps that were never updated yet, scan every queue before giving up,
+    // the caller waits for _workCondition when nothing is left
+    for (std::unique_ptr<WorkerQueue> const& queue : _workerQueues)
+        if (MapUpdateRequest* request = popFront(*queue))
+            return request;
+
+    return nullptr;
+}
+
+void MapUpdater::WorkerThread(size_t workerIndex)
 {
     LoginDatabase.WarnAboutSyncQueries(true);
     CharacterDatabase.WarnAboutSyncQueries(true);
     WorldDatabase.WarnAboutSyncQueries(true);
 
+    WorkerQueue& queue = *_workerQueues[workerIndex];
+
     while (true)
     {
-        MapUpdateRequest* request = nullptr;
+        MapUpdateRequest* request = pop_request(workerIndex);
+        if (!request)
+        {
+            std::unique_lock<std::mutex> lock(_lock);
+            _workCondition.wait(lock, [this] { return _queuedRequests > 0 || _cancelationToken; });
 
-        _queue.WaitAndPop(request);
+            if (_cancelationToken && !_queuedRequests)
+                return;
 
-        if (_cancelationToken)
-            return;
+            continue;
+        }
 
-        request->call();
+        queue.BusyTime += request->call();
 
         delete request;
+
+        update_finished();
     }
 }
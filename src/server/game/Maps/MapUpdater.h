@@ -19,10 +19,14 @@
 #define _MAP_UPDATER_H_INCLUDED
 
 #include "Define.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <thread>
-#include <condition_variable>
-#include "ProducerConsumerQueue.h"
+#include <vector>
 
 class MapUpdateRequest;
 class Map;
@@ -31,13 +35,17 @@ class TC_GAME_API MapUpdater
 {
     public:
 
-        MapUpdater() : _cancelationToken(false), pending_requests(0) {}
+        MapUpdater() : _cancelationToken(false), _queuedRequests(0), pending_requests(0) {}
         ~MapUpdater() { };
 
         friend class MapUpdateRequest;
 
         void schedule_update(Map& map, uint32 diff);
 
+        // Map::DelayedUpdate of scheduled maps runs in parallel as well, work touching other maps
+        // must be queued with MapManager::AddDelayedCrossMapOperation
+        void schedule_delayed_update(Map& map, uint32 diff);
+
         void wait();
 
         void activate(size_t num_threads);
@@ -48,18 +56,37 @@ class TC_GAME_API MapUpdater
 
     private:
 
-        ProducerConsumerQueue<MapUpdateRequest*> _queue;
+        // Every worker owns a queue kept sorted by descending map update cost,
+        // idle workers steal the most expensive pending request from other queues
+        struct WorkerQueue
+        {
+            WorkerQueue() : QueuedCost(0), BusyTime(0), Steals(0) { }
 
+            std::mutex Lock;
+            std::deque<MapUpdateRequest*> Requests;
+            std::atomic<uint64> QueuedCost;
+            std::atomic<uint64> BusyTime;   // microseconds spent in Map::Update since last wait()
+            std::atomic<uint32> Steals;
+        };
+
+        std::vector<std::unique_ptr<WorkerQueue>> _workerQueues;
         std::vector<std::thread> _workerThreads;
         std::atomic<bool> _cancelationToken;
+        std::atomic<size_t> _queuedRequests;
 
         std::mutex _lock;
         std::condition_variable _condition;
+        std::condition_variable _workCondition;
         size_t pending_requests;
+        std::chrono::steady_clock::time_point _tickStart;
 
         void update_finished();
 
-        void WorkerThread();
+        void schedule_request(MapUpdateRequest* request);
+        void push_request(MapUpdateRequest* request);
+        MapUpdateRequest* pop_request(size_t workerIndex);
+
+        void WorkerThread(size_t workerIndex);
 };
 
 #endif //_MAP_UPDATER_H_INCLUDED
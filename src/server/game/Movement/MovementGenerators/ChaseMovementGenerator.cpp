@@ -19,10 +19,12 @@
 #include "Creature.h"
 #include "CreatureAI.h"
 #include "G3DPosition.hpp"
+#include "Map.h"
 #include "MotionMaster.h"
 #include "MoveSpline.h"
 #include "MoveSplineInit.h"
 #include "PathGenerator.h"
+#include "PathRequestQueue.h"
 #include "Unit.h"
 #include "Util.h"
 
@@ -73,7 +75,10 @@ ChaseMovementGenerator::ChaseMovementGenerator(Unit *target, Optional<ChaseRange
     Flags = MOVEMENTGENERATOR_FLAG_INITIALIZATION_PENDING;
     BaseUnitState = UNIT_STATE_CHASE;
 }
-ChaseMovementGenerator::~ChaseMovementGenerator() = default;
+ChaseMovementGenerator::~ChaseMovementGenerator()
+{
+    CancelPathRequest();
+}
 
 void ChaseMovementGenerator::Initialize(Unit* /*owner*/)
 {
@@ -81,6 +86,7 @@ void ChaseMovementGenerator::Initialize(Unit* /*owner*/)
     AddFlag(MOVEMENTGENERATOR_FLAG_INITIALIZED | MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
 
     _path = nullptr;
+    CancelPathRequest();
     _lastTargetPosition.reset();
 }
 
@@ -107,6 +113,7 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
     {
         owner->StopMoving();
         _lastTargetPosition.reset();
+        CancelPathRequest();
         if (Creature* cOwner = owner->ToCreature())
             cOwner->SetCannotReachTarget(false);
         return true;
@@ -129,6 +136,7 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
         {
             RemoveFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
             _path = nullptr;
+            CancelPathRequest();
             if (Creature* cOwner = owner->ToCreature())
                 cOwner->SetCannotReachTarget(false);
             owner->StopMoving();
@@ -150,6 +158,18 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
         DoMovementInform(owner, target);
     }
 
+    // a path requested on a previous update is ready, until then we keep moving on the current one
+    if (_pathRequest)
+    {
+        if (!_pathRequest->IsReady())
+            return true;
+
+        bool const calculated = _pathRequest->TakeResult(_path);
+        _pathRequest = nullptr;
+        LaunchPath(owner, target, calculated, _pathRequestShorten, maxTarget);
+        return true;
+    }
+
     // if the target moved, we have to consider whether to adjust
     if (!_lastTargetPosition || target->GetPosition() != _lastTargetPosition.value() || mutualChase != _mutualChase)
     {
@@ -193,50 +213,73 @@ bool ChaseMovementGenerator::Update(Unit* owner, uint32 diff)
             if (owner->IsHovering())
                 owner->UpdateAllowedPositionZ(x, y, z);
 
-            bool success = _path->CalculatePath(x, y, z, owner->CanFly());
-            if (!success || (_path->GetPathType() & (PATHFIND_NOPATH /* | PATHFIND_INCOMPLETE*/)))
+            // ...or let the map calculate it at the end of its update
+            if (PathRequestQueue* pathRequests = owner->GetMap()->GetPathRequestQueue())
             {
-                if (cOwner)
-                    cOwner->SetCannotReachTarget(true);
-                owner->StopMoving();
+                _pathRequest = pathRequests->Enqueue(std::move(_path), x, y, z, owner->CanFly());
+                _pathRequestShorten = shortenPath;
                 return true;
             }
 
-            if (shortenPath)
-                _path->ShortenPathUntilDist(PositionToVector3(target), maxTarget);
+            bool const calculated = _path->CalculatePath(x, y, z, owner->CanFly());
+            LaunchPath(owner, target, calculated, shortenPath, maxTarget);
+        }
+    }
 
-            if (cOwner)
-                cOwner->SetCannotReachTarget(false);
+    // and then, finally, we're done for the tick
+    return true;
+}
 
-            bool walk = false;
-            if (cOwner && !cOwner->IsPet())
-            {
-                switch (cOwner->GetMovementTemplate().GetChase())
-                {
-                    case CreatureChaseMovementType::CanWalk:
-                        walk = owner->IsWalking();
-                        break;
-                    case CreatureChaseMovementType::AlwaysWalk:
-                        walk = true;
-                        break;
-                    default:
-                        break;
-                }
-            }
+void ChaseMovementGenerator::LaunchPath(Unit* owner, Unit* target, bool calculated, bool shortenPath, float maxTarget)
+{
+    Creature* const cOwner = owner->ToCreature();
+    if (!calculated || (_path->GetPathType() & (PATHFIND_NOPATH /* | PATHFIND_INCOMPLETE*/)))
+    {
+        if (cOwner)
+            cOwner->SetCannotReachTarget(true);
+        owner->StopMoving();
+        return;
+    }
 
-            owner->AddUnitState(UNIT_STATE_CHASE_MOVE);
-            AddFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
+    if (shortenPath)
+        _path->ShortenPathUntilDist(PositionToVector3(target), maxTarget);
 
-            Movement::MoveSplineInit init(owner);
-            init.MovebyPath(_path->GetPath());
-            init.SetWalk(walk);
-            init.SetFacing(target);
-            init.Launch();
+    if (cOwner)
+        cOwner->SetCannotReachTarget(false);
+
+    bool walk = false;
+    if (cOwner && !cOwner->IsPet())
+    {
+        switch (cOwner->GetMovementTemplate().GetChase())
+        {
+            case CreatureChaseMovementType::CanWalk:
+                walk = owner->IsWalking();
+                break;
+            case CreatureChaseMovementType::AlwaysWalk:
+                walk = true;
+                break;
+            default:
+                break;
         }
     }
 
-    // and then, finally, we're done for the tick
-    return true;
+    owner->AddUnitState(UNIT_STATE_CHASE_MOVE);
+    AddFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
+
+    Movement::MoveSplineInit init(owner);
+    init.MovebyPath(_path->GetPath());
+    init.SetWalk(walk);
+    init.SetFacing(target);
+    init.Launch();
+}
+
+void ChaseMovementGenerator::CancelPathRequest()
+{
+    if (!_pathRequest)
+        return;
+
+    _pathRequest->Cancel();
+    _pathRequest = nullptr;
 }
 
 void ChaseMovementGenerator::Deactivate(Unit* owner)
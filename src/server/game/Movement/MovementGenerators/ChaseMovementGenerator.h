@@ -26,6 +26,7 @@
 #include "Timer.h"
 
 class PathGenerator;
+class PathRequest;
 class Unit;
 
 class ChaseMovementGenerator : public MovementGenerator, public AbstractFollower
@@ -46,10 +47,15 @@ class ChaseMovementGenerator : public MovementGenerator, public AbstractFollower
     private:
         static constexpr uint32 RANGE_CHECK_INTERVAL = 100; // time (ms) until we attempt to recalculate
 
+        void LaunchPath(Unit* owner, Unit* target, bool calculated, bool shortenPath, float maxTarget);
+        void CancelPathRequest();
+
         Optional<ChaseRange> const _range;
         Optional<ChaseAngle> const _angle;
 
         std::unique_ptr<PathGenerator> _path;
+        std::shared_ptr<PathRequest> _pathRequest;  // _path is owned by the request until it is ready
+        bool _pathRequestShorten = false;
         Optional<Position> _lastTargetPosition;
         TimeTracker _rangeCheckTimer;
         bool _movingTowards = true;
@@ -18,10 +18,12 @@
 #include "FollowMovementGenerator.h"
 #include "Creature.h"
 #include "CreatureAI.h"
+#include "Map.h"
 #include "MoveSpline.h"
 #include "MoveSplineInit.h"
 #include "Optional.h"
 #include "PathGenerator.h"
+#include "PathRequestQueue.h"
 #include "Pet.h"
 #include "Unit.h"
 #include "Util.h"
@@ -42,7 +44,10 @@ FollowMovementGenerator::FollowMovementGenerator(Unit* target, float range, Chas
     Flags = MOVEMENTGENERATOR_FLAG_INITIALIZATION_PENDING;
     BaseUnitState = UNIT_STATE_FOLLOW;
 }
-FollowMovementGenerator::~FollowMovementGenerator() = default;
+FollowMovementGenerator::~FollowMovementGenerator()
+{
+    CancelPathRequest();
+}
 
 static bool PositionOkay(Unit* owner, Unit* target, float range, Optional<ChaseAngle> angle = {})
 {
@@ -60,6 +65,7 @@ void FollowMovementGenerator::Initialize(Unit* owner)
     owner->StopMoving();
     UpdatePetSpeed(owner);
     _path = nullptr;
+    CancelPathRequest();
     _lastTargetPosition.reset();
 }
 
@@ -84,6 +90,7 @@ bool FollowMovementGenerator::Update(Unit* owner, uint32 diff)
     if (owner->HasUnitState(UNIT_STATE_NOT_MOVE) || owner->IsMovementPreventedByCasting())
     {
         _path = nullptr;
+        CancelPathRequest();
         owner->StopMoving();
         _lastTargetPosition.reset();
         return true;
@@ -97,6 +104,7 @@ bool FollowMovementGenerator::Update(Unit* owner, uint32 diff)
         {
             RemoveFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
             _path = nullptr;
+            CancelPathRequest();
             owner->StopMoving();
             _lastTargetPosition.reset();
             DoMovementInform(owner, target);
@@ -112,6 +120,18 @@ bool FollowMovementGenerator::Update(Unit* owner, uint32 diff)
         DoMovementInform(owner, target);
     }
 
+    // a path requested on a previous update is ready, until then we keep moving on the current one
+    if (_pathRequest)
+    {
+        if (!_pathRequest->IsReady())
+            return true;
+
+        bool const calculated = _pathRequest->TakeResult(_path);
+        _pathRequest = nullptr;
+        LaunchPath(owner, target, calculated);
+        return true;
+    }
+
     if (!_lastTargetPosition || _lastTargetPosition->GetExactDistSq(target->GetPosition()) > 0.0f)
     {
         _lastTargetPosition = target->GetPosition();
@@ -150,26 +170,47 @@ bool FollowMovementGenerator::Update(Unit* owner, uint32 diff)
                     allowShortcut = true;
             }
 
-            bool success = _path->CalculatePath(x, y, z, allowShortcut);
-            if (!success || (_path->GetPathType() & PATHFIND_NOPATH))
+            // let the map calculate the path at the end of its update
+            if (PathRequestQueue* pathRequests = owner->GetMap()->GetPathRequestQueue())
             {
-                owner->StopMoving();
+                _pathRequest = pathRequests->Enqueue(std::move(_path), x, y, z, allowShortcut);
                 return true;
             }
 
-            owner->AddUnitState(UNIT_STATE_FOLLOW_MOVE);
-            AddFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
-
-            Movement::MoveSplineInit init(owner);
-            init.MovebyPath(_path->GetPath());
-            init.SetWalk(target->IsWalking());
-            init.SetFacing(target->GetOrientation());
-            init.Launch();
+            bool const calculated = _path->CalculatePath(x, y, z, allowShortcut);
+            LaunchPath(owner, target, calculated);
         }
     }
     return true;
 }
 
+void FollowMovementGenerator::LaunchPath(Unit* owner, Unit* target, bool calculated)
+{
+    if (!calculated || (_path->GetPathType() & PATHFIND_NOPATH))
+    {
+        owner->StopMoving();
+        return;
+    }
+
+    owner->AddUnitState(UNIT_STATE_FOLLOW_MOVE);
+    AddFlag(MOVEMENTGENERATOR_FLAG_INFORM_ENABLED);
+
+    Movement::MoveSplineInit init(owner);
+    init.MovebyPath(_path->GetPath());
+    init.SetWalk(target->IsWalking());
+    init.SetFacing(target->GetOrientation());
+    init.Launch();
+}
+
+void FollowMovementGenerator::CancelPathRequest()
+{
+    if (!_pathRequest)
+        return;
+
+    _pathRequest->Cancel();
+    _pathRequest = nullptr;
+}
+
 void FollowMovementGenerator::Deactivate(Unit* owner)
 {
     AddFlag(MOVEMENTGENERATOR_FLAG_DEACTIVATED);
@@ -26,6 +26,7 @@
 #include "Timer.h"
 
 class PathGenerator;
+class PathRequest;
 class Unit;
 
 #define FOLLOW_RANGE_TOLERANCE 1.0f
@@ -49,12 +50,15 @@ class FollowMovementGenerator : public MovementGenerator, public AbstractFollowe
         static constexpr uint32 CHECK_INTERVAL = 100;
 
         void UpdatePetSpeed(Unit* owner);
+        void LaunchPath(Unit* owner, Unit* target, bool calculated);
+        void CancelPathRequest();
 
         float const _range;
         ChaseAngle const _angle;
 
         TimeTracker _checkTimer;
         std::unique_ptr<PathGenerator> _path;
+        std::shared_ptr<PathRequest> _pathRequest;  // _path is owned by the request until it is ready
         Optional<Position> _lastTargetPosition;
 };
 
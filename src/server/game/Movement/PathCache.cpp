@@ -0,0 +1,79 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathCache.h"
+#include "Hash.h"
+
+std::size_t PathCache::KeyHash::operator()(PathCacheKey const& key) const
+{
+    std::size_t hashVal = 0;
+    Trinity::hash_combine(hashVal, key.StartPoly);
+    Trinity::hash_combine(hashVal, key.EndPoly);
+    Trinity::hash_combine(hashVal, (uint32(key.IncludeFlags) << 16) | key.ExcludeFlags);
+    return hashVal;
+}
+
+PathCache::PathCache(uint32 capacity) : _capacity(capacity)
+{
+    _lookup.reserve(capacity);
+}
+
+void PathCache::Store(PathCacheKey const& key, dtPolyRef const* polys, uint32 count)
+{
+    if (!_capacity || !count)
+        return;
+
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto itr = _lookup.find(key);
+    if (itr != _lookup.end())
+    {
+        // another unit found the same corridor meanwhile
+        itr->second->Polys.assign(polys, polys + count);
+        _entries.splice(_entries.begin(), _entries, itr->second);
+        return;
+    }
+
+    if (_entries.size() >= _capacity)
+    {
+        // reuse least recently used entry and its storage
+        _lookup.erase(_entries.back().Key);
+        _entries.splice(_entries.begin(), _entries, std::prev(_entries.end()));
+        ++_stats.Evictions;
+    }
+    else
+        _entries.emplace_front();
+
+    Entry& entry = _entries.front();
+    entry.Key = key;
+    entry.Polys.assign(polys, polys + count);
+    _lookup.emplace(key, _entries.begin());
+}
+
+std::size_t PathCache::GetSize() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _entries.size();
+}
+
+PathCacheStats PathCache::ConsumeStats()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    PathCacheStats stats = _stats;
+    _stats = PathCacheStats();
+    return stats;
+}
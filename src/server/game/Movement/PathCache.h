@@ -0,0 +1,130 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PATH_CACHE_H
+#define TRINITY_PATH_CACHE_H
+
+#include "Define.h"
+#include "DetourNavMesh.h"
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+struct PathCacheKey
+{
+    dtPolyRef StartPoly;
+    dtPolyRef EndPoly;
+    uint16 IncludeFlags;
+    uint16 ExcludeFlags;
+
+    bool operator==(PathCacheKey const& right) const
+    {
+        return StartPoly == right.StartPoly && EndPoly == right.EndPoly
+            && IncludeFlags == right.IncludeFlags && ExcludeFlags == right.ExcludeFlags;
+    }
+};
+
+struct PathCacheStats
+{
+    uint32 Hits = 0;
+    uint32 Misses = 0;
+    uint32 Evictions = 0;
+};
+
+// Bounded LRU of poly corridors found by dtNavMeshQuery::findPath, one per map (mmap.PathCache.Size).
+// Units following or chasing the same target keep asking for a path between the same two polygons,
+// the corridor only depends on the polygons and the filter so destination may move inside its polygon.
+// Point path is still built from exact positions by PathGenerator.
+class TC_GAME_API PathCache
+{
+    public:
+        explicit PathCache(uint32 capacity);
+
+        PathCache(PathCache const&) = delete;
+        PathCache& operator=(PathCache const&) = delete;
+
+        // copies cached corridor to polys and returns its length, 0 if not found
+        // isValid(dtPolyRef) is checked for every polygon, entries with stale polygons (reloaded tiles) are dropped
+        template<class Validator>
+        uint32 Find(PathCacheKey const& key, dtPolyRef* polys, uint32 maxPolys, Validator&& isValid);
+
+        void Store(PathCacheKey const& key, dtPolyRef const* polys, uint32 count);
+
+        std::size_t GetSize() const;
+
+        // returns counters since last call
+        PathCacheStats ConsumeStats();
+
+    private:
+        struct KeyHash
+        {
+            std::size_t operator()(PathCacheKey const& key) const;
+        };
+
+        struct Entry
+        {
+            PathCacheKey Key;
+            std::vector<dtPolyRef> Polys;
+        };
+
+        typedef std::list<Entry> EntryList;
+
+        uint32 _capacity;
+        EntryList _entries;                                 // most recently used first
+        std::unordered_map<PathCacheKey, EntryList::iterator, KeyHash> _lookup;
+        PathCacheStats _stats;
+
+        // cells of a continent may be updated from several threads, see Map::UpdateRegions
+        mutable std::mutex _lock;
+};
+
+template<class Validator>
+uint32 PathCache::Find(PathCacheKey const& key, dtPolyRef* polys, uint32 maxPolys, Validator&& isValid)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+
+    auto itr = _lookup.find(key);
+    if (itr == _lookup.end())
+    {
+        ++_stats.Misses;
+        return 0;
+    }
+
+    EntryList::iterator entry = itr->second;
+    for (dtPolyRef poly : entry->Polys)
+    {
+        if (!isValid(poly))
+        {
+            _lookup.erase(itr);
+            _entries.erase(entry);
+            ++_stats.Misses;
+            ++_stats.Evictions;
+            return 0;
+        }
+    }
+
+    _entries.splice(_entries.begin(), _entries, entry);
+
+    uint32 count = std::min<uint32>(uint32(entry->Polys.size()), maxPolys);
+    std::copy_n(entry->Polys.begin(), count, polys);
+    ++_stats.Hits;
+    return count;
+}
+
+#endif
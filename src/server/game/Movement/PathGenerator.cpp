@@ -21,6 +21,7 @@
 #include "MMapFactory.h"
 #include "MMapManager.h"
 #include "Log.h"
+#include "PathCache.h"
 #include "DisableMgr.h"
 #include "DetourCommon.h"
 #include "DetourNavMeshQuery.h"
@@ -71,6 +72,10 @@ bool PathGenerator::CalculatePath(float destX, float destY, float destZ, bool fo
 
     _forceDestination = forceDest;
 
+    // queries belong to threads and neither maps nor path requests are always calculated by the same one
+    if (_navMeshQuery)
+        _navMeshQuery = MMAP::MMapFactory::createOrGetMMapManager()->GetThreadNavMeshQuery(_source->GetMapId());
+
     TC_LOG_DEBUG("maps.mmaps", "++ PathGenerator::CalculatePath() for {}", _source->GetGUID().ToString());
 
     // make sure navMesh works - we can run on map w/o mmap
@@ -493,15 +498,28 @@ void PathGenerator::BuildPolyPath(G3D::Vector3 const& startPos, G3D::Vector3 con
         }
         else
         {
-            dtResult = _navMeshQuery->findPath(
-                            startPoly,          // start polygon
-                            endPoly,            // end polygon
-                            startPoint,         // start position
-                            endPoint,           // end position
-                            &_filter,           // polygon search filter
-                            _pathPolyRefs,     // [out] path
-                            (int*)&_polyLength,
-                            MAX_PATH_LENGTH);   // max number of polygons in output path
+            PathCache* pathCache = _source->GetMap()->GetPathCache();
+            PathCacheKey cacheKey = { startPoly, endPoly, _filter.getIncludeFlags(), _filter.getExcludeFlags() };
+            if (pathCache)
+                _polyLength = pathCache->Find(cacheKey, _pathPolyRefs, MAX_PATH_LENGTH, [this](dtPolyRef poly) { return _navMesh->isValidPolyRef(poly); });
+
+            if (_polyLength)
+                dtResult = DT_SUCCESS;
+            else
+            {
+                dtResult = _navMeshQuery->findPath(
+                                startPoly,          // start polygon
+                                endPoly,            // end polygon
+                                startPoint,         // start position
+                                endPoint,           // end position
+                                &_filter,           // polygon search filter
+                                _pathPolyRefs,     // [out] path
+                                (int*)&_polyLength,
+                                MAX_PATH_LENGTH);   // max number of polygons in output path
+
+                if (pathCache && _polyLength && dtStatusSucceed(dtResult))
+                    pathCache->Store(cacheKey, _pathPolyRefs, _polyLength);
+            }
         }
 
         if (!_polyLength || dtStatusFailed(dtResult))
@@ -100,7 +100,7 @@ class TC_GAME_API PathGenerator
 
         WorldObject const* const _source;       // the object that is moving
         dtNavMesh const* _navMesh;              // the nav mesh
-        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path
+        dtNavMeshQuery const* _navMeshQuery;    // the nav mesh query used to find the path, owned by the calculating thread
 
         dtQueryFilter _filter;  // use single filter for all movements, update it when needed
 
@@ -0,0 +1,109 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PathRequestQueue.h"
+#include "PathGenerator.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+PathRequest::PathRequest(std::unique_ptr<PathGenerator> path, G3D::Vector3 const& dest, bool forceDest) : _path(std::move(path)), _dest(dest), _forceDest(forceDest),
+    _cancelled(false), _result(_promise.get_future())
+{
+}
+
+PathRequest::~PathRequest() = default;
+
+void PathRequest::Cancel()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    _cancelled.store(true, std::memory_order_relaxed);
+    _path = nullptr;
+}
+
+bool PathRequest::TakeResult(std::unique_ptr<PathGenerator>& path)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    path = std::move(_path);
+    return _result.get();
+}
+
+void PathRequest::Calculate()
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    bool const calculated = _path && _path->CalculatePath(_dest.x, _dest.y, _dest.z, _forceDest);
+    _promise.set_value(calculated);
+}
+
+void PathRequest::Fail()
+{
+    _promise.set_value(false);
+}
+
+PathRequestQueue::PathRequestQueue() = default;
+
+PathRequestQueue::~PathRequestQueue()
+{
+    // nobody will calculate these anymore, requesters get NOPATH
+    for (std::shared_ptr<PathRequest> const& request : _requests)
+        request->Fail();
+}
+
+std::shared_ptr<PathRequest> PathRequestQueue::Enqueue(std::unique_ptr<PathGenerator> path, float x, float y, float z, bool forceDest)
+{
+    std::shared_ptr<PathRequest> request = std::make_shared<PathRequest>(std::move(path), G3D::Vector3(x, y, z), forceDest);
+
+    std::lock_guard<std::mutex> lock(_lock);
+    _requests.push_back(request);
+    return request;
+}
+
+uint32 PathRequestQueue::Process(Trinity::ThreadPool& pool, uint32 threads)
+{
+    std::vector<std::shared_ptr<PathRequest>> requests;
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        requests.swap(_requests);
+    }
+
+    std::erase_if(requests, [](std::shared_ptr<PathRequest> const& request) { return request->IsCancelled(); });
+    if (requests.empty())
+        return 0;
+
+    std::atomic<std::size_t> next(0);
+    auto calculate = [&requests, &next]()
+    {
+        for (std::size_t i = next++; i < requests.size(); i = next++)
+            requests[i]->Calculate();
+    };
+
+    std::size_t const tasks = std::min<std::size_t>(threads, requests.size() - 1);
+    std::vector<std::future<void>> pendingTasks;
+    pendingTasks.reserve(tasks);
+    for (std::size_t i = 0; i < tasks; ++i)
+    {
+        auto task = std::make_shared<std::packaged_task<void()>>(calculate);
+        pendingTasks.push_back(task->get_future());
+        pool.PostWork([task]() { (*task)(); });
+    }
+
+    calculate();
+
+    for (std::future<void>& pending : pendingTasks)
+        pending.get();
+
+    return uint32(requests.size());
+}
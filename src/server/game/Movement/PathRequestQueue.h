@@ -0,0 +1,96 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRINITY_PATH_REQUEST_QUEUE_H
+#define TRINITY_PATH_REQUEST_QUEUE_H
+
+#include "Define.h"
+#include <G3D/Vector3.h>
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class PathGenerator;
+
+namespace Trinity
+{
+    class ThreadPool;
+}
+
+// Path queued by a movement generator, the generator hands its PathGenerator over
+// and gets it back with the result of PathGenerator::CalculatePath once the request is ready
+class TC_GAME_API PathRequest
+{
+    public:
+        PathRequest(std::unique_ptr<PathGenerator> path, G3D::Vector3 const& dest, bool forceDest);
+        ~PathRequest();
+
+        PathRequest(PathRequest const&) = delete;
+        PathRequest& operator=(PathRequest const&) = delete;
+
+        bool IsReady() const { return _result.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }
+        bool IsCancelled() const { return _cancelled.load(std::memory_order_relaxed); }
+
+        // requester no longer waits for the path (movement generator removed), path generator is destroyed here
+        void Cancel();
+
+        // only valid once IsReady(), returns result of PathGenerator::CalculatePath
+        bool TakeResult(std::unique_ptr<PathGenerator>& path);
+
+    private:
+        friend class PathRequestQueue;
+
+        void Calculate();
+        void Fail();
+
+        std::mutex _lock;
+        std::unique_ptr<PathGenerator> _path;
+        G3D::Vector3 _dest;
+        bool _forceDest;
+        std::atomic<bool> _cancelled;
+        std::promise<bool> _promise;
+        std::future<bool> _result;
+};
+
+// Paths requested by movement generators of a map during its update (mmap.AsyncPathfinding.Threads).
+// Requests are calculated in one batch once all objects of the map are updated, so owners and
+// targets do not move while worker threads read their state. Every worker uses its own
+// dtNavMeshQuery (MMapManager::GetThreadNavMeshQuery) since those are not thread safe.
+class TC_GAME_API PathRequestQueue
+{
+    public:
+        PathRequestQueue();
+        ~PathRequestQueue();
+
+        PathRequestQueue(PathRequestQueue const&) = delete;
+        PathRequestQueue& operator=(PathRequestQueue const&) = delete;
+
+        // can be called from region update threads
+        std::shared_ptr<PathRequest> Enqueue(std::unique_ptr<PathGenerator> path, float x, float y, float z, bool forceDest);
+
+        // calculates all queued paths using calling thread and up to threads pool threads, returns number of calculated paths
+        // must not be called while objects of the map are updated
+        uint32 Process(Trinity::ThreadPool& pool, uint32 threads);
+
+    private:
+        std::mutex _lock;
+        std::vector<std::shared_ptr<PathRequest>> _requests;
+};
+
+#endif
@@ -64,6 +64,8 @@ namespace WorldPackets
 
         WorldPacket const* Write() override final;
 
+        WorldPacket&& Move() { return std::move(_worldPacket); }
+
         OpcodeClient GetOpcode() const { return OpcodeClient(_worldPacket.GetOpcode()); }
     };
 }
@@ -74,7 +74,7 @@ namespace WorldPackets
             std::string GuildName;
         };
 
-        class GuildGetInfo final : ClientPacket
+        class GuildGetInfo final : public ClientPacket
         {
         public:
             GuildGetInfo(WorldPacket&& packet) : ClientPacket(CMSG_GUILD_INFO, std::move(packet)) { }
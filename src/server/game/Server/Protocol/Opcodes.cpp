@@ -17,11 +17,20 @@
 
 #include "Opcodes.h"
 #include "Log.h"
+#include "Metric.h"
 #include "WorldSession.h"
 #include "Packets/AllPackets.h"
 #include <iomanip>
 #include <sstream>
 
+namespace
+{
+    uint64 GetElapsedNanoseconds(TimePoint start)
+    {
+        return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+}
+
 template<class PacketClass, void(WorldSession::*HandlerFunction)(PacketClass&)>
 class PacketHandler : public ClientOpcodeHandler
 {
@@ -30,9 +39,54 @@ public:
 
     void Call(WorldSession* session, WorldPacket& packet) const override
     {
+        TimeStats.Packets.fetch_add(1, std::memory_order_relaxed);
+
+        if (PacketClass* decoded = static_cast<PacketClass*>(packet.GetDecoded()))
+        {
+            TimePoint handlerStart = std::chrono::steady_clock::now();
+            (session->*HandlerFunction)(*decoded);
+            TimeStats.HandlerTime.fetch_add(GetElapsedNanoseconds(handlerStart), std::memory_order_relaxed);
+
+            packet.rpos(packet.GetDecodedReadPos());
+            return;
+        }
+
+        TimePoint parseStart = std::chrono::steady_clock::now();
         PacketClass nicePacket(std::move(packet));
         nicePacket.Read();
+        TimeStats.ParseTime.fetch_add(GetElapsedNanoseconds(parseStart), std::memory_order_relaxed);
+
+        TimePoint handlerStart = std::chrono::steady_clock::now();
         (session->*HandlerFunction)(nicePacket);
+        TimeStats.HandlerTime.fetch_add(GetElapsedNanoseconds(handlerStart), std::memory_order_relaxed);
+    }
+
+    void PreDecode(WorldPacket& packet) const override
+    {
+        TimePoint parseStart = std::chrono::steady_clock::now();
+
+        // storage is only lent to the typed packet for Read(), the raw packet gets it back
+        // unchanged for script hooks, anti-DoS checks and error logging on the world thread
+        std::shared_ptr<PacketClass> decoded = std::make_shared<PacketClass>(std::move(packet));
+        bool read = false;
+        try
+        {
+            decoded->Read();
+            read = true;
+        }
+        catch (ByteBufferException const&)
+        {
+        }
+
+        packet = decoded->Move();
+        if (read)
+        {
+            packet.SetDecoded(std::move(decoded), packet.rpos());
+            TimeStats.PreDecodedPackets.fetch_add(1, std::memory_order_relaxed);
+        }
+        packet.rpos(0);
+
+        TimeStats.ParseTime.fetch_add(GetElapsedNanoseconds(parseStart), std::memory_order_relaxed);
     }
 };
 
@@ -44,7 +98,11 @@ public:
 
     void Call(WorldSession* session, WorldPacket& packet) const override
     {
+        TimeStats.Packets.fetch_add(1, std::memory_order_relaxed);
+
+        TimePoint handlerStart = std::chrono::steady_clock::now();
         (session->*HandlerFunction)(packet);
+        TimeStats.HandlerTime.fetch_add(GetElapsedNanoseconds(handlerStart), std::memory_order_relaxed);
     }
 };
 
@@ -1470,3 +1528,25 @@ std::string GetOpcodeNameForLogging(Opcodes opcode)
 {
     return GetOpcodeNameForLoggingImpl(opcode);
 }
+
+void LogOpcodeTimeStats()
+{
+    for (uint16 i = 0; i < NUM_OPCODE_HANDLERS; ++i)
+    {
+        ClientOpcodeHandler const* handler = opcodeTable[Opcodes(i)];
+        if (!handler)
+            continue;
+
+        uint64 packets = handler->TimeStats.Packets.exchange(0, std::memory_order_relaxed);
+        uint64 preDecodedPackets = handler->TimeStats.PreDecodedPackets.exchange(0, std::memory_order_relaxed);
+        [[maybe_unused]] uint64 parseTime = handler->TimeStats.ParseTime.exchange(0, std::memory_order_relaxed);
+        [[maybe_unused]] uint64 handlerTime = handler->TimeStats.HandlerTime.exchange(0, std::memory_order_relaxed);
+        if (!packets && !preDecodedPackets)
+            continue;
+
+        TC_METRIC_VALUE("worldsession_opcode_packets", packets, TC_METRIC_TAG("opcode", handler->Name));
+        TC_METRIC_VALUE("worldsession_opcode_predecoded_packets", preDecodedPackets, TC_METRIC_TAG("opcode", handler->Name));
+        TC_METRIC_VALUE("worldsession_opcode_parse_time", parseTime / 1000, TC_METRIC_TAG("opcode", handler->Name));
+        TC_METRIC_VALUE("worldsession_opcode_handler_time", handlerTime / 1000, TC_METRIC_TAG("opcode", handler->Name));
+    }
+}
@@ -23,6 +23,7 @@
 #define _OPCODES_H
 
 #include "Define.h"
+#include <atomic>
 #include <string>
 
 enum Opcodes : uint16
@@ -1370,6 +1371,15 @@ enum PacketProcessing
 class WorldSession;
 class WorldPacket;
 
+// time spent reading packets of an opcode and running its handler, in nanoseconds
+struct OpcodeTimeStats
+{
+    std::atomic<uint64> Packets{ 0 };
+    std::atomic<uint64> PreDecodedPackets{ 0 };             // packets read by network threads
+    std::atomic<uint64> ParseTime{ 0 };                     // only measured for typed packets, raw handlers read inside handler time
+    std::atomic<uint64> HandlerTime{ 0 };
+};
+
 class OpcodeHandler
 {
 public:
@@ -1388,7 +1398,12 @@ public:
 
     virtual void Call(WorldSession* session, WorldPacket& packet) const = 0;
 
+    // Reads typed packets on network threads and attaches the result to packet (Network.PreDecodePackets),
+    // Call only applies it to game state. Malformed packets are left alone and fail in Call as usual.
+    virtual void PreDecode(WorldPacket& /*packet*/) const { }
+
     PacketProcessing ProcessingPlace;
+    mutable OpcodeTimeStats TimeStats;
 };
 
 class ServerOpcodeHandler : public OpcodeHandler
@@ -1429,5 +1444,8 @@ extern OpcodeTable opcodeTable;
 /// Lookup opcode name for human understandable logging
 std::string GetOpcodeNameForLogging(Opcodes opcode);
 
+/// Sends parse and handler times of client opcodes received since last call to metrics
+TC_GAME_API void LogOpcodeTimeStats();
+
 #endif
 /// @}
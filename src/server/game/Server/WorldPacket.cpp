@@ -0,0 +1,48 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "WorldPacket.h"
+#include "ByteBufferPool.h"
+#include <array>
+#include <atomic>
+
+namespace
+{
+    std::array<std::atomic<uint32>, NUM_MSG_TYPES> ReserveHints = { };
+}
+
+size_t WorldPacket::GetReserveSize(uint16 opcode, size_t res)
+{
+    if (!res || opcode >= NUM_MSG_TYPES)
+        return res;
+
+    return std::max<size_t>(res, ReserveHints[opcode].load(std::memory_order_relaxed));
+}
+
+void WorldPacket::UpdateReserveHint(uint16 opcode, size_t size)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    // packets that don't fit any pool size class aren't worth reserving for
+    uint32 observed = uint32(std::min<size_t>(size, ByteBufferPool::MAX_SIZE_CLASS));
+    uint32 hint = ReserveHints[opcode].load(std::memory_order_relaxed);
+    uint32 newHint = observed >= hint ? observed : hint - (hint - observed) / 16;
+    if (newHint != hint)
+        ReserveHints[opcode].store(newHint, std::memory_order_relaxed);
+}
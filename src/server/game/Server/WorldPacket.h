@@ -22,6 +22,7 @@
 #include "Opcodes.h"
 #include "ByteBuffer.h"
 #include "Duration.h"
+#include <memory>
 
 class WorldPacket : public ByteBuffer
 {
@@ -31,7 +32,7 @@ class WorldPacket : public ByteBuffer
         {
         }
 
-        WorldPacket(uint16 opcode, size_t res = 200) : ByteBuffer(res),
+        WorldPacket(uint16 opcode, size_t res = 200) : ByteBuffer(GetReserveSize(opcode, res)),
             m_opcode(opcode) { }
 
         WorldPacket(WorldPacket&& packet) : ByteBuffer(std::move(packet)), m_opcode(packet.m_opcode)
@@ -73,7 +74,7 @@ class WorldPacket : public ByteBuffer
         void Initialize(uint16 opcode, size_t newres = 200)
         {
             clear();
-            _storage.reserve(newres);
+            reserve(GetReserveSize(opcode, newres));
             m_opcode = opcode;
         }
 
@@ -82,9 +83,45 @@ class WorldPacket : public ByteBuffer
 
         TimePoint GetReceivedTime() const { return m_receivedTime; }
 
+        // typed packet class of the opcode handler, see ClientOpcodeHandler::PreDecode
+        void* GetDecoded() const { return m_decoded.get(); }
+        size_t GetDecodedReadPos() const { return m_decodedReadPos; }
+        void SetDecoded(std::shared_ptr<void> decoded, size_t readPos) { m_decoded = std::move(decoded); m_decodedReadPos = readPos; }
+
+        /// Storage reserved for a new packet of opcode: res raised to sizes recently sent with that opcode, 0 reserves nothing
+        TC_GAME_API static size_t GetReserveSize(uint16 opcode, size_t res);
+        /// Learns reserve size of opcode from a packet being sent, grows immediately and shrinks slowly
+        TC_GAME_API static void UpdateReserveHint(uint16 opcode, size_t size);
+
     protected:
         uint16 m_opcode;
         TimePoint m_receivedTime; // only set for a specific set of opcodes, for performance reasons.
+        std::shared_ptr<void> m_decoded; // only set for client packets read by network threads
+        size_t m_decodedReadPos = 0;     // where Read() of m_decoded stopped in this packet
+};
+
+/// Packet sent to many sessions (broadcasts). Payload is copied once, on first send, and that copy
+/// is shared by the socket queues of all recipients - each socket only prepends its own encrypted header.
+/// Wrapped packet must outlive this object and must not be modified after the first send.
+class SharedWorldPacket
+{
+    public:
+        SharedWorldPacket() : _packet(nullptr) { }
+        explicit SharedWorldPacket(WorldPacket const* packet) : _packet(packet) { }
+
+        WorldPacket const* GetPacket() const { return _packet; }
+
+        std::shared_ptr<std::vector<uint8> const> const& GetPayload()
+        {
+            if (!_payload && !_packet->empty())
+                _payload = std::make_shared<std::vector<uint8> const>(_packet->contents(), _packet->contents() + _packet->size());
+
+            return _payload;
+        }
+
+    private:
+        WorldPacket const* _packet;
+        std::shared_ptr<std::vector<uint8> const> _payload;
 };
 
 #endif
@@ -214,11 +214,27 @@ ObjectGuid::LowType WorldSession::GetGUIDLow() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const* packet)
+{
+    if (!PrepareSendPacket(packet))
+        return;
+
+    m_Socket->SendPacket(*packet);
+}
+
+void WorldSession::SendPacket(SharedWorldPacket& packet)
+{
+    if (!PrepareSendPacket(packet.GetPacket()))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const* packet)
 {
     ASSERT(packet->GetOpcode() != NULL_OPCODE);
 
     if (!m_Socket)
-        return;
+        return false;
 
 #ifdef TRINITY_DEBUG
     // Code for network use statistic
@@ -258,11 +274,12 @@ void WorldSession::SendPacket(WorldPacket const* packet)
 
 #ifdef ELUNA
     if (!sEluna->OnPacketSend(this, *packet))
-        return;
+        return false;
 #endif
 
     TC_LOG_TRACE("network.opcode", "S->C: {} {}", GetPlayerInfo(), GetOpcodeNameForLogging(static_cast<OpcodeServer>(packet->GetOpcode())));
-    m_Socket->SendPacket(*packet);
+    WorldPacket::UpdateReserveHint(packet->GetOpcode(), packet->size());
+    return true;
 }
 
 /// Add an incoming packet to the queue
@@ -1456,6 +1473,22 @@ bool WorldSession::DosProtection::EvaluateOpcode(WorldPacket& p, time_t time) co
     }
 }
 
+bool WorldSession::DosProtection::AllowPreDecode(WorldPacket const& p, time_t time) const
+{
+    uint32 maxPacketCounterAllowed = GetMaxPacketCounterAllowed(p.GetOpcode());
+    if (!maxPacketCounterAllowed)
+        return true;
+
+    PacketCounter& packetCounter = _preDecodeThrottlingMap[p.GetOpcode()];
+    if (packetCounter.lastReceiveTime != time)
+    {
+        packetCounter.lastReceiveTime = time;
+        packetCounter.amountCounter = 0;
+    }
+
+    return ++packetCounter.amountCounter <= maxPacketCounterAllowed;
+}
+
 uint32 WorldSession::DosProtection::GetMaxPacketCounterAllowed(uint16 opcode) const
 {
     uint32 maxPacketCounterAllowed;
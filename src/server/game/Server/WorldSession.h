@@ -48,6 +48,7 @@ class Quest;
 class SpellCastTargets;
 class Unit;
 class Warden;
+class SharedWorldPacket;
 class WorldPacket;
 class WorldSocket;
 struct AddonInfo;
@@ -448,6 +449,8 @@ class TC_GAME_API WorldSession
         void static WriteMovementInfo(WorldPacket* data, MovementInfo* mi);
 
         void SendPacket(WorldPacket const* packet);
+        // broadcast variant, all recipients share one copy of the payload
+        void SendPacket(SharedWorldPacket& packet);
         void SendNotification(const char *format, ...) ATTR_PRINTF(2, 3);
         void SendNotification(uint32 string_id, ...);
         void SendPetNameInvalid(uint32 error, std::string const& name, DeclinedName *declinedName);
@@ -517,6 +520,9 @@ class TC_GAME_API WorldSession
         void QueuePacket(WorldPacket* new_packet);
         bool Update(uint32 diff, PacketFilter& updater);
 
+        // Called by the socket before queueing a packet, false once its opcode is over the anti-DoS limit
+        bool CanPreDecodePacket(WorldPacket const& packet) const { return AntiDOS.AllowPreDecode(packet, time(nullptr)); }
+
         /// Handle the authentication waiting queue (to be completed)
         void SendAuthWaitQueue(uint32 position);
 
@@ -1172,6 +1178,9 @@ class TC_GAME_API WorldSession
             public:
                 DosProtection(WorldSession* s);
                 bool EvaluateOpcode(WorldPacket& p, time_t time) const;
+                // Network thread counterpart of EvaluateOpcode: counts packets on their own, flooding is still
+                // handled by EvaluateOpcode once the packets reach the world thread
+                bool AllowPreDecode(WorldPacket const& p, time_t time) const;
             protected:
                 enum Policy
                 {
@@ -1189,6 +1198,7 @@ class TC_GAME_API WorldSession
                 typedef std::unordered_map<uint16, PacketCounter> PacketThrottlingMap;
                 // mark this member as "mutable" so it can be modified even in const functions
                 mutable PacketThrottlingMap _PacketThrottlingMap;
+                mutable PacketThrottlingMap _preDecodeThrottlingMap;
 
                 DosProtection(DosProtection const& right) = delete;
                 DosProtection& operator=(DosProtection const& right) = delete;
@@ -1204,6 +1214,9 @@ class TC_GAME_API WorldSession
         void LogUnexpectedOpcode(WorldPacket* packet, char const* status, const char *reason);
         void LogUnprocessedTail(WorldPacket* packet);
 
+        // stats, hooks and logging common to both SendPacket variants, false if packet must not be sent
+        bool PrepareSendPacket(WorldPacket const* packet);
+
         // EnumData helpers
         bool IsLegitCharacterForAccount(ObjectGuid lowGUID)
         {
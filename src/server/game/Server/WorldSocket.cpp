@@ -33,6 +33,7 @@
 #endif
 #include "World.h"
 #include "WorldSession.h"
+#include "WorldSocketMgr.h"
 #include <memory>
 
 using boost::asio::ip::tcp;
@@ -85,40 +86,54 @@ bool WorldSocket::Update()
 {
     EncryptablePacket* queued;
     MessageBuffer buffer(_sendBufferSize);
+    uint32 packets = 0;
     while (_bufferQueue.Dequeue(queued))
     {
-        ServerPktHeader header(queued->size() + 2, queued->GetOpcode());
-        if (queued->NeedsEncryption())
-            _authCrypt.EncryptSend(header.header, header.getHeaderLength());
+        std::size_t payloadSize = queued->GetPayloadSize();
+        ServerPktHeader header(payloadSize + 2, queued->GetOpcode());
+        std::size_t headerLength = header.getHeaderLength();
+        bool coalesce = payloadSize + headerLength <= _sendBufferSize;
 
-        if (buffer.GetRemainingSpace() < queued->size() + header.getHeaderLength())
+        // packets larger than send buffer only need room for their header
+        if (buffer.GetRemainingSpace() < (coalesce ? payloadSize + headerLength : headerLength))
         {
             QueuePacket(std::move(buffer));
             buffer.Resize(_sendBufferSize);
         }
 
-        if (buffer.GetRemainingSpace() >= queued->size() + header.getHeaderLength())
+        uint8* headerPos = buffer.GetWritePointer();
+        buffer.Write(header.header, headerLength);
+        if (queued->NeedsEncryption())
+            _authCrypt.EncryptSend(headerPos, headerLength);
+
+        if (coalesce)
         {
-            buffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                buffer.Write(queued->contents(), queued->size());
+            if (payloadSize)
+                buffer.Write(queued->GetPayload(), payloadSize);
         }
-        else    // single packet larger than 4096 bytes
+        else    // single packet larger than send buffer, queued without copying right behind its header
         {
-            MessageBuffer packetBuffer(queued->size() + header.getHeaderLength());
-            packetBuffer.Write(header.header, header.getHeaderLength());
-            if (!queued->empty())
-                packetBuffer.Write(queued->contents(), queued->size());
-
-            QueuePacket(std::move(packetBuffer));
+            QueuePacket(std::move(buffer));
+            buffer.Resize(_sendBufferSize);
+            if (queued->GetSharedPayload())
+                QueuePacket(SocketWriteBuffer(queued->GetSharedPayload()));
+            else
+                QueuePacket(MessageBuffer(queued->MoveStorage()));
         }
 
         delete queued;
+        ++packets;
     }
 
     if (buffer.GetActiveSize() > 0)
         QueuePacket(std::move(buffer));
 
+    uint32 writeCalls;
+    uint64 writtenBytes;
+    ConsumeWriteStats(writeCalls, writtenBytes);
+    if (packets || writeCalls)
+        sWorldSocketMgr.RecordSendStats(packets, writeCalls, writtenBytes);
+
     if (!BaseSocket::Update())
         return false;
 
@@ -377,7 +392,7 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
         return ReadDataHandlerResult::Error;
     }
 
-    OpcodeHandler const* handler = opcodeTable[opcode];
+    ClientOpcodeHandler const* handler = opcodeTable[opcode];
     if (!handler)
     {
         TC_LOG_ERROR("network.opcode", "No defined handler for opcode {} sent by {}", GetOpcodeNameForLogging(static_cast<OpcodeClient>(packet.GetOpcode())), _worldSession->GetPlayerInfo());
@@ -388,6 +403,12 @@ WorldSocket::ReadDataHandlerResult WorldSocket::ReadDataHandler()
     // Our Idle timer will reset on any non PING opcodes on login screen, allowing us to catch people idling.
     _worldSession->ResetTimeOutTime(false);
 
+    // read typed packets here instead of world and map threads, Lua packet hooks may replace the raw packet
+#ifndef ELUNA
+    if (sWorld->getBoolConfig(CONFIG_PREDECODE_PACKETS) && _worldSession->CanPreDecodePacket(*packetToQueue))
+        handler->PreDecode(*packetToQueue);
+#endif
+
     // Copy the packet to the heap before enqueuing
     _worldSession->QueuePacket(packetToQueue);
 
@@ -424,6 +445,17 @@ void WorldSocket::SendPacket(WorldPacket const& packet)
     _bufferQueue.Enqueue(new EncryptablePacket(packet, _authCrypt.IsInitialized()));
 }
 
+void WorldSocket::SendPacket(SharedWorldPacket& packet)
+{
+    if (!IsOpen())
+        return;
+
+    if (sPacketLog->CanLogPacket())
+        sPacketLog->LogPacket(*packet.GetPacket(), SERVER_TO_CLIENT, GetRemoteIpAddress(), GetRemotePort());
+
+    _bufferQueue.Enqueue(new EncryptablePacket(packet.GetPacket()->GetOpcode(), packet.GetPayload(), _authCrypt.IsInitialized()));
+}
+
 void WorldSocket::HandleAuthSession(WorldPacket& recvPacket)
 {
     std::shared_ptr<AuthSession> authSession = std::make_shared<AuthSession>();
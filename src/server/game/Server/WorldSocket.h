@@ -37,12 +37,31 @@ public:
         SocketQueueLink.store(nullptr, std::memory_order_relaxed);
     }
 
+    EncryptablePacket(uint16 opcode, std::shared_ptr<std::vector<uint8> const> payload, bool encrypt) : WorldPacket(opcode, 0),
+        _encrypt(encrypt), _sharedPayload(std::move(payload))
+    {
+        SocketQueueLink.store(nullptr, std::memory_order_relaxed);
+    }
+
     bool NeedsEncryption() const { return _encrypt; }
 
+    std::size_t GetPayloadSize() const { return _sharedPayload ? _sharedPayload->size() : size(); }
+    uint8 const* GetPayload() const { return _sharedPayload ? _sharedPayload->data() : contents(); }
+    std::shared_ptr<std::vector<uint8> const> const& GetSharedPayload() const { return _sharedPayload; }
+
+    // Hands packet contents over to the socket write queue without copying
+    std::vector<uint8>&& MoveStorage()
+    {
+        _rpos = 0;
+        _wpos = 0;
+        return std::move(_storage);
+    }
+
     std::atomic<EncryptablePacket*> SocketQueueLink;
 
 private:
     bool _encrypt;
+    std::shared_ptr<std::vector<uint8> const> _sharedPayload;   // set for broadcasts, own storage is empty then
 };
 
 namespace WorldPackets
@@ -79,6 +98,7 @@ public:
     bool Update() override;
 
     void SendPacket(WorldPacket const& packet);
+    void SendPacket(SharedWorldPacket& packet);
 
     void SetSendBufferSize(std::size_t sendBufferSize) { _sendBufferSize = sendBufferSize; }
 
@@ -16,6 +16,7 @@
  */
 
 #include "Config.h"
+#include "Metric.h"
 #include "NetworkThread.h"
 #include "ScriptMgr.h"
 #include "WorldSocket.h"
@@ -43,7 +44,8 @@ public:
     }
 };
 
-WorldSocketMgr::WorldSocketMgr() : BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536), _tcpNoDelay(true)
+WorldSocketMgr::WorldSocketMgr() : BaseSocketMgr(), _socketSystemSendBufferSize(-1), _socketApplicationSendBufferSize(65536), _tcpNoDelay(true),
+    _sentPackets(0), _sendWriteCalls(0), _sentBytes(0)
 {
 }
 
@@ -118,6 +120,30 @@ void WorldSocketMgr::OnSocketOpen(tcp::socket&& sock, uint32 threadIndex)
     BaseSocketMgr::OnSocketOpen(std::forward<tcp::socket>(sock), threadIndex);
 }
 
+void WorldSocketMgr::RecordSendStats(uint32 packets, uint32 writeCalls, uint64 writtenBytes)
+{
+    _sentPackets.fetch_add(packets, std::memory_order_relaxed);
+    _sendWriteCalls.fetch_add(writeCalls, std::memory_order_relaxed);
+    _sentBytes.fetch_add(writtenBytes, std::memory_order_relaxed);
+}
+
+void WorldSocketMgr::LogSendStats()
+{
+    uint64 packets = _sentPackets.exchange(0, std::memory_order_relaxed);
+    uint64 writeCalls = _sendWriteCalls.exchange(0, std::memory_order_relaxed);
+    uint64 bytes = _sentBytes.exchange(0, std::memory_order_relaxed);
+    if (!packets && !writeCalls)
+        return;
+
+    TC_METRIC_VALUE("worldsocket_sent_packets", packets);
+    TC_METRIC_VALUE("worldsocket_write_calls", writeCalls);
+    TC_METRIC_VALUE("worldsocket_sent_bytes", bytes);
+    if (packets)
+        TC_METRIC_VALUE("worldsocket_write_calls_per_packet", double(writeCalls) / packets);
+    if (writeCalls)
+        TC_METRIC_VALUE("worldsocket_bytes_per_write", double(bytes) / writeCalls);
+}
+
 NetworkThread<WorldSocket>* WorldSocketMgr::CreateThreads() const
 {
     return new WorldSocketThread[GetNetworkThreadCount()];
@@ -25,6 +25,7 @@
 #define __WORLDSOCKETMGR_H
 
 #include "SocketMgr.h"
+#include <atomic>
 
 class WorldSocket;
 
@@ -46,6 +47,11 @@ public:
 
     std::size_t GetApplicationSendBufferSize() const { return _socketApplicationSendBufferSize; }
 
+    /// Adds sent packets and write calls of a socket to totals of all network threads
+    void RecordSendStats(uint32 packets, uint32 writeCalls, uint64 writtenBytes);
+    /// Reports and resets send totals, called from metric status logger
+    void LogSendStats();
+
 protected:
     WorldSocketMgr();
 
@@ -55,6 +61,10 @@ private:
     int32 _socketSystemSendBufferSize;
     int32 _socketApplicationSendBufferSize;
     bool _tcpNoDelay;
+
+    std::atomic<uint64> _sentPackets;
+    std::atomic<uint64> _sendWriteCalls;
+    std::atomic<uint64> _sentBytes;
 };
 
 #define sWorldSocketMgr WorldSocketMgr::Instance()
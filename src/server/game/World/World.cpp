@@ -28,6 +28,7 @@
 #include "AuctionHouseMgr.h"
 #include "BattlefieldMgr.h"
 #include "BattlegroundMgr.h"
+#include "ByteBufferPool.h"
 #include "CalendarMgr.h"
 #include "ChannelMgr.h"
 #include "CharacterCache.h"
@@ -664,6 +665,15 @@ void World::LoadConfigSettings(bool reload)
         TC_LOG_ERROR("server.loading", "压缩级别 ({}) 必须在 1 到 9 的范围内. 使用默认压缩级别 (1).", m_int_configs[CONFIG_COMPRESSION]);
         m_int_configs[CONFIG_COMPRESSION] = 1;
     }
+    m_bool_configs[CONFIG_PREDECODE_PACKETS] = sConfigMgr->GetBoolDefault("Network.PreDecodePackets", false);
+    m_int_configs[CONFIG_COMPRESSION_MIN_SIZE] = sConfigMgr->GetIntDefault("Compression.MinSize", 100);
+    m_bool_configs[CONFIG_COMPRESSION_ADAPTIVE] = sConfigMgr->GetBoolDefault("Compression.Adaptive.Enable", false);
+    m_float_configs[CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO] = sConfigMgr->GetFloatDefault("Compression.Adaptive.MaxRatio", 0.9f);
+    if (m_float_configs[CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO] <= 0.0f || m_float_configs[CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO] > 1.0f)
+    {
+        TC_LOG_ERROR("server.loading", "Compression.Adaptive.MaxRatio ({}) must be in range (0, 1], set to 0.9", m_float_configs[CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO]);
+        m_float_configs[CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO] = 0.9f;
+    }
     m_bool_configs[CONFIG_ADDON_CHANNEL] = sConfigMgr->GetBoolDefault("AddonChannel", true);
     m_bool_configs[CONFIG_CLEAN_CHARACTER_DB] = sConfigMgr->GetBoolDefault("CleanCharacterDB", false);
     m_int_configs[CONFIG_PERSISTENT_CHARACTER_CLEAN_FLAGS] = sConfigMgr->GetIntDefault("PersistentCharacterCleanFlags", 0);
@@ -1400,6 +1410,9 @@ void World::LoadConfigSettings(bool reload)
     }
 
     m_bool_configs[CONFIG_ENABLE_MMAPS] = sConfigMgr->GetBoolDefault("mmap.enablePathFinding", true);
+    m_int_configs[CONFIG_MMAP_PATH_CACHE_SIZE] = sConfigMgr->GetIntDefault("mmap.PathCache.Size", 512);
+    m_int_configs[CONFIG_MMAP_ASYNC_PATHFINDING_THREADS] = sConfigMgr->GetIntDefault("mmap.AsyncPathfinding.Threads", 0);
+    MMAP::MMapFactory::createOrGetMMapManager()->SetMemoryMappedTiles(sConfigMgr->GetBoolDefault("mmap.MemoryMappedTiles", false));
     TC_LOG_INFO("server.loading", "WORLD: MMap 数据目录是: {}mmaps", m_dataPath);
 
     m_bool_configs[CONFIG_VMAP_INDOOR_CHECK] = sConfigMgr->GetBoolDefault("vmap.enableIndoorCheck", false);
@@ -1412,6 +1425,8 @@ void World::LoadConfigSettings(bool reload)
 
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
+    m_int_configs[CONFIG_VMAP_LOS_CACHE_SIZE] = sConfigMgr->GetIntDefault("vmap.LosCache.Size", 0);
+    m_int_configs[CONFIG_VMAP_LOS_CACHE_TTL] = sConfigMgr->GetIntDefault("vmap.LosCache.TTL", 1000);
     TC_LOG_INFO("server.loading", "VMap 支持已包括. LineOfSight: {}, getHeight: {}, indoorCheck: {}", enableLOS, enableHeight, enableIndoor);
     TC_LOG_INFO("server.loading", "VMap 数据目录是: {}vmaps", m_dataPath);
 
@@ -1436,6 +1451,28 @@ void World::LoadConfigSettings(bool reload)
     m_bool_configs[CONFIG_SHOW_MUTE_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowMuteInWorld", false);
     m_bool_configs[CONFIG_SHOW_BAN_IN_WORLD] = sConfigMgr->GetBoolDefault("ShowBanInWorld", false);
     m_int_configs[CONFIG_NUMTHREADS] = sConfigMgr->GetIntDefault("MapUpdate.Threads", 1);
+    m_int_configs[CONFIG_MAP_UPDATE_PARTITION_THREADS] = sConfigMgr->GetIntDefault("MapUpdate.Partition.Threads", 0);
+    m_float_configs[CONFIG_MAP_UPDATE_PARTITION_MARGIN] = sConfigMgr->GetFloatDefault("MapUpdate.Partition.Margin", 250.0f);
+
+    m_bool_configs[CONFIG_MAP_UPDATE_LOD_ENABLE] = sConfigMgr->GetBoolDefault("MapUpdate.LOD.Enable", false);
+    m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE] = sConfigMgr->GetFloatDefault("MapUpdate.LOD.NearDistance", 100.0f);
+    if (m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE] < 45 * sWorld->getRate(RATE_CREATURE_AGGRO))
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.LOD.NearDistance can't be less max aggro radius {}", 45 * sWorld->getRate(RATE_CREATURE_AGGRO));
+        m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE] = 45 * sWorld->getRate(RATE_CREATURE_AGGRO);
+    }
+    m_float_configs[CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE] = sConfigMgr->GetFloatDefault("MapUpdate.LOD.FarDistance", 250.0f);
+    if (m_float_configs[CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE] < m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE])
+    {
+        TC_LOG_ERROR("server.loading", "MapUpdate.LOD.FarDistance ({}) can't be less than MapUpdate.LOD.NearDistance ({}), set to {}",
+            m_float_configs[CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE], m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE], m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE]);
+        m_float_configs[CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE] = m_float_configs[CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE];
+    }
+    m_int_configs[CONFIG_MAP_UPDATE_LOD_MID_RATE] = std::max(sConfigMgr->GetIntDefault("MapUpdate.LOD.MidRate", 2), 1);
+    m_int_configs[CONFIG_MAP_UPDATE_LOD_FAR_RATE] = std::max(sConfigMgr->GetIntDefault("MapUpdate.LOD.FarRate", 5), 1);
+
+    m_bool_configs[CONFIG_MAP_UPDATE_PROFILER_ENABLE] = sConfigMgr->GetBoolDefault("MapUpdate.Profiler.Enable", false);
+    m_int_configs[CONFIG_MAP_UPDATE_PROFILER_INTERVAL] = std::max(sConfigMgr->GetIntDefault("MapUpdate.Profiler.Interval", 10000), 1000);
     m_int_configs[CONFIG_MAX_RESULTS_LOOKUP_COMMANDS] = sConfigMgr->GetIntDefault("Command.LookupMaxResults", 0);
 
     // Warden
@@ -2598,6 +2635,12 @@ void World::Update(uint32 diff)
         // Stats logger update
         sMetric->Update();
         TC_METRIC_VALUE("update_time_diff", diff);
+
+        // packet storage requests of all threads during this tick and how many of them reached the allocator
+        ByteBufferPool::Stats packetStorage = ByteBufferPool::ConsumeStats();
+        TC_METRIC_VALUE("bytebuffer_pool_acquires", packetStorage.Acquires);
+        TC_METRIC_VALUE("bytebuffer_pool_allocations", packetStorage.Allocations);
+        TC_METRIC_VALUE("bytebuffer_pool_frees", packetStorage.Frees);
     }
 }
 
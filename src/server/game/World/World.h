@@ -178,6 +178,10 @@ enum WorldBoolConfigs : uint32
     CONFIG_RESPAWN_DYNAMIC_ESCORTNPC,
     CONFIG_REGEN_HP_CANNOT_REACH_TARGET_IN_RAID,
     CONFIG_ALLOW_LOGGING_IP_ADDRESSES_IN_DATABASE,
+    CONFIG_MAP_UPDATE_LOD_ENABLE,
+    CONFIG_COMPRESSION_ADAPTIVE,
+    CONFIG_MAP_UPDATE_PROFILER_ENABLE,
+    CONFIG_PREDECODE_PACKETS,
     BOOL_CONFIG_VALUE_COUNT
 };
 
@@ -203,12 +207,17 @@ enum WorldFloatConfigs : uint32
     CONFIG_ARENA_MATCHMAKER_RATING_MODIFIER,
     CONFIG_RESPAWN_DYNAMICRATE_CREATURE,
     CONFIG_RESPAWN_DYNAMICRATE_GAMEOBJECT,
+    CONFIG_MAP_UPDATE_PARTITION_MARGIN,
+    CONFIG_MAP_UPDATE_LOD_NEAR_DISTANCE,
+    CONFIG_MAP_UPDATE_LOD_FAR_DISTANCE,
+    CONFIG_COMPRESSION_ADAPTIVE_MAX_RATIO,
     FLOAT_CONFIG_VALUE_COUNT
 };
 
 enum WorldIntConfigs : uint32
 {
     CONFIG_COMPRESSION = 0,
+    CONFIG_COMPRESSION_MIN_SIZE,
     CONFIG_INTERVAL_SAVE,
     CONFIG_INTERVAL_GRIDCLEAN,
     CONFIG_INTERVAL_MAPUPDATE,
@@ -330,6 +339,14 @@ enum WorldIntConfigs : uint32
     CONFIG_ENABLE_SINFO_LOGIN,
     CONFIG_PLAYER_ALLOW_COMMANDS,
     CONFIG_NUMTHREADS,
+    CONFIG_MAP_UPDATE_PARTITION_THREADS,
+    CONFIG_MAP_UPDATE_LOD_MID_RATE,
+    CONFIG_MAP_UPDATE_LOD_FAR_RATE,
+    CONFIG_MAP_UPDATE_PROFILER_INTERVAL,
+    CONFIG_MMAP_PATH_CACHE_SIZE,
+    CONFIG_MMAP_ASYNC_PATHFINDING_THREADS,
+    CONFIG_VMAP_LOS_CACHE_SIZE,
+    CONFIG_VMAP_LOS_CACHE_TTL,
     CONFIG_LOGDB_CLEARINTERVAL,
     CONFIG_LOGDB_CLEARTIME,
     CONFIG_CLIENTCACHE_VERSION,
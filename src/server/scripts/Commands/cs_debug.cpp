@@ -34,6 +34,7 @@ EndScriptData */
 #include "GridNotifiersImpl.h"
 #include "InstanceScript.h"
 #include "Language.h"
+#include "LineOfSightCache.h"
 #include "Log.h"
 #include "M2Stores.h"
 #include "MapManager.h"
@@ -107,6 +108,7 @@ public:
             { "itemexpire",         HandleDebugItemExpireCommand,          rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "areatriggers",       HandleDebugAreaTriggersCommand,        rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "los",                HandleDebugLoSCommand,                 rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
+            { "loscache",           HandleDebugLoSCacheCommand,            rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "moveflags",          HandleDebugMoveflagsCommand,           rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "transport",          HandleDebugTransportCommand,           rbac::RBAC_PERM_COMMAND_DEBUG,   Console::No },
             { "loadcells",          HandleDebugLoadCellsCommand,           rbac::RBAC_PERM_COMMAND_DEBUG,   Console::Yes },
@@ -1123,6 +1125,27 @@ public:
         return false;
     }
 
+    static bool HandleDebugLoSCacheCommand(ChatHandler* handler)
+    {
+        Map* map = handler->GetPlayer()->GetMap();
+        LineOfSightCache* cache = map->GetLineOfSightCache();
+        if (!cache)
+        {
+            handler->PSendSysMessage("Line of sight cache is disabled (vmap.LosCache.Size).");
+            return true;
+        }
+
+        LineOfSightCacheStats stats = cache->GetStats();
+        uint64 const checks = stats.Hits + stats.Misses;
+        double const hitRate = checks ? double(stats.Hits) * 100.0 / checks : 0.0;
+        double const missCost = stats.Misses ? double(stats.MissTime) / stats.Misses : 0.0;
+
+        handler->PSendSysMessage("Line of sight cache of map %u instance %u (%u entries):", map->GetId(), map->GetInstanceId(), uint32(cache->GetCapacity()));
+        handler->PSendSysMessage("    " UI64FMTD " checks, " UI64FMTD " hits (%.1f%%), " UI64FMTD " entries invalidated", checks, stats.Hits, hitRate, stats.Invalidations);
+        handler->PSendSysMessage("    %.0f ns per calculated check, %.1f ms saved", missCost, missCost * stats.Hits / 1000000.0);
+        return true;
+    }
+
     static bool HandleDebugSetAuraStateCommand(ChatHandler* handler, Optional<AuraStateType> state, bool apply)
     {
         Unit* unit = handler->getSelectedUnit();
@@ -30,6 +30,7 @@
 #include "GridNotifiersImpl.h"
 #include "Map.h"
 #include "MMapFactory.h"
+#include "MMapManager.h"
 #include "PathGenerator.h"
 #include "Player.h"
 #include "PointMovementGenerator.h"
@@ -256,6 +257,14 @@ public:
         handler->PSendSysMessage(" %u triangles (%u vertices)", triCount, triVertCount);
         handler->PSendSysMessage(" %.2f MB of data (not including pointers)", ((float)dataSize / sizeof(unsigned char)) / 1048576);
 
+        MMAP::MMapMemoryStats memory = manager->GetMemoryStats(mapId);
+        if (memory.MappedTiles)
+            handler->PSendSysMessage(" %u tiles memory mapped from tile files", memory.MappedTiles);
+
+        handler->PSendSysMessage("Query stats:");
+        handler->PSendSysMessage(" %u instances share %u thread queries (%.2f MB)", memory.Instances, memory.Queries, float(memory.QueriesSize) / 1048576);
+        handler->PSendSysMessage(" %.2f MB saved compared to one query per instance", float(memory.QueriesSizeSaved) / 1048576);
+
         return true;
     }
 
@@ -21,27 +21,57 @@
 #include "MessageBuffer.h"
 #include "Log.h"
 #include <atomic>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <functional>
 #include <type_traits>
+#include <vector>
 #include <boost/asio/ip/tcp.hpp>
 
 using boost::asio::ip::tcp;
 
 #define READ_BLOCK_SIZE 4096
+// max number of queued buffers passed to a single write call, more would be split by asio anyway
+#define MAX_WRITE_BUFFERS 64
 #ifdef BOOST_ASIO_HAS_IOCP
 #define TC_SOCKET_USE_IOCP
 #endif
 
+/// Socket write queue entry, either owns its bytes or references a payload shared with other sockets
+class SocketWriteBuffer
+{
+public:
+    SocketWriteBuffer(MessageBuffer&& buffer) : _buffer(std::move(buffer)), _sharedPos(0) { }
+
+    explicit SocketWriteBuffer(std::shared_ptr<std::vector<uint8> const> shared) : _buffer(std::size_t(0)), _shared(std::move(shared)), _sharedPos(0) { }
+
+    uint8 const* GetReadPointer() { return _shared ? _shared->data() + _sharedPos : _buffer.GetReadPointer(); }
+
+    std::size_t GetActiveSize() const { return _shared ? _shared->size() - _sharedPos : _buffer.GetActiveSize(); }
+
+    void ReadCompleted(std::size_t bytes)
+    {
+        if (_shared)
+            _sharedPos += bytes;
+        else
+            _buffer.ReadCompleted(bytes);
+    }
+
+private:
+    MessageBuffer _buffer;
+    std::shared_ptr<std::vector<uint8> const> _shared;
+    std::size_t _sharedPos;
+};
+
 template<class T>
 class Socket : public std::enable_shared_from_this<T>
 {
 public:
     explicit Socket(tcp::socket&& socket) : _socket(std::move(socket)), _remoteAddress(_socket.remote_endpoint().address()),
-        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false)
+        _remotePort(_socket.remote_endpoint().port()), _readBuffer(), _closed(false), _closing(false), _isWritingAsync(false), _writeCalls(0), _writtenBytes(0)
     {
         _readBuffer.Resize(READ_BLOCK_SIZE);
+        _writeBuffers.reserve(MAX_WRITE_BUFFERS);
     }
 
     virtual ~Socket()
@@ -101,9 +131,9 @@ public:
             std::bind(callback, this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
     }
 
-    void QueuePacket(MessageBuffer&& buffer)
+    void QueuePacket(SocketWriteBuffer&& buffer)
     {
-        _writeQueue.push(std::move(buffer));
+        _writeQueue.push_back(std::move(buffer));
 
 #ifdef TC_SOCKET_USE_IOCP
         AsyncProcessQueue();
@@ -131,6 +161,15 @@ public:
 
     MessageBuffer& GetReadBuffer() { return _readBuffer; }
 
+    /// Number of write calls and bytes written since last call, queued buffers are gathered into one call
+    void ConsumeWriteStats(uint32& writeCalls, uint64& writtenBytes)
+    {
+        writeCalls = _writeCalls;
+        writtenBytes = _writtenBytes;
+        _writeCalls = 0;
+        _writtenBytes = 0;
+    }
+
 protected:
     virtual void OnClose() { }
 
@@ -144,8 +183,8 @@ protected:
         _isWritingAsync = true;
 
 #ifdef TC_SOCKET_USE_IOCP
-        MessageBuffer& buffer = _writeQueue.front();
-        _socket.async_write_some(boost::asio::buffer(buffer.GetReadPointer(), buffer.GetActiveSize()), std::bind(&Socket<T>::WriteHandler,
+        // queued buffers stay in place until completion, deque does not move its elements on push_back
+        _socket.async_write_some(GatherWriteBuffers(), std::bind(&Socket<T>::WriteHandler,
             this->shared_from_this(), std::placeholders::_1, std::placeholders::_2));
 #else
         _socket.async_write_some(boost::asio::null_buffers(), std::bind(&Socket<T>::WriteHandlerWrapper,
@@ -165,6 +204,43 @@ protected:
     }
 
 private:
+    std::vector<boost::asio::const_buffer> const& GatherWriteBuffers()
+    {
+        _writeBuffers.clear();
+        for (SocketWriteBuffer& buffer : _writeQueue)
+        {
+            _writeBuffers.push_back(boost::asio::const_buffer(buffer.GetReadPointer(), buffer.GetActiveSize()));
+            if (_writeBuffers.size() >= MAX_WRITE_BUFFERS)
+                break;
+        }
+
+        return _writeBuffers;
+    }
+
+    // Removes fully written buffers from the queue, returns false if last gathered buffer was only partially written
+    bool WriteCompleted(std::size_t transferredBytes)
+    {
+        ++_writeCalls;
+        _writtenBytes += transferredBytes;
+
+        std::size_t gatheredBytes = boost::asio::buffer_size(_writeBuffers);
+        while (transferredBytes > 0)
+        {
+            SocketWriteBuffer& buffer = _writeQueue.front();
+            if (transferredBytes < buffer.GetActiveSize())
+            {
+                buffer.ReadCompleted(transferredBytes);
+                return false;
+            }
+
+            transferredBytes -= buffer.GetActiveSize();
+            gatheredBytes -= buffer.GetActiveSize();
+            _writeQueue.pop_front();
+        }
+
+        return gatheredBytes == 0;
+    }
+
     void ReadHandlerInternal(boost::system::error_code error, size_t transferredBytes)
     {
         if (error)
@@ -184,9 +260,7 @@ private:
         if (!error)
         {
             _isWritingAsync = false;
-            _writeQueue.front().ReadCompleted(transferedBytes);
-            if (!_writeQueue.front().GetActiveSize())
-                _writeQueue.pop();
+            WriteCompleted(transferedBytes);
 
             if (!_writeQueue.empty())
                 AsyncProcessQueue();
@@ -210,37 +284,31 @@ private:
         if (_writeQueue.empty())
             return false;
 
-        MessageBuffer& queuedMessage = _writeQueue.front();
-
-        std::size_t bytesToSend = queuedMessage.GetActiveSize();
+        std::vector<boost::asio::const_buffer> const& buffers = GatherWriteBuffers();
 
         boost::system::error_code error;
-        std::size_t bytesSent = _socket.write_some(boost::asio::buffer(queuedMessage.GetReadPointer(), bytesToSend), error);
+        std::size_t bytesSent = _socket.write_some(buffers, error);
 
         if (error)
         {
             if (error == boost::asio::error::would_block || error == boost::asio::error::try_again)
                 return AsyncProcessQueue();
 
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
         else if (bytesSent == 0)
         {
-            _writeQueue.pop();
+            _writeQueue.pop_front();
             if (_closing && _writeQueue.empty())
                 CloseSocket();
             return false;
         }
-        else if (bytesSent < bytesToSend) // now n > 0
-        {
-            queuedMessage.ReadCompleted(bytesSent);
+        else if (!WriteCompleted(bytesSent)) // now n > 0
             return AsyncProcessQueue();
-        }
 
-        _writeQueue.pop();
         if (_closing && _writeQueue.empty())
             CloseSocket();
         return !_writeQueue.empty();
@@ -254,12 +322,16 @@ private:
     uint16 _remotePort;
 
     MessageBuffer _readBuffer;
-    std::queue<MessageBuffer> _writeQueue;
+    std::deque<SocketWriteBuffer> _writeQueue;
+    std::vector<boost::asio::const_buffer> _writeBuffers;
 
     std::atomic<bool> _closed;
     std::atomic<bool> _closing;
 
     bool _isWritingAsync;
+
+    uint32 _writeCalls;
+    uint64 _writtenBytes;
 };
 
 #endif // __SOCKET_H__
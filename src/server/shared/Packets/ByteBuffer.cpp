@@ -99,13 +99,13 @@ void ByteBuffer::append(uint8 const* src, size_t cnt)
     if (_storage.capacity() < newSize) // custom memory allocation rules
     {
         if (newSize < 100)
-            _storage.reserve(300);
+            Reallocate(300);
         else if (newSize < 750)
-            _storage.reserve(2500);
+            Reallocate(2500);
         else if (newSize < 6000)
-            _storage.reserve(10000);
+            Reallocate(10000);
         else
-            _storage.reserve(400000);
+            Reallocate(std::max<size_t>(newSize, 400000));
     }
 
     if (_storage.size() < newSize)
@@ -123,6 +123,14 @@ void ByteBuffer::put(size_t pos, uint8 const* src, size_t cnt)
     std::memcpy(&_storage[pos], src, cnt);
 }
 
+void ByteBuffer::Reallocate(size_t capacity)
+{
+    std::vector<uint8> storage = ByteBufferPool::Acquire(capacity);
+    storage.assign(_storage.begin(), _storage.end());
+    ByteBufferPool::Release(std::move(_storage));
+    _storage = std::move(storage);
+}
+
 void ByteBuffer::print_storage() const
 {
     if (!sLog->ShouldLog("network", LOG_LEVEL_TRACE)) // optimize disabled trace output
@@ -19,6 +19,7 @@
 #define _BYTEBUFFER_H
 
 #include "Define.h"
+#include "ByteBufferPool.h"
 #include "ByteConverter.h"
 #include <array>
 #include <string>
@@ -71,15 +72,13 @@ class TC_SHARED_API ByteBuffer
     public:
         constexpr static size_t DEFAULT_SIZE = 0x1000;
 
-        // constructor
-        ByteBuffer() : _rpos(0), _wpos(0)
+        // constructor, storage is taken from ByteBufferPool
+        ByteBuffer() : _rpos(0), _wpos(0), _storage(ByteBufferPool::Acquire(DEFAULT_SIZE))
         {
-            _storage.reserve(DEFAULT_SIZE);
         }
 
-        ByteBuffer(size_t reserve) : _rpos(0), _wpos(0)
+        ByteBuffer(size_t reserve) : _rpos(0), _wpos(0), _storage(ByteBufferPool::Acquire(reserve))
         {
-            _storage.reserve(reserve);
         }
 
         ByteBuffer(ByteBuffer&& buf) noexcept : _rpos(buf._rpos), _wpos(buf._wpos), _storage(std::move(buf._storage))
@@ -88,7 +87,10 @@ class TC_SHARED_API ByteBuffer
             buf._wpos = 0;
         }
 
-        ByteBuffer(ByteBuffer const& right) = default;
+        ByteBuffer(ByteBuffer const& right) : _rpos(right._rpos), _wpos(right._wpos), _storage(ByteBufferPool::Acquire(right.size()))
+        {
+            _storage.assign(right._storage.begin(), right._storage.end());
+        }
 
         ByteBuffer(MessageBuffer&& buffer);
 
@@ -98,7 +100,9 @@ class TC_SHARED_API ByteBuffer
             {
                 _rpos = right._rpos;
                 _wpos = right._wpos;
-                _storage = right._storage;
+                if (_storage.capacity() < right.size())
+                    Reallocate(right.size());
+                _storage.assign(right._storage.begin(), right._storage.end());
             }
 
             return *this;
@@ -112,13 +116,17 @@ class TC_SHARED_API ByteBuffer
                 right._rpos = 0;
                 _wpos = right._wpos;
                 right._wpos = 0;
+                ByteBufferPool::Release(std::move(_storage));
                 _storage = std::move(right._storage);
             }
 
             return *this;
         }
 
-        virtual ~ByteBuffer() = default;
+        virtual ~ByteBuffer()
+        {
+            ByteBufferPool::Release(std::move(_storage));
+        }
 
         void clear()
         {
@@ -411,6 +419,8 @@ class TC_SHARED_API ByteBuffer
 
         void resize(size_t newsize)
         {
+            if (newsize > _storage.capacity())
+                Reallocate(newsize);
             _storage.resize(newsize, 0);
             _rpos = 0;
             _wpos = size();
@@ -418,8 +428,8 @@ class TC_SHARED_API ByteBuffer
 
         void reserve(size_t ressize)
         {
-            if (ressize > size())
-                _storage.reserve(ressize);
+            if (ressize > _storage.capacity())
+                Reallocate(ressize);
         }
 
         void shrink_to_fit()
@@ -489,6 +499,9 @@ class TC_SHARED_API ByteBuffer
         void hexlike() const;
 
     protected:
+        // moves content to pooled storage with at least given capacity
+        void Reallocate(size_t capacity);
+
         size_t _rpos, _wpos;
         std::vector<uint8> _storage;
 };
@@ -0,0 +1,227 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ByteBufferPool.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <mutex>
+
+namespace
+{
+    typedef std::vector<std::vector<uint8>> FreeList;
+
+    // bytes kept per size class in each thread, the depot keeps DEPOT_CACHE_FACTOR times more
+    constexpr std::size_t LOCAL_CACHE_BYTES = 256 * 1024;
+    constexpr std::size_t DEPOT_CACHE_FACTOR = 8;
+    constexpr uint32 STATS_FLUSH_INTERVAL = 64;
+
+    std::size_t GetLocalCacheLimit(std::size_t sizeClass)
+    {
+        return std::max<std::size_t>(LOCAL_CACHE_BYTES / ByteBufferPool::GetSizeClassCapacity(sizeClass), 4);
+    }
+
+    std::atomic<uint64> TotalAcquires;
+    std::atomic<uint64> TotalAllocations;
+    std::atomic<uint64> TotalReleases;
+    std::atomic<uint64> TotalFrees;
+
+    class Depot
+    {
+    public:
+        void Take(std::size_t sizeClass, FreeList& freeList, std::size_t count)
+        {
+            std::lock_guard<std::mutex> lock(_locks[sizeClass]);
+            FreeList& buffers = _buffers[sizeClass];
+            for (; count && !buffers.empty(); --count)
+            {
+                freeList.push_back(std::move(buffers.back()));
+                buffers.pop_back();
+            }
+        }
+
+        // Moves buffers above keep from freeList to depot, returns how many were freed because depot was full
+        std::size_t Put(std::size_t sizeClass, FreeList& freeList, std::size_t keep)
+        {
+            std::size_t depotLimit = GetLocalCacheLimit(sizeClass) * DEPOT_CACHE_FACTOR;
+            std::size_t freed = 0;
+
+            std::lock_guard<std::mutex> lock(_locks[sizeClass]);
+            FreeList& buffers = _buffers[sizeClass];
+            while (freeList.size() > keep)
+            {
+                if (buffers.size() < depotLimit)
+                    buffers.push_back(std::move(freeList.back()));
+                else
+                    ++freed;
+
+                freeList.pop_back();
+            }
+
+            return freed;
+        }
+
+    private:
+        std::array<std::mutex, ByteBufferPool::SIZE_CLASS_COUNT> _locks;
+        std::array<FreeList, ByteBufferPool::SIZE_CLASS_COUNT> _buffers;
+    };
+
+    Depot& GetDepot()
+    {
+        static Depot depot;
+        return depot;
+    }
+
+    // set when thread cache is destroyed, storage released later (static packets) is freed directly
+    thread_local bool ThreadCacheDestroyed = false;
+
+    struct ThreadCache
+    {
+        std::array<FreeList, ByteBufferPool::SIZE_CLASS_COUNT> FreeLists;
+
+        uint64 Acquires = 0;
+        uint64 Allocations = 0;
+        uint64 Releases = 0;
+        uint64 Frees = 0;
+        uint32 PendingOperations = 0;
+
+        ~ThreadCache()
+        {
+            FlushStats();
+            ThreadCacheDestroyed = true;
+        }
+
+        void CountOperation()
+        {
+            if (++PendingOperations >= STATS_FLUSH_INTERVAL)
+                FlushStats();
+        }
+
+        void FlushStats()
+        {
+            TotalAcquires.fetch_add(Acquires, std::memory_order_relaxed);
+            TotalAllocations.fetch_add(Allocations, std::memory_order_relaxed);
+            TotalReleases.fetch_add(Releases, std::memory_order_relaxed);
+            TotalFrees.fetch_add(Frees, std::memory_order_relaxed);
+            Acquires = 0;
+            Allocations = 0;
+            Releases = 0;
+            Frees = 0;
+            PendingOperations = 0;
+        }
+    };
+
+    thread_local ThreadCache LocalCache;
+}
+
+std::vector<uint8> ByteBufferPool::Acquire(std::size_t minCapacity)
+{
+    std::vector<uint8> storage;
+    if (!minCapacity)
+        return storage;
+
+    if (ThreadCacheDestroyed)
+    {
+        storage.reserve(minCapacity);
+        return storage;
+    }
+
+    ThreadCache& cache = LocalCache;
+    ++cache.Acquires;
+
+    std::size_t sizeClass = GetSizeClass(minCapacity);
+    if (sizeClass < SIZE_CLASS_COUNT)
+    {
+        FreeList& freeList = cache.FreeLists[sizeClass];
+        if (freeList.empty())
+            GetDepot().Take(sizeClass, freeList, GetLocalCacheLimit(sizeClass) / 2);
+
+        if (!freeList.empty())
+        {
+            storage = std::move(freeList.back());
+            freeList.pop_back();
+            cache.CountOperation();
+            return storage;
+        }
+
+        // allocate whole class so the storage lands in the same free list when released
+        minCapacity = GetSizeClassCapacity(sizeClass);
+    }
+
+    ++cache.Allocations;
+    storage.reserve(minCapacity);
+    cache.CountOperation();
+    return storage;
+}
+
+void ByteBufferPool::Release(std::vector<uint8>&& storage)
+{
+    std::size_t capacity = storage.capacity();
+    if (!capacity)
+        return;
+
+    if (capacity < MIN_SIZE_CLASS || capacity >= 2 * MAX_SIZE_CLASS || ThreadCacheDestroyed)
+    {
+        if (!ThreadCacheDestroyed)
+        {
+            ++LocalCache.Frees;
+            LocalCache.CountOperation();
+        }
+
+        std::vector<uint8>().swap(storage);
+        return;
+    }
+
+    // largest size class not above capacity, storage can be returned by Acquire for any size of that class
+    std::size_t sizeClass = std::bit_width(capacity) - std::bit_width(MIN_SIZE_CLASS);
+
+    ThreadCache& cache = LocalCache;
+    ++cache.Releases;
+
+    storage.clear();
+    FreeList& freeList = cache.FreeLists[sizeClass];
+    freeList.push_back(std::move(storage));
+
+    std::size_t limit = GetLocalCacheLimit(sizeClass);
+    if (freeList.size() > limit)
+        cache.Frees += GetDepot().Put(sizeClass, freeList, limit / 2);
+
+    cache.CountOperation();
+}
+
+ByteBufferPool::Stats ByteBufferPool::ConsumeStats()
+{
+    Stats stats;
+    stats.Acquires = TotalAcquires.exchange(0, std::memory_order_relaxed);
+    stats.Allocations = TotalAllocations.exchange(0, std::memory_order_relaxed);
+    stats.Releases = TotalReleases.exchange(0, std::memory_order_relaxed);
+    stats.Frees = TotalFrees.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+std::size_t ByteBufferPool::GetSizeClass(std::size_t size)
+{
+    if (size <= MIN_SIZE_CLASS)
+        return 0;
+
+    if (size > MAX_SIZE_CLASS)
+        return SIZE_CLASS_COUNT;
+
+    return std::bit_width(size - 1) - std::bit_width(MIN_SIZE_CLASS - 1);
+}
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef ByteBufferPool_h__
+#define ByteBufferPool_h__
+
+#include "Define.h"
+#include <vector>
+
+/// Recycles ByteBuffer storage in power of two size classes so packets built every tick don't go through the global allocator.
+/// Each thread keeps its own free lists, surplus is exchanged in batches through a shared depot (packets
+/// are usually built on map threads and destroyed on network threads).
+/// Storage larger than MAX_SIZE_CLASS is never pooled.
+class TC_SHARED_API ByteBufferPool
+{
+public:
+    static constexpr std::size_t MIN_SIZE_CLASS = 64;
+    static constexpr std::size_t MAX_SIZE_CLASS = 16384;
+    static constexpr std::size_t SIZE_CLASS_COUNT = 9;
+
+    struct Stats
+    {
+        uint64 Acquires = 0;        // storage requests with non zero size
+        uint64 Allocations = 0;     // requests that had to allocate, pooled size classes and larger ones
+        uint64 Releases = 0;        // storage returned to free lists
+        uint64 Frees = 0;           // storage freed because free lists were full or it was too small
+    };
+
+    /// Returns empty storage with capacity of at least minCapacity, taken from free lists when possible
+    static std::vector<uint8> Acquire(std::size_t minCapacity);
+
+    /// Keeps storage for reuse, storage is left empty
+    static void Release(std::vector<uint8>&& storage);
+
+    /// Counters of all threads since last call, threads report them in batches so recent operations may be missing
+    static Stats ConsumeStats();
+
+    /// Index of smallest size class that fits size, SIZE_CLASS_COUNT if none does
+    static std::size_t GetSizeClass(std::size_t size);
+    static std::size_t GetSizeClassCapacity(std::size_t sizeClass) { return MIN_SIZE_CLASS << sizeClass; }
+};
+
+#endif // ByteBufferPool_h__
@@ -38,6 +38,7 @@
 #include "Metric.h"
 #include "MySQLThreading.h"
 #include "ObjectAccessor.h"
+#include "Opcodes.h"
 #include "OpenSSLCrypto.h"
 #include "OutdoorPvP/OutdoorPvPMgr.h"
 #include "ProcessPriority.h"
@@ -288,6 +289,8 @@ extern int main(int argc, char** argv)
         TC_METRIC_VALUE("db_queue_login", uint64(LoginDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_character", uint64(CharacterDatabase.QueueSize()));
         TC_METRIC_VALUE("db_queue_world", uint64(WorldDatabase.QueueSize()));
+        LogOpcodeTimeStats();
+        sWorldSocketMgr.LogSendStats();
     });
 
     TC_METRIC_EVENT("events", "Worldserver started", "");
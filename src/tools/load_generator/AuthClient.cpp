@@ -0,0 +1,253 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuthClient.h"
+#include "BigNumber.h"
+#include "ClientPacket.h"
+#include "CryptoHash.h"
+#include "StringFormat.h"
+#include "Util.h"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <algorithm>
+#include <functional>
+
+using boost::asio::ip::tcp;
+using SHA1 = Trinity::Crypto::SHA1;
+
+namespace
+{
+    enum AuthCmd : uint8
+    {
+        AUTH_LOGON_CHALLENGE    = 0x00,
+        AUTH_LOGON_PROOF        = 0x01,
+        REALM_LIST              = 0x10
+    };
+
+    enum RealmFlags : uint8
+    {
+        REALM_FLAG_SPECIFYBUILD = 0x04
+    };
+
+    constexpr uint16 CLIENT_BUILD = 12340;
+    constexpr size_t EPHEMERAL_KEY_LENGTH = 32;
+    using EphemeralKey = std::array<uint8, EPHEMERAL_KEY_LENGTH>;
+
+    // Same as SRP6::SHA1Interleave on the server side
+    SessionKey SHA1Interleave(EphemeralKey const& S)
+    {
+        std::array<uint8, EPHEMERAL_KEY_LENGTH / 2> buf0, buf1;
+        for (size_t i = 0; i < EPHEMERAL_KEY_LENGTH / 2; ++i)
+        {
+            buf0[i] = S[2 * i + 0];
+            buf1[i] = S[2 * i + 1];
+        }
+
+        size_t p = 0;
+        while (p < EPHEMERAL_KEY_LENGTH && !S[p]) ++p;
+        if (p & 1) ++p;
+        p /= 2;
+
+        SHA1::Digest const hash0 = SHA1::GetDigestOf(buf0.data() + p, EPHEMERAL_KEY_LENGTH / 2 - p);
+        SHA1::Digest const hash1 = SHA1::GetDigestOf(buf1.data() + p, EPHEMERAL_KEY_LENGTH / 2 - p);
+
+        SessionKey K;
+        for (size_t i = 0; i < SHA1::DIGEST_LENGTH; ++i)
+        {
+            K[2 * i + 0] = hash0[i];
+            K[2 * i + 1] = hash1[i];
+        }
+        return K;
+    }
+
+    void Send(tcp::socket& socket, LoadGen::PacketWriter const& packet)
+    {
+        boost::asio::write(socket, boost::asio::buffer(packet.GetData()));
+    }
+
+    std::vector<uint8> Receive(tcp::socket& socket, size_t size)
+    {
+        std::vector<uint8> data(size);
+        boost::asio::read(socket, boost::asio::buffer(data));
+        return data;
+    }
+}
+
+bool LoadGen::AuthClient::Login(std::string const& host, std::string const& port, std::string account, std::string password, AuthResult& result, std::string& error)
+{
+    if (!Utf8ToUpperOnlyLatin(account) || !Utf8ToUpperOnlyLatin(password))
+    {
+        error = "invalid account name or password";
+        return false;
+    }
+
+    if (account.size() > 16)
+    {
+        error = "account name too long";
+        return false;
+    }
+
+    try
+    {
+        tcp::resolver resolver(_ioContext);
+        tcp::socket socket(_ioContext);
+        boost::asio::connect(socket, resolver.resolve(host, port));
+        socket.set_option(tcp::no_delay(true));
+
+        // authserver packets have no header, the command is their first byte
+        PacketWriter challenge(AUTH_LOGON_CHALLENGE, 64);
+        challenge << uint8(AUTH_LOGON_CHALLENGE);
+        challenge << uint8(0);                              // error
+        challenge << uint16(30 + account.size());           // size of the remaining packet
+        challenge.Append(std::array<uint8, 4>{ 'W', 'o', 'W', 0 });
+        challenge << uint8(3) << uint8(3) << uint8(5) << uint16(CLIENT_BUILD);
+        challenge.Append(std::array<uint8, 4>{ '6', '8', 'x', 0 });
+        challenge.Append(std::array<uint8, 4>{ 'n', 'i', 'W', 0 });
+        challenge.Append(std::array<uint8, 4>{ 'S', 'U', 'n', 'e' });
+        challenge << uint32(0);                             // timezone bias
+        challenge << uint32(0);                             // ip, unused by the server
+        challenge << uint8(account.size());
+        challenge.Append(reinterpret_cast<uint8 const*>(account.data()), account.size());
+        Send(socket, challenge);
+
+        std::vector<uint8> data = Receive(socket, 3);
+        if (data[2] != 0)
+        {
+            error = Trinity::StringFormat("logon challenge failed with error {}", data[2]);
+            return false;
+        }
+
+        // B, g, N, s, version challenge, security flags
+        data = Receive(socket, 32 + 1 + 1 + 1 + 32 + 32 + 16 + 1);
+        PacketReader reader(AUTH_LOGON_CHALLENGE, data.data(), data.size());
+
+        EphemeralKey B;
+        reader.Read(B);
+        if (reader.Read<uint8>() != 1)
+        {
+            error = "unexpected generator length";
+            return false;
+        }
+        std::array<uint8, 1> g;
+        reader.Read(g);
+        if (reader.Read<uint8>() != 32)
+        {
+            error = "unexpected modulus length";
+            return false;
+        }
+        std::array<uint8, 32> N;
+        reader.Read(N);
+        std::array<uint8, 32> s;
+        reader.Read(s);
+        reader.Skip(16);                                    // version challenge
+        if (uint8 securityFlags = reader.Read<uint8>())
+        {
+            error = Trinity::StringFormat("account requires security flags 0x{:02X} (PIN, matrix or authenticator), not supported", securityFlags);
+            return false;
+        }
+
+        BigNumber const bnN(N);
+        BigNumber const bnG(g);
+        BigNumber const bnB(B);
+        if ((bnB % bnN).IsZero())
+        {
+            error = "server sent invalid B";
+            return false;
+        }
+
+        BigNumber a;
+        a.SetRand(19 * 8);
+        EphemeralKey const A = bnG.ModExp(a, bnN).ToByteArray<EPHEMERAL_KEY_LENGTH>();
+
+        BigNumber const u(SHA1::GetDigestOf(A, B));
+        BigNumber const x(SHA1::GetDigestOf(s, SHA1::GetDigestOf(account, ":", password)));
+
+        // S = (B - 3 * g^x) ^ (a + u * x), N is added first to stay positive
+        BigNumber const kgx = (bnG.ModExp(x, bnN) * 3) % bnN;
+        EphemeralKey const S = ((bnB + bnN - kgx) % bnN).ModExp(a + u * x, bnN).ToByteArray<EPHEMERAL_KEY_LENGTH>();
+        SessionKey const K = SHA1Interleave(S);
+
+        SHA1::Digest const NHash = SHA1::GetDigestOf(N);
+        SHA1::Digest const gHash = SHA1::GetDigestOf(g);
+        SHA1::Digest NgHash;
+        std::transform(NHash.begin(), NHash.end(), gHash.begin(), NgHash.begin(), std::bit_xor<>());
+
+        SHA1::Digest const M1 = SHA1::GetDigestOf(NgHash, SHA1::GetDigestOf(account), s, A, B, K);
+
+        PacketWriter proof(AUTH_LOGON_PROOF, 75);
+        proof << uint8(AUTH_LOGON_PROOF);
+        proof.Append(A);
+        proof.Append(M1);
+        proof.Append(SHA1::Digest{});                       // client file crc, only checked with StrictVersionCheck
+        proof << uint8(0);                                  // number of keys
+        proof << uint8(0);                                  // security flags
+        Send(socket, proof);
+
+        data = Receive(socket, 2);
+        if (data[1] != 0)
+        {
+            error = Trinity::StringFormat("logon proof failed with error {}", data[1]);
+            return false;
+        }
+
+        data = Receive(socket, SHA1::DIGEST_LENGTH + 4 + 4 + 2);
+        reader = PacketReader(AUTH_LOGON_PROOF, data.data(), data.size());
+        SHA1::Digest M2;
+        reader.Read(M2);
+        if (M2 != SHA1::GetDigestOf(A, M1, K))
+        {
+            error = "server proof mismatch";
+            return false;
+        }
+
+        PacketWriter realmList(REALM_LIST, 5);
+        realmList << uint8(REALM_LIST) << uint32(0);
+        Send(socket, realmList);
+
+        data = Receive(socket, 3);
+        reader = PacketReader(REALM_LIST, data.data(), data.size());
+        reader.Skip(1);
+        data = Receive(socket, reader.Read<uint16>());
+        reader = PacketReader(REALM_LIST, data.data(), data.size());
+        reader.Skip(4);
+
+        uint16 realmCount = reader.Read<uint16>();
+        result.Realms.clear();
+        for (uint16 i = 0; i < realmCount; ++i)
+        {
+            RealmInfo& realm = result.Realms.emplace_back();
+            reader.Skip(2);                                 // type, lock
+            realm.Flags = reader.Read<uint8>();
+            realm.Name = reader.ReadCString();
+            realm.Address = reader.ReadCString();
+            reader.Skip(4 + 1 + 1);                         // population, characters, timezone
+            realm.Id = reader.Read<uint8>();
+            if (realm.Flags & REALM_FLAG_SPECIFYBUILD)
+                reader.Skip(5);
+        }
+
+        result.Key = K;
+        return true;
+    }
+    catch (std::exception const& e)
+    {
+        error = e.what();
+        return false;
+    }
+}
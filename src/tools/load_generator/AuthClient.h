@@ -0,0 +1,57 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOADGEN_AUTH_CLIENT_H
+#define _LOADGEN_AUTH_CLIENT_H
+
+#include "AuthDefines.h"
+#include "Define.h"
+#include <boost/asio/io_context.hpp>
+#include <string>
+#include <vector>
+
+namespace LoadGen
+{
+    struct RealmInfo
+    {
+        uint8 Id;
+        uint8 Flags;
+        std::string Name;
+        std::string Address;
+    };
+
+    struct AuthResult
+    {
+        SessionKey Key;
+        std::vector<RealmInfo> Realms;
+    };
+
+    // Blocking authserver client: SRP6 logon challenge/proof for client build 12340 followed by the realm list
+    class AuthClient
+    {
+        public:
+            explicit AuthClient(boost::asio::io_context& ioContext) : _ioContext(ioContext) { }
+
+            // account and password are converted to upper case like the game client does
+            bool Login(std::string const& host, std::string const& port, std::string account, std::string password, AuthResult& result, std::string& error);
+
+        private:
+            boost::asio::io_context& _ioContext;
+    };
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ClientPacket.h"
+#include "StringFormat.h"
+
+namespace LoadGen
+{
+    PacketReadException::PacketReadException(uint16 opcode, size_t pos, size_t size, size_t valueSize)
+        : std::runtime_error(Trinity::StringFormat("Attempted to read {} bytes at position {} of opcode 0x{:03X} with size {}", valueSize, pos, opcode, size))
+    {
+    }
+
+    void PacketWriter::AppendPackedGuid(uint64 guid)
+    {
+        uint8 packed[9] = { };
+        size_t size = 1;
+        for (uint8 i = 0; guid != 0; ++i)
+        {
+            if (guid & 0xFF)
+            {
+                packed[0] |= uint8(1 << i);
+                packed[size++] = uint8(guid & 0xFF);
+            }
+
+            guid >>= 8;
+        }
+
+        Append(packed, size);
+    }
+
+    std::string PacketReader::ReadCString()
+    {
+        std::string value;
+        while (true)
+        {
+            char c = char(Read<uint8>());
+            if (c == 0)
+                break;
+
+            value += c;
+        }
+
+        return value;
+    }
+
+    uint64 PacketReader::ReadPackedGuid()
+    {
+        uint8 mask = Read<uint8>();
+        uint64 guid = 0;
+        for (uint8 i = 0; i < 8; ++i)
+            if (mask & (1 << i))
+                guid |= uint64(Read<uint8>()) << (i * 8);
+
+        return guid;
+    }
+}
@@ -0,0 +1,160 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOADGEN_CLIENT_PACKET_H
+#define _LOADGEN_CLIENT_PACKET_H
+
+#include "ByteConverter.h"
+#include "Define.h"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace LoadGen
+{
+    // Opcodes used by the simulated client, values from game/Server/Protocol/Opcodes.h
+    enum Opcode : uint16
+    {
+        CMSG_CHAR_CREATE            = 0x036,
+        CMSG_CHAR_ENUM              = 0x037,
+        SMSG_CHAR_CREATE            = 0x03A,
+        SMSG_CHAR_ENUM              = 0x03B,
+        CMSG_PLAYER_LOGIN           = 0x03D,
+        SMSG_CHARACTER_LOGIN_FAILED = 0x041,
+        CMSG_MESSAGECHAT            = 0x095,
+        MSG_MOVE_START_FORWARD      = 0x0B5,
+        MSG_MOVE_STOP               = 0x0B7,
+        MSG_MOVE_HEARTBEAT          = 0x0EE,
+        CMSG_CAST_SPELL             = 0x12E,
+        SMSG_CAST_FAILED            = 0x130,
+        SMSG_SPELL_GO               = 0x132,
+        CMSG_QUERY_TIME             = 0x1CE,
+        SMSG_QUERY_TIME_RESPONSE    = 0x1CF,
+        CMSG_PING                   = 0x1DC,
+        SMSG_PONG                   = 0x1DD,
+        SMSG_AUTH_CHALLENGE         = 0x1EC,
+        CMSG_AUTH_SESSION           = 0x1ED,
+        SMSG_AUTH_RESPONSE          = 0x1EE,
+        SMSG_LOGIN_VERIFY_WORLD     = 0x236,
+        CMSG_SET_ACTIVE_MOVER       = 0x26A,
+        SMSG_TIME_SYNC_REQ          = 0x390,
+        CMSG_TIME_SYNC_RESP         = 0x391
+    };
+
+    class PacketReadException : public std::runtime_error
+    {
+        public:
+            PacketReadException(uint16 opcode, size_t pos, size_t size, size_t valueSize);
+    };
+
+    // Little endian writer matching the ByteBuffer << operators used by the server
+    class PacketWriter
+    {
+        public:
+            explicit PacketWriter(uint16 opcode, size_t reserve = 32) : _opcode(opcode)
+            {
+                _data.reserve(reserve);
+            }
+
+            template<typename T>
+            std::enable_if_t<std::is_arithmetic_v<T>, PacketWriter&> operator<<(T value)
+            {
+                EndianConvert(value);
+                Append(reinterpret_cast<uint8 const*>(&value), sizeof(T));
+                return *this;
+            }
+
+            PacketWriter& operator<<(std::string_view str)
+            {
+                Append(reinterpret_cast<uint8 const*>(str.data()), str.size());
+                _data.push_back(0);
+                return *this;
+            }
+
+            PacketWriter& operator<<(char const* str) { return *this << std::string_view(str); }
+            PacketWriter& operator<<(std::string const& str) { return *this << std::string_view(str); }
+
+            template<typename Container>
+            void Append(Container const& c) { Append(std::data(c), std::size(c)); }
+            void Append(uint8 const* data, size_t len) { _data.insert(_data.end(), data, data + len); }
+
+            void AppendPackedGuid(uint64 guid);
+
+            uint16 GetOpcode() const { return _opcode; }
+            std::vector<uint8> const& GetData() const { return _data; }
+            size_t GetSize() const { return _data.size(); }
+
+        private:
+            uint16 _opcode;
+            std::vector<uint8> _data;
+    };
+
+    // Bounds checked reader, throws PacketReadException on truncated packets
+    class PacketReader
+    {
+        public:
+            PacketReader(uint16 opcode, uint8 const* data, size_t size) : _opcode(opcode), _data(data), _size(size), _pos(0) { }
+
+            template<typename T>
+            std::enable_if_t<std::is_arithmetic_v<T>, T> Read()
+            {
+                T value;
+                Read(reinterpret_cast<uint8*>(&value), sizeof(T));
+                EndianConvert(value);
+                return value;
+            }
+
+            void Read(uint8* dest, size_t len)
+            {
+                CheckSize(len);
+                std::memcpy(dest, _data + _pos, len);
+                _pos += len;
+            }
+
+            template<typename Container>
+            void Read(Container& c) { Read(std::data(c), std::size(c)); }
+
+            std::string ReadCString();
+            uint64 ReadPackedGuid();
+
+            void Skip(size_t len)
+            {
+                CheckSize(len);
+                _pos += len;
+            }
+
+            uint16 GetOpcode() const { return _opcode; }
+            size_t GetRemaining() const { return _size - _pos; }
+
+        private:
+            void CheckSize(size_t len) const
+            {
+                if (_pos + len > _size)
+                    throw PacketReadException(_opcode, _pos, _size, len);
+            }
+
+            uint16 _opcode;
+            uint8 const* _data;
+            size_t _size;
+            size_t _pos;
+    };
+}
+
+#endif
@@ -0,0 +1,463 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "AuthClient.h"
+#include "Banner.h"
+#include "Common.h"
+#include "IoContext.h"
+#include "LoadStats.h"
+#include "Locales.h"
+#include "OpenSSLCrypto.h"
+#include "Profile.h"
+#include "StringConvert.h"
+#include "Timer.h"
+#include "Util.h"
+#include "WorldClient.h"
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/dll/runtime_symbol_info.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    struct LoadConfig
+    {
+        std::string AuthHost = "127.0.0.1";
+        std::string AuthPort = "3724";
+        std::string WorldHost;              // empty: address from the realm list
+        std::string WorldPort;
+        Optional<uint32> RealmId;
+        std::string AccountPrefix = "LOADTEST";
+        uint32 FirstAccount = 1;
+        uint32 Count = 10;
+        std::string Password;
+        std::vector<LoadGen::Profile> Profiles;
+        uint8 CreateRace = 0;
+        uint8 CreateClass = 0;
+        uint32 Duration = 300;
+        uint32 LoginRate = 20;
+        uint32 LoginThreads = 4;
+        uint32 Threads = std::max(1u, std::thread::hardware_concurrency());
+        uint32 QueryInterval = 1000;
+        uint32 ReportInterval = 10;
+        std::string CsvFile;
+        uint32 Seed = 0;
+    };
+
+    std::atomic<bool> StopRequested(false);
+
+    void SignalHandler(int /*sigNum*/)
+    {
+        StopRequested.store(true);
+    }
+
+    bool SplitAddress(std::string_view address, std::string& host, std::string& port)
+    {
+        size_t colon = address.rfind(':');
+        if (colon == std::string_view::npos || colon + 1 == address.size())
+            return false;
+
+        host = std::string(address.substr(0, colon));
+        port = std::string(address.substr(colon + 1));
+        return true;
+    }
+
+    template<typename T>
+    bool ParseNumber(char const* param, T& value, T min = 1)
+    {
+        if (!param)
+            return false;
+
+        Optional<T> parsed = Trinity::StringTo<T>(param);
+        if (!parsed || *parsed < min)
+            return false;
+
+        value = *parsed;
+        return true;
+    }
+
+    bool handleArgs(int argc, char** argv, LoadConfig& config)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            char const* param = i + 1 < argc ? argv[i + 1] : nullptr;
+            bool valid = true;
+            if (strcmp(argv[i], "--auth") == 0)
+            {
+                // port is optional
+                valid = param != nullptr;
+                if (valid && !SplitAddress(param, config.AuthHost, config.AuthPort))
+                    config.AuthHost = param;
+                ++i;
+            }
+            else if (strcmp(argv[i], "--world") == 0)
+            {
+                valid = param && SplitAddress(param, config.WorldHost, config.WorldPort);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--realm") == 0)
+            {
+                uint32 realmId = 0;
+                valid = ParseNumber(param, realmId);
+                config.RealmId = realmId;
+                ++i;
+            }
+            else if (strcmp(argv[i], "--accounts") == 0)
+            {
+                valid = param && *param;
+                if (valid)
+                    config.AccountPrefix = param;
+                ++i;
+            }
+            else if (strcmp(argv[i], "--first") == 0)
+            {
+                valid = ParseNumber(param, config.FirstAccount, 0u);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--count") == 0)
+            {
+                valid = ParseNumber(param, config.Count);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--password") == 0)
+            {
+                valid = param != nullptr;
+                if (valid)
+                    config.Password = param;
+                ++i;
+            }
+            else if (strcmp(argv[i], "--profile") == 0)
+            {
+                std::string error;
+                LoadGen::Profile& profile = config.Profiles.emplace_back();
+                valid = param && profile.LoadFromFile(param, error);
+                if (!error.empty())
+                    printf("%s\n", error.c_str());
+                ++i;
+            }
+            else if (strcmp(argv[i], "--create") == 0)
+            {
+                // race,class
+                std::vector<std::string_view> tokens = Trinity::Tokenize(param ? param : "", ',', false);
+                Optional<uint8> race = tokens.size() == 2 ? Trinity::StringTo<uint8>(tokens[0]) : Optional<uint8>();
+                Optional<uint8> playerClass = tokens.size() == 2 ? Trinity::StringTo<uint8>(tokens[1]) : Optional<uint8>();
+                valid = race && *race && playerClass && *playerClass;
+                if (valid)
+                {
+                    config.CreateRace = *race;
+                    config.CreateClass = *playerClass;
+                }
+                ++i;
+            }
+            else if (strcmp(argv[i], "--duration") == 0)
+            {
+                valid = ParseNumber(param, config.Duration);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--loginRate") == 0)
+            {
+                valid = ParseNumber(param, config.LoginRate);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--loginThreads") == 0)
+            {
+                valid = ParseNumber(param, config.LoginThreads);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--threads") == 0)
+            {
+                valid = ParseNumber(param, config.Threads);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--queryInterval") == 0)
+            {
+                valid = ParseNumber(param, config.QueryInterval, 100u);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--report") == 0)
+            {
+                valid = ParseNumber(param, config.ReportInterval);
+                ++i;
+            }
+            else if (strcmp(argv[i], "--csv") == 0)
+            {
+                valid = param != nullptr;
+                if (valid)
+                    config.CsvFile = param;
+                ++i;
+            }
+            else if (strcmp(argv[i], "--seed") == 0)
+            {
+                valid = ParseNumber(param, config.Seed, 0u);
+                ++i;
+            }
+            else
+            {
+                printf("unknown option '%s', see Info/readme.txt\n", argv[i]);
+                return false;
+            }
+
+            if (!valid)
+            {
+                printf("invalid value for '%s'\n", argv[i - 1]);
+                return false;
+            }
+        }
+
+        if (config.Password.empty())
+        {
+            printf("--password is required\n");
+            return false;
+        }
+
+        if (config.Profiles.empty())
+        {
+            printf("at least one --profile is required\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    void PrintReport(char const* label, LoadGen::StatsSnapshot const& stats, uint32 seconds, uint32 clients)
+    {
+        using namespace LoadGen;
+
+        double const rate = seconds ? 1.0 / seconds : 0.0;
+        printf("[%s] world %d/%u | out %.1f pkt/s %.1f KB/s | in %.1f pkt/s %.1f KB/s\n", label, stats.InWorld, clients,
+            stats[STAT_PACKETS_SENT] * rate, stats[STAT_BYTES_SENT] * rate / 1024.0,
+            stats[STAT_PACKETS_RECEIVED] * rate, stats[STAT_BYTES_RECEIVED] * rate / 1024.0);
+        printf("    ping p50 %u p99 %u ms | world p50 %u p99 %u max %u ms | est. tick %u ms | login p50 %u p99 %u ms\n",
+            stats[LATENCY_PING].P50, stats[LATENCY_PING].P99,
+            stats[LATENCY_WORLD].P50, stats[LATENCY_WORLD].P99, stats[LATENCY_WORLD].Max, stats.GetEstimatedTickTime(),
+            stats[LATENCY_LOGIN].P50, stats[LATENCY_LOGIN].P99);
+        printf("    logins %" PRIu64 " failed %" PRIu64 " dropped %" PRIu64 " | moves %" PRIu64 " casts %" PRIu64 " (went off %" PRIu64 ", failed %" PRIu64 ") | chat %" PRIu64 " commands %" PRIu64 "\n",
+            stats[STAT_LOGINS], stats[STAT_LOGIN_FAILURES], stats[STAT_DISCONNECTS],
+            stats[STAT_MOVES], stats[STAT_CASTS], stats[STAT_SPELLS_GONE], stats[STAT_CASTS_FAILED],
+            stats[STAT_CHAT_MESSAGES], stats[STAT_COMMANDS]);
+    }
+
+    void WriteCsvHeader(FILE* csv)
+    {
+        fprintf(csv, "elapsed,in_world,packets_out_s,bytes_out_s,packets_in_s,bytes_in_s,ping_p50,ping_p99,world_mean,world_p50,world_p99,world_max,"
+            "est_tick,login_p50,login_p99,logins,login_failures,disconnects,moves,casts,spells_gone,casts_failed,chat,commands\n");
+    }
+
+    void WriteCsvRow(FILE* csv, LoadGen::StatsSnapshot const& stats, uint32 elapsed, uint32 seconds)
+    {
+        using namespace LoadGen;
+
+        double const rate = seconds ? 1.0 / seconds : 0.0;
+        fprintf(csv, "%u,%d,%.1f,%.1f,%.1f,%.1f,%u,%u,%.1f,%u,%u,%u,%u,%u,%u,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 "\n",
+            elapsed, stats.InWorld,
+            stats[STAT_PACKETS_SENT] * rate, stats[STAT_BYTES_SENT] * rate, stats[STAT_PACKETS_RECEIVED] * rate, stats[STAT_BYTES_RECEIVED] * rate,
+            stats[LATENCY_PING].P50, stats[LATENCY_PING].P99,
+            stats[LATENCY_WORLD].Mean, stats[LATENCY_WORLD].P50, stats[LATENCY_WORLD].P99, stats[LATENCY_WORLD].Max,
+            stats.GetEstimatedTickTime(), stats[LATENCY_LOGIN].P50, stats[LATENCY_LOGIN].P99,
+            stats[STAT_LOGINS], stats[STAT_LOGIN_FAILURES], stats[STAT_DISCONNECTS],
+            stats[STAT_MOVES], stats[STAT_CASTS], stats[STAT_SPELLS_GONE], stats[STAT_CASTS_FAILED],
+            stats[STAT_CHAT_MESSAGES], stats[STAT_COMMANDS]);
+        fflush(csv);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Trinity::VerifyOsVersion();
+
+    Trinity::Locale::Init();
+
+    Trinity::Banner::Show("Load generator", [](char const* text) { printf("%s\n", text); }, nullptr);
+
+    LoadConfig config;
+    if (!handleArgs(argc, argv, config))
+        return 1;
+
+    FILE* csv = nullptr;
+    if (!config.CsvFile.empty())
+    {
+        csv = fopen(config.CsvFile.c_str(), "w");
+        if (!csv)
+        {
+            printf("cannot open %s for writing\n", config.CsvFile.c_str());
+            return 1;
+        }
+
+        WriteCsvHeader(csv);
+    }
+
+    OpenSSLCrypto::threadsSetup(boost::dll::program_location().remove_filename());
+
+    std::shared_ptr<void> opensslHandle(nullptr, [](void*) { OpenSSLCrypto::threadsCleanup(); });
+
+    std::signal(SIGINT, SignalHandler);
+    std::signal(SIGTERM, SignalHandler);
+
+    auto stats = std::make_unique<LoadGen::LoadStats>();
+
+    // every simulated client stays on one io context, so its handlers never run concurrently
+    using WorkGuard = boost::asio::executor_work_guard<boost::asio::io_context::executor_type>;
+    std::vector<std::unique_ptr<Trinity::Asio::IoContext>> ioContexts;
+    std::vector<WorkGuard> workGuards;
+    std::vector<std::thread> ioThreads;
+    for (uint32 i = 0; i < config.Threads; ++i)
+    {
+        Trinity::Asio::IoContext& ioContext = *ioContexts.emplace_back(std::make_unique<Trinity::Asio::IoContext>(1));
+        workGuards.emplace_back(ioContext.get_executor());
+        ioThreads.emplace_back([&ioContext]() { ioContext.run(); });
+    }
+
+    printf("Logging in %u characters (%s%u - %s%u) at %u logins/s for %u seconds\n", config.Count,
+        config.AccountPrefix.c_str(), config.FirstAccount, config.AccountPrefix.c_str(), config.FirstAccount + config.Count - 1,
+        config.LoginRate, config.Duration);
+
+    std::mutex clientsLock;
+    std::vector<std::shared_ptr<LoadGen::WorldClient>> clients;
+    std::atomic<uint32> nextLogin(0);
+    auto const startTime = std::chrono::steady_clock::now();
+
+    // authserver logins are blocking, the login threads pace them to LoginRate
+    std::vector<std::thread> loginThreads;
+    for (uint32 i = 0; i < std::min(config.LoginThreads, config.Count); ++i)
+    {
+        loginThreads.emplace_back([&]()
+        {
+            boost::asio::io_context authContext;
+            LoadGen::AuthClient authClient(authContext);
+            while (!StopRequested)
+            {
+                uint32 index = nextLogin++;
+                if (index >= config.Count)
+                    break;
+
+                std::this_thread::sleep_until(startTime + std::chrono::milliseconds(uint64(index) * IN_MILLISECONDS / config.LoginRate));
+                if (StopRequested)
+                    break;
+
+                LoadGen::WorldClientInfo info;
+                info.Index = config.FirstAccount + index;
+                info.Account = config.AccountPrefix + std::to_string(info.Index);
+                info.LoginStartTime = getMSTime();
+
+                LoadGen::AuthResult auth;
+                std::string error;
+                if (!authClient.Login(config.AuthHost, config.AuthPort, info.Account, config.Password, auth, error))
+                {
+                    printf("[%s] auth failed: %s\n", info.Account.c_str(), error.c_str());
+                    stats->Add(LoadGen::STAT_LOGIN_FAILURES);
+                    continue;
+                }
+
+                LoadGen::RealmInfo const* realm = nullptr;
+                for (LoadGen::RealmInfo const& realmInfo : auth.Realms)
+                    if (!config.RealmId || realmInfo.Id == *config.RealmId)
+                    {
+                        realm = &realmInfo;
+                        break;
+                    }
+
+                if (!realm)
+                {
+                    printf("[%s] realm not found in realm list\n", info.Account.c_str());
+                    stats->Add(LoadGen::STAT_LOGIN_FAILURES);
+                    continue;
+                }
+
+                if (!config.WorldHost.empty())
+                {
+                    info.Host = config.WorldHost;
+                    info.Port = config.WorldPort;
+                }
+                else if (!SplitAddress(realm->Address, info.Host, info.Port))
+                {
+                    printf("[%s] invalid realm address %s\n", info.Account.c_str(), realm->Address.c_str());
+                    stats->Add(LoadGen::STAT_LOGIN_FAILURES);
+                    continue;
+                }
+
+                Utf8ToUpperOnlyLatin(info.Account);
+                info.Key = auth.Key;
+                info.RealmId = realm->Id;
+                info.Behaviour = &config.Profiles[index % config.Profiles.size()];
+                info.CreateRace = config.CreateRace;
+                info.CreateClass = config.CreateClass;
+                info.QueryInterval = config.QueryInterval;
+                info.Seed = config.Seed * 7919 + info.Index;
+
+                boost::asio::io_context& ioContext = *ioContexts[index % ioContexts.size()];
+                std::shared_ptr<LoadGen::WorldClient> client = std::make_shared<LoadGen::WorldClient>(ioContext, *stats, std::move(info));
+                {
+                    std::lock_guard<std::mutex> lock(clientsLock);
+                    clients.push_back(client);
+                }
+
+                boost::asio::post(ioContext, [client]() { client->Start(); });
+            }
+        });
+    }
+
+    uint32 elapsed = 0;
+    uint32 lastReport = 0;
+    while (!StopRequested && elapsed < config.Duration)
+    {
+        std::this_thread::sleep_until(startTime + std::chrono::seconds(elapsed + 1));
+        ++elapsed;
+
+        if (elapsed - lastReport < config.ReportInterval && elapsed < config.Duration)
+            continue;
+
+        LoadGen::StatsSnapshot interval = stats->ConsumeInterval();
+        char label[16];
+        snprintf(label, sizeof(label), "%5us", elapsed);
+        PrintReport(label, interval, elapsed - lastReport, config.Count);
+        if (csv)
+            WriteCsvRow(csv, interval, elapsed, elapsed - lastReport);
+
+        lastReport = elapsed;
+    }
+
+    StopRequested = true;
+    for (std::thread& thread : loginThreads)
+        thread.join();
+
+    LoadGen::StatsSnapshot total = stats->ConsumeTotal();
+
+    for (std::shared_ptr<LoadGen::WorldClient> const& client : clients)
+        client->Stop();
+
+    workGuards.clear();
+    for (std::thread& thread : ioThreads)
+        thread.join();
+
+    printf("\nSummary of %u seconds\n", elapsed);
+    PrintReport("total", total, elapsed, config.Count);
+
+    if (csv)
+        fclose(csv);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LoadStats.h"
+#include <algorithm>
+
+void LoadGen::LatencyHistogram::Add(uint32 latency)
+{
+    _buckets[std::min(latency, MAX_LATENCY)].fetch_add(1, std::memory_order_relaxed);
+    _sum.fetch_add(latency, std::memory_order_relaxed);
+}
+
+LoadGen::LatencySummary LoadGen::LatencyHistogram::Consume()
+{
+    std::array<uint32, MAX_LATENCY + 1> counts;
+    LatencySummary summary;
+    for (uint32 i = 0; i <= MAX_LATENCY; ++i)
+    {
+        counts[i] = _buckets[i].exchange(0, std::memory_order_relaxed);
+        summary.Count += counts[i];
+        if (counts[i])
+            summary.Max = i;
+    }
+
+    uint64 sum = _sum.exchange(0, std::memory_order_relaxed);
+    if (!summary.Count)
+        return summary;
+
+    summary.Mean = double(sum) / summary.Count;
+
+    uint64 p50Rank = (summary.Count * 50 + 99) / 100;
+    uint64 p99Rank = (summary.Count * 99 + 99) / 100;
+    uint64 seen = 0;
+    bool p50Found = false;
+    for (uint32 i = 0; i <= MAX_LATENCY; ++i)
+    {
+        seen += counts[i];
+        if (!p50Found && seen >= p50Rank)
+        {
+            summary.P50 = i;
+            p50Found = true;
+        }
+
+        if (seen >= p99Rank)
+        {
+            summary.P99 = i;
+            break;
+        }
+    }
+
+    return summary;
+}
+
+uint32 LoadGen::StatsSnapshot::GetEstimatedTickTime() const
+{
+    LatencySummary const& world = Latencies[LATENCY_WORLD];
+    LatencySummary const& ping = Latencies[LATENCY_PING];
+    if (!world.Count || !ping.Count || world.Mean <= ping.Mean)
+        return 0;
+
+    return uint32(2.0 * (world.Mean - ping.Mean));
+}
+
+LoadGen::StatsSnapshot LoadGen::LoadStats::Consume(std::array<std::atomic<uint64>, MAX_STAT_COUNTERS>& counters, std::array<LatencyHistogram, MAX_STAT_LATENCIES>& latencies)
+{
+    StatsSnapshot snapshot;
+    for (uint32 i = 0; i < MAX_STAT_COUNTERS; ++i)
+        snapshot.Counters[i] = counters[i].exchange(0, std::memory_order_relaxed);
+
+    for (uint32 i = 0; i < MAX_STAT_LATENCIES; ++i)
+        snapshot.Latencies[i] = latencies[i].Consume();
+
+    snapshot.InWorld = _inWorld.load(std::memory_order_relaxed);
+    return snapshot;
+}
@@ -0,0 +1,127 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOADGEN_LOAD_STATS_H
+#define _LOADGEN_LOAD_STATS_H
+
+#include "Define.h"
+#include <array>
+#include <atomic>
+
+namespace LoadGen
+{
+    enum StatCounter
+    {
+        STAT_PACKETS_SENT,
+        STAT_PACKETS_RECEIVED,
+        STAT_BYTES_SENT,
+        STAT_BYTES_RECEIVED,
+        STAT_LOGINS,
+        STAT_LOGIN_FAILURES,
+        STAT_DISCONNECTS,
+        STAT_MOVES,
+        STAT_CASTS,
+        STAT_SPELLS_GONE,
+        STAT_CASTS_FAILED,
+        STAT_CHAT_MESSAGES,
+        STAT_COMMANDS,
+
+        MAX_STAT_COUNTERS
+    };
+
+    enum StatLatency
+    {
+        LATENCY_PING,                       // CMSG_PING, answered by the network thread
+        LATENCY_WORLD,                      // CMSG_QUERY_TIME, answered from the world session update
+        LATENCY_LOGIN,                      // authserver connect to SMSG_LOGIN_VERIFY_WORLD
+
+        MAX_STAT_LATENCIES
+    };
+
+    struct LatencySummary
+    {
+        uint64 Count = 0;
+        double Mean = 0.0;
+        uint32 P50 = 0;
+        uint32 P99 = 0;
+        uint32 Max = 0;
+    };
+
+    // 1 ms buckets, samples above MAX_LATENCY are counted in the last bucket
+    class LatencyHistogram
+    {
+        public:
+            static constexpr uint32 MAX_LATENCY = 10000;
+
+            LatencyHistogram() : _buckets(), _sum(0) { }
+
+            void Add(uint32 latency);
+            LatencySummary Consume();
+
+        private:
+            std::array<std::atomic<uint32>, MAX_LATENCY + 1> _buckets;
+            std::atomic<uint64> _sum;
+    };
+
+    struct StatsSnapshot
+    {
+        std::array<uint64, MAX_STAT_COUNTERS> Counters = { };
+        std::array<LatencySummary, MAX_STAT_LATENCIES> Latencies = { };
+        int32 InWorld = 0;
+
+        uint64 operator[](StatCounter counter) const { return Counters[counter]; }
+        LatencySummary const& operator[](StatLatency latency) const { return Latencies[latency]; }
+
+        // a QUERY_TIME request waits on average half a world update more than a ping
+        uint32 GetEstimatedTickTime() const;
+    };
+
+    // Shared by all simulated clients, interval values are reset by every ConsumeInterval call
+    class LoadStats
+    {
+        public:
+            LoadStats() : _interval(), _total(), _inWorld(0) { }
+
+            void Add(StatCounter counter, uint64 value = 1)
+            {
+                _interval[counter].fetch_add(value, std::memory_order_relaxed);
+                _total[counter].fetch_add(value, std::memory_order_relaxed);
+            }
+
+            void AddLatency(StatLatency latency, uint32 ms)
+            {
+                _intervalLatencies[latency].Add(ms);
+                _totalLatencies[latency].Add(ms);
+            }
+
+            void ModifyInWorld(int32 diff) { _inWorld.fetch_add(diff, std::memory_order_relaxed); }
+
+            StatsSnapshot ConsumeInterval() { return Consume(_interval, _intervalLatencies); }
+            StatsSnapshot ConsumeTotal() { return Consume(_total, _totalLatencies); }
+
+        private:
+            StatsSnapshot Consume(std::array<std::atomic<uint64>, MAX_STAT_COUNTERS>& counters, std::array<LatencyHistogram, MAX_STAT_LATENCIES>& latencies);
+
+            std::array<std::atomic<uint64>, MAX_STAT_COUNTERS> _interval;
+            std::array<std::atomic<uint64>, MAX_STAT_COUNTERS> _total;
+            std::array<LatencyHistogram, MAX_STAT_LATENCIES> _intervalLatencies;
+            std::array<LatencyHistogram, MAX_STAT_LATENCIES> _totalLatencies;
+            std::atomic<int32> _inWorld;
+    };
+}
+
+#endif
@@ -0,0 +1,192 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Profile.h"
+#include "StringConvert.h"
+#include "StringFormat.h"
+#include "Util.h"
+#include <fstream>
+
+namespace
+{
+    std::string_view Trim(std::string_view str)
+    {
+        size_t first = str.find_first_not_of(" \t\r");
+        if (first == std::string_view::npos)
+            return {};
+
+        size_t last = str.find_last_not_of(" \t\r");
+        return str.substr(first, last - first + 1);
+    }
+
+    // splits "keyword rest" at the first whitespace
+    std::pair<std::string_view, std::string_view> SplitFirst(std::string_view str)
+    {
+        size_t end = str.find_first_of(" \t");
+        if (end == std::string_view::npos)
+            return { str, {} };
+
+        return { str.substr(0, end), Trim(str.substr(end)) };
+    }
+}
+
+bool LoadGen::Profile::LoadFromFile(std::string const& fileName, std::string& error)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        error = Trinity::StringFormat("cannot open profile {}", fileName);
+        return false;
+    }
+
+    Name = fileName;
+    Actions.clear();
+    LoginCommands.clear();
+    TotalWeight = 0;
+
+    std::string line;
+    uint32 lineNumber = 0;
+    while (std::getline(file, line))
+    {
+        ++lineNumber;
+        std::string_view content = Trim(line);
+        if (content.empty() || content[0] == '#')
+            continue;
+
+        auto [keyword, arguments] = SplitFirst(content);
+        auto fail = [&](std::string_view reason)
+        {
+            error = Trinity::StringFormat("{}:{}: {}", fileName, lineNumber, reason);
+            return false;
+        };
+
+        if (keyword == "name")
+        {
+            Name = std::string(arguments);
+            continue;
+        }
+
+        if (keyword == "interval")
+        {
+            Optional<uint32> interval = Trinity::StringTo<uint32>(arguments);
+            if (!interval || !*interval)
+                return fail("interval must be a positive number of milliseconds");
+
+            ActionInterval = *interval;
+            continue;
+        }
+
+        if (keyword == "login")
+        {
+            if (arguments.empty())
+                return fail("login requires a chat line");
+
+            LoginCommands.emplace_back(arguments);
+            continue;
+        }
+
+        ProfileAction action;
+        if (keyword == "idle")
+            action.Type = PROFILE_ACTION_IDLE;
+        else if (keyword == "move")
+            action.Type = PROFILE_ACTION_MOVE;
+        else if (keyword == "cast")
+            action.Type = PROFILE_ACTION_CAST;
+        else if (keyword == "say")
+            action.Type = PROFILE_ACTION_SAY;
+        else if (keyword == "yell")
+            action.Type = PROFILE_ACTION_YELL;
+        else if (keyword == "command")
+            action.Type = PROFILE_ACTION_COMMAND;
+        else
+            return fail(Trinity::StringFormat("unknown keyword '{}'", keyword));
+
+        auto [weightString, parameters] = SplitFirst(arguments);
+        Optional<uint32> weight = Trinity::StringTo<uint32>(weightString);
+        if (!weight)
+            return fail("action weight missing");
+
+        action.Weight = *weight;
+
+        switch (action.Type)
+        {
+            case PROFILE_ACTION_MOVE:
+            {
+                action.Radius = 20.0f;
+                if (!parameters.empty())
+                {
+                    Optional<float> radius = Trinity::StringTo<float>(parameters);
+                    if (!radius || *radius <= 0.0f)
+                        return fail("move radius must be a positive number");
+
+                    action.Radius = *radius;
+                }
+                break;
+            }
+            case PROFILE_ACTION_CAST:
+                for (std::string_view spell : Trinity::Tokenize(parameters, ',', false))
+                {
+                    Optional<uint32> spellId = Trinity::StringTo<uint32>(Trim(spell));
+                    if (!spellId || !*spellId)
+                        return fail(Trinity::StringFormat("invalid spell id '{}'", spell));
+
+                    action.Spells.push_back(*spellId);
+                }
+
+                if (action.Spells.empty())
+                    return fail("cast requires a comma separated spell list");
+                break;
+            case PROFILE_ACTION_SAY:
+            case PROFILE_ACTION_YELL:
+            case PROFILE_ACTION_COMMAND:
+                if (parameters.empty())
+                    return fail("chat text missing");
+
+                // keeps unprefixed command lines from ending up in /say
+                if (action.Type == PROFILE_ACTION_COMMAND && parameters[0] != '.')
+                    action.Text = ".";
+                action.Text += parameters;
+                break;
+            default:
+                break;
+        }
+
+        TotalWeight += action.Weight;
+        Actions.push_back(std::move(action));
+    }
+
+    if (!TotalWeight)
+    {
+        error = Trinity::StringFormat("{}: profile has no weighted actions", fileName);
+        return false;
+    }
+
+    return true;
+}
+
+LoadGen::ProfileAction const* LoadGen::Profile::SelectAction(uint32 roll) const
+{
+    for (ProfileAction const& action : Actions)
+    {
+        if (roll < action.Weight)
+            return &action;
+
+        roll -= action.Weight;
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOADGEN_PROFILE_H
+#define _LOADGEN_PROFILE_H
+
+#include "Define.h"
+#include <string>
+#include <vector>
+
+namespace LoadGen
+{
+    enum ProfileActionType
+    {
+        PROFILE_ACTION_IDLE,
+        PROFILE_ACTION_MOVE,
+        PROFILE_ACTION_CAST,
+        PROFILE_ACTION_SAY,
+        PROFILE_ACTION_YELL,
+        PROFILE_ACTION_COMMAND
+    };
+
+    struct ProfileAction
+    {
+        ProfileActionType Type = PROFILE_ACTION_IDLE;
+        uint32 Weight = 0;
+        float Radius = 0.0f;                // move: max distance from the login position
+        std::vector<uint32> Spells;         // cast: one of them is cast on self
+        std::string Text;                   // say, yell, command
+    };
+
+    // Scripted behaviour of a simulated character, see Info/readme.txt for the file format
+    struct Profile
+    {
+        std::string Name;
+        uint32 ActionInterval = 2000;       // ms between two actions of a character
+        std::vector<std::string> LoginCommands;
+        std::vector<ProfileAction> Actions;
+        uint32 TotalWeight = 0;
+
+        bool LoadFromFile(std::string const& fileName, std::string& error);
+
+        // roll in [0, TotalWeight)
+        ProfileAction const* SelectAction(uint32 roll) const;
+    };
+}
+
+#endif
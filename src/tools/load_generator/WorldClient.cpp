@@ -0,0 +1,663 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorldClient.h"
+#include "ClientPacket.h"
+#include "Common.h"
+#include "CryptoHash.h"
+#include "CryptoRandom.h"
+#include "HMAC.h"
+#include "LoadStats.h"
+#include "Profile.h"
+#include "Timer.h"
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+using boost::asio::ip::tcp;
+
+namespace
+{
+    // values from SharedDefines.h
+    constexpr uint8 AUTH_OK                 = 12;
+    constexpr uint8 AUTH_WAIT_QUEUE         = 27;
+    constexpr uint8 CHAR_CREATE_SUCCESS     = 47;
+    constexpr uint32 CHAT_MSG_SAY           = 0x01;
+    constexpr uint32 CHAT_MSG_YELL          = 0x06;
+    constexpr uint32 LANG_ORCISH            = 1;
+    constexpr uint32 LANG_COMMON            = 7;
+    constexpr uint32 RACEMASK_ALLIANCE      = (1 << (1 - 1)) | (1 << (3 - 1)) | (1 << (4 - 1)) | (1 << (7 - 1)) | (1 << (11 - 1));
+    constexpr uint32 MOVEMENTFLAG_FORWARD   = 0x00000001;
+
+    constexpr uint32 CLIENT_BUILD           = 12340;
+    constexpr uint32 UPDATE_INTERVAL        = 100;
+    constexpr uint32 PING_INTERVAL          = 30 * IN_MILLISECONDS;     // pings closer than 27s are counted as overspeed by the server
+    constexpr uint32 HEARTBEAT_INTERVAL     = 500;
+    constexpr float RUN_SPEED               = 7.0f;
+}
+
+LoadGen::WorldClient::WorldClient(boost::asio::io_context& ioContext, LoadStats& stats, WorldClientInfo info)
+    : _info(std::move(info)), _stats(stats), _socket(ioContext), _updateTimer(ioContext.get_executor()), _random(_info.Seed),
+    _closed(false), _state(State::Connecting), _header(), _cryptInitialized(false), _guid(0), _race(0), _castCount(0), _characterCreated(false),
+    _homeX(0.0f), _homeY(0.0f), _homeZ(0.0f), _x(0.0f), _y(0.0f), _orientation(0.0f), _moving(false), _moveStartTime(0), _moveEndTime(0),
+    _lastMoveUpdate(0), _nextHeartbeat(0), _nextActionTime(0), _nextPingTime(0), _pingSequence(0), _pingSentTime(0), _nextQueryTime(0), _querySentTime(0)
+{
+}
+
+LoadGen::WorldClient::~WorldClient() = default;
+
+void LoadGen::WorldClient::Start()
+{
+    auto resolver = std::make_shared<tcp::resolver>(_socket.get_executor());
+    resolver->async_resolve(_info.Host, _info.Port, [self = shared_from_this(), resolver](boost::system::error_code const& error, tcp::resolver::results_type results)
+    {
+        if (error)
+        {
+            self->CloseSocket("cannot resolve world server address: " + error.message());
+            return;
+        }
+
+        boost::asio::async_connect(self->_socket, results, [self](boost::system::error_code const& connectError, tcp::endpoint const&)
+        {
+            if (connectError)
+            {
+                self->CloseSocket("cannot connect to world server: " + connectError.message());
+                return;
+            }
+
+            boost::system::error_code ignored;
+            self->_socket.set_option(tcp::no_delay(true), ignored);
+            self->_state = State::Authenticating;
+            self->AsyncReadHeader();
+            self->ScheduleUpdate();
+        });
+    });
+}
+
+void LoadGen::WorldClient::Stop()
+{
+    boost::asio::post(_socket.get_executor(), [self = shared_from_this()]()
+    {
+        if (!self->IsClosed())
+            self->CloseSocket("");
+    });
+}
+
+void LoadGen::WorldClient::CloseSocket(std::string const& reason)
+{
+    if (_closed.exchange(true))
+        return;
+
+    boost::system::error_code ignored;
+    _socket.shutdown(tcp::socket::shutdown_both, ignored);
+    _socket.close(ignored);
+    _updateTimer.cancel(ignored);
+
+    if (reason.empty())
+    {
+        if (_state == State::InWorld)
+            _stats.ModifyInWorld(-1);
+        return;
+    }
+
+    if (_state == State::InWorld)
+    {
+        _stats.ModifyInWorld(-1);
+        _stats.Add(STAT_DISCONNECTS);
+    }
+    else
+        _stats.Add(STAT_LOGIN_FAILURES);
+
+    printf("[%s] %s\n", _info.Account.c_str(), reason.c_str());
+}
+
+void LoadGen::WorldClient::AsyncReadHeader()
+{
+    // both header sizes start with 4 bytes, the 5th one is only read for large packets
+    boost::asio::async_read(_socket, boost::asio::buffer(_header.data(), 4), [self = shared_from_this()](boost::system::error_code const& error, std::size_t)
+    {
+        if (error)
+        {
+            self->CloseSocket("connection lost: " + error.message());
+            return;
+        }
+
+        if (self->_cryptInitialized)
+            self->_decrypt.UpdateData(self->_header.data(), 4);
+
+        self->ReadHeaderHandler();
+    });
+}
+
+void LoadGen::WorldClient::ReadHeaderHandler()
+{
+    if (!(_header[0] & 0x80))
+    {
+        ReadPayload((uint32(_header[0]) << 8) | _header[1], uint16(_header[2] | (_header[3] << 8)));
+        return;
+    }
+
+    boost::asio::async_read(_socket, boost::asio::buffer(&_header[4], 1), [self = shared_from_this()](boost::system::error_code const& error, std::size_t)
+    {
+        if (error)
+        {
+            self->CloseSocket("connection lost: " + error.message());
+            return;
+        }
+
+        if (self->_cryptInitialized)
+            self->_decrypt.UpdateData(&self->_header[4], 1);
+
+        std::array<uint8, 5> const& header = self->_header;
+        self->ReadPayload((uint32(header[0] & 0x7F) << 16) | (uint32(header[1]) << 8) | header[2], uint16(header[3] | (header[4] << 8)));
+    });
+}
+
+void LoadGen::WorldClient::ReadPayload(uint32 size, uint16 opcode)
+{
+    // size includes the opcode
+    if (size < 2)
+    {
+        CloseSocket("malformed packet header");
+        return;
+    }
+
+    _payload.resize(size - 2);
+    _stats.Add(STAT_PACKETS_RECEIVED);
+    _stats.Add(STAT_BYTES_RECEIVED, size + (size > 0x7FFF ? 3 : 2));
+
+    if (_payload.empty())
+    {
+        HandlePacket(opcode);
+        return;
+    }
+
+    boost::asio::async_read(_socket, boost::asio::buffer(_payload), [self = shared_from_this(), opcode](boost::system::error_code const& error, std::size_t)
+    {
+        if (error)
+        {
+            self->CloseSocket("connection lost: " + error.message());
+            return;
+        }
+
+        self->HandlePacket(opcode);
+    });
+}
+
+void LoadGen::WorldClient::HandlePacket(uint16 opcode)
+{
+    if (IsClosed())
+        return;
+
+    PacketReader packet(opcode, _payload.data(), _payload.size());
+    try
+    {
+        switch (opcode)
+        {
+            case SMSG_AUTH_CHALLENGE:
+                HandleAuthChallenge(packet);
+                break;
+            case SMSG_AUTH_RESPONSE:
+                HandleAuthResponse(packet);
+                break;
+            case SMSG_CHAR_ENUM:
+                HandleCharEnum(packet);
+                break;
+            case SMSG_CHAR_CREATE:
+                HandleCharCreate(packet);
+                break;
+            case SMSG_CHARACTER_LOGIN_FAILED:
+                CloseSocket("character login failed");
+                return;
+            case SMSG_LOGIN_VERIFY_WORLD:
+                HandleLoginVerifyWorld(packet);
+                break;
+            case SMSG_TIME_SYNC_REQ:
+                HandleTimeSyncRequest(packet);
+                break;
+            case SMSG_PONG:
+                HandlePong(packet);
+                break;
+            case SMSG_QUERY_TIME_RESPONSE:
+                HandleQueryTimeResponse(packet);
+                break;
+            case SMSG_SPELL_GO:
+                HandleSpellGo(packet);
+                break;
+            case SMSG_CAST_FAILED:
+                _stats.Add(STAT_CASTS_FAILED);
+                break;
+            default:
+                break;
+        }
+    }
+    catch (PacketReadException const& e)
+    {
+        CloseSocket(e.what());
+        return;
+    }
+
+    if (!IsClosed())
+        AsyncReadHeader();
+}
+
+void LoadGen::WorldClient::SendPacket(PacketWriter const& packet)
+{
+    if (IsClosed())
+        return;
+
+    // client header: big endian size including the opcode, little endian uint32 opcode
+    uint32 size = uint32(packet.GetSize() + 4);
+    std::vector<uint8> buffer;
+    buffer.reserve(6 + packet.GetSize());
+    buffer.push_back(uint8(size >> 8));
+    buffer.push_back(uint8(size));
+    buffer.push_back(uint8(packet.GetOpcode()));
+    buffer.push_back(uint8(packet.GetOpcode() >> 8));
+    buffer.push_back(0);
+    buffer.push_back(0);
+
+    if (_cryptInitialized)
+        _encrypt.UpdateData(buffer.data(), 6);
+
+    buffer.insert(buffer.end(), packet.GetData().begin(), packet.GetData().end());
+
+    _stats.Add(STAT_PACKETS_SENT);
+    _stats.Add(STAT_BYTES_SENT, buffer.size());
+
+    _writeQueue.push_back(std::move(buffer));
+    if (_writeQueue.size() == 1)
+        AsyncWrite();
+}
+
+void LoadGen::WorldClient::AsyncWrite()
+{
+    boost::asio::async_write(_socket, boost::asio::buffer(_writeQueue.front()), [self = shared_from_this()](boost::system::error_code const& error, std::size_t)
+    {
+        if (error)
+        {
+            self->CloseSocket("write failed: " + error.message());
+            return;
+        }
+
+        self->_writeQueue.pop_front();
+        if (!self->_writeQueue.empty() && !self->IsClosed())
+            self->AsyncWrite();
+    });
+}
+
+void LoadGen::WorldClient::HandleAuthChallenge(PacketReader& packet)
+{
+    packet.Skip(4);
+    std::array<uint8, 4> serverSeed;
+    packet.Read(serverSeed);
+
+    std::array<uint8, 4> localChallenge = Trinity::Crypto::GetRandomBytes<4>();
+    uint8 const zero[4] = { };
+    Trinity::Crypto::SHA1::Digest digest = Trinity::Crypto::SHA1::GetDigestOf(_info.Account, zero, localChallenge, serverSeed, _info.Key);
+
+    PacketWriter authSession(CMSG_AUTH_SESSION, 64 + _info.Account.size());
+    authSession << uint32(CLIENT_BUILD);
+    authSession << uint32(0);                               // login server id
+    authSession << _info.Account;
+    authSession << uint32(0);                               // login server type
+    authSession.Append(localChallenge);
+    authSession << uint32(0);                               // region id
+    authSession << uint32(0);                               // battlegroup id
+    authSession << uint32(_info.RealmId);
+    authSession << uint64(0);                               // dos response
+    authSession.Append(digest);
+    authSession << uint32(0);                               // empty addon info, must not be missing
+    SendPacket(authSession);
+
+    // everything after CMSG_AUTH_SESSION has encrypted headers
+    uint8 const encryptKey[] = { 0xC2, 0xB3, 0x72, 0x3C, 0xC6, 0xAE, 0xD9, 0xB5, 0x34, 0x3C, 0x53, 0xEE, 0x2F, 0x43, 0x67, 0xCE };
+    uint8 const decryptKey[] = { 0xCC, 0x98, 0xAE, 0x04, 0xE8, 0x97, 0xEA, 0xCA, 0x12, 0xDD, 0xC0, 0x93, 0x42, 0x91, 0x53, 0x57 };
+    _encrypt.Init(Trinity::Crypto::HMAC_SHA1::GetDigestOf(encryptKey, _info.Key));
+    _decrypt.Init(Trinity::Crypto::HMAC_SHA1::GetDigestOf(decryptKey, _info.Key));
+
+    // ARC4-drop1024, same as AuthCrypt
+    std::array<uint8, 1024> syncBuf;
+    _encrypt.UpdateData(syncBuf);
+    _decrypt.UpdateData(syncBuf);
+    _cryptInitialized = true;
+}
+
+void LoadGen::WorldClient::HandleAuthResponse(PacketReader& packet)
+{
+    uint8 code = packet.Read<uint8>();
+    if (code == AUTH_WAIT_QUEUE)
+        return;
+
+    if (code != AUTH_OK)
+    {
+        CloseSocket("world server rejected session with code " + std::to_string(code));
+        return;
+    }
+
+    _state = State::CharacterList;
+    SendPacket(PacketWriter(CMSG_CHAR_ENUM, 0));
+}
+
+void LoadGen::WorldClient::HandleCharEnum(PacketReader& packet)
+{
+    if (!packet.Read<uint8>())
+    {
+        if (!_info.CreateRace || _characterCreated)
+        {
+            CloseSocket("account has no characters");
+            return;
+        }
+
+        PacketWriter create(CMSG_CHAR_CREATE, 32);
+        create << GetCharacterName();
+        create << uint8(_info.CreateRace) << uint8(_info.CreateClass) << uint8(_info.Index & 1);
+        create << uint8(0) << uint8(0) << uint8(0) << uint8(0) << uint8(0);     // skin, face, hair style, hair color, facial hair
+        create << uint8(0);                                                     // outfit
+        SendPacket(create);
+
+        _state = State::CreatingCharacter;
+        return;
+    }
+
+    // first character of the account is used
+    _guid = packet.Read<uint64>();
+    packet.ReadCString();
+    _race = packet.Read<uint8>();
+
+    PacketWriter login(CMSG_PLAYER_LOGIN, 8);
+    login << uint64(_guid);
+    SendPacket(login);
+
+    _state = State::LoggingIn;
+}
+
+void LoadGen::WorldClient::HandleCharCreate(PacketReader& packet)
+{
+    uint8 code = packet.Read<uint8>();
+    if (code != CHAR_CREATE_SUCCESS)
+    {
+        CloseSocket("character creation failed with code " + std::to_string(code));
+        return;
+    }
+
+    _characterCreated = true;
+    _state = State::CharacterList;
+    SendPacket(PacketWriter(CMSG_CHAR_ENUM, 0));
+}
+
+void LoadGen::WorldClient::HandleLoginVerifyWorld(PacketReader& packet)
+{
+    // also sent after far teleports, only the first one completes the login
+    packet.Skip(4);
+    _homeX = _x = packet.Read<float>();
+    _homeY = _y = packet.Read<float>();
+    _homeZ = packet.Read<float>();
+    _orientation = packet.Read<float>();
+    _moving = false;
+
+    if (_state == State::InWorld)
+        return;
+
+    _state = State::InWorld;
+    _stats.ModifyInWorld(1);
+    _stats.Add(STAT_LOGINS);
+    _stats.AddLatency(LATENCY_LOGIN, getMSTimeDiff(_info.LoginStartTime, getMSTime()));
+
+    PacketWriter activeMover(CMSG_SET_ACTIVE_MOVER, 8);
+    activeMover << uint64(_guid);
+    SendPacket(activeMover);
+
+    for (std::string const& command : _info.Behaviour->LoginCommands)
+        SendChat(CHAT_MSG_SAY, command);
+
+    // spread the periodic traffic of clients that logged in at the same time
+    uint32 now = getMSTime();
+    _nextActionTime = now + std::uniform_int_distribution<uint32>(0, _info.Behaviour->ActionInterval)(_random);
+    _nextPingTime = now + std::uniform_int_distribution<uint32>(0, _info.QueryInterval)(_random);
+    _nextQueryTime = now + std::uniform_int_distribution<uint32>(0, _info.QueryInterval)(_random);
+}
+
+void LoadGen::WorldClient::HandleTimeSyncRequest(PacketReader& packet)
+{
+    PacketWriter response(CMSG_TIME_SYNC_RESP, 8);
+    response << packet.Read<uint32>();
+    response << getMSTime();
+    SendPacket(response);
+}
+
+void LoadGen::WorldClient::HandlePong(PacketReader& packet)
+{
+    if (packet.Read<uint32>() != _pingSequence || !_pingSentTime)
+        return;
+
+    _stats.AddLatency(LATENCY_PING, getMSTimeDiff(_pingSentTime, getMSTime()));
+    _pingSentTime = 0;
+}
+
+void LoadGen::WorldClient::HandleQueryTimeResponse(PacketReader& /*packet*/)
+{
+    if (!_querySentTime)
+        return;
+
+    _stats.AddLatency(LATENCY_WORLD, getMSTimeDiff(_querySentTime, getMSTime()));
+    _querySentTime = 0;
+}
+
+void LoadGen::WorldClient::HandleSpellGo(PacketReader& packet)
+{
+    packet.ReadPackedGuid();                                // caster item or unit
+    if (packet.ReadPackedGuid() == _guid)
+        _stats.Add(STAT_SPELLS_GONE);
+}
+
+void LoadGen::WorldClient::ScheduleUpdate()
+{
+    _updateTimer.expires_from_now(boost::posix_time::milliseconds(UPDATE_INTERVAL));
+    _updateTimer.async_wait([self = shared_from_this()](boost::system::error_code const& error)
+    {
+        if (error || self->IsClosed())
+            return;
+
+        self->Update();
+        self->ScheduleUpdate();
+    });
+}
+
+void LoadGen::WorldClient::Update()
+{
+    if (_state != State::InWorld)
+        return;
+
+    uint32 now = getMSTime();
+
+    if (now >= _nextPingTime)
+    {
+        PacketWriter ping(CMSG_PING, 8);
+        ping << uint32(++_pingSequence);
+        ping << uint32(0);                                  // latency
+        SendPacket(ping);
+
+        _pingSentTime = now;
+        _nextPingTime = now + PING_INTERVAL;
+    }
+
+    // only one probe in flight, a slow world update delays the next one instead of queueing them
+    if (now >= _nextQueryTime && !_querySentTime)
+    {
+        SendPacket(PacketWriter(CMSG_QUERY_TIME, 0));
+        _querySentTime = now;
+        _nextQueryTime = now + _info.QueryInterval;
+    }
+
+    UpdateMovement(now);
+
+    if (now >= _nextActionTime)
+    {
+        uint32 interval = _info.Behaviour->ActionInterval;
+        _nextActionTime = now + std::uniform_int_distribution<uint32>(interval / 2, interval + interval / 2)(_random);
+
+        uint32 roll = std::uniform_int_distribution<uint32>(0, _info.Behaviour->TotalWeight - 1)(_random);
+        if (ProfileAction const* action = _info.Behaviour->SelectAction(roll))
+            DoAction(*action);
+    }
+}
+
+void LoadGen::WorldClient::DoAction(ProfileAction const& action)
+{
+    switch (action.Type)
+    {
+        case PROFILE_ACTION_MOVE:
+            if (!_moving)
+                StartMove(action.Radius);
+            break;
+        case PROFILE_ACTION_CAST:
+        {
+            uint32 spellId = action.Spells[std::uniform_int_distribution<size_t>(0, action.Spells.size() - 1)(_random)];
+            PacketWriter cast(CMSG_CAST_SPELL, 10);
+            cast << uint8(++_castCount);
+            cast << uint32(spellId);
+            cast << uint8(0);                               // cast flags
+            cast << uint32(0);                              // target mask, self
+            SendPacket(cast);
+            _stats.Add(STAT_CASTS);
+            break;
+        }
+        case PROFILE_ACTION_SAY:
+            SendChat(CHAT_MSG_SAY, action.Text);
+            _stats.Add(STAT_CHAT_MESSAGES);
+            break;
+        case PROFILE_ACTION_YELL:
+            SendChat(CHAT_MSG_YELL, action.Text);
+            _stats.Add(STAT_CHAT_MESSAGES);
+            break;
+        case PROFILE_ACTION_COMMAND:
+            SendChat(CHAT_MSG_SAY, action.Text);
+            _stats.Add(STAT_COMMANDS);
+            break;
+        default:
+            break;
+    }
+}
+
+void LoadGen::WorldClient::StartMove(float radius)
+{
+    // straight run to a random point around the login position, the server does not check height
+    float angle = std::uniform_real_distribution<float>(0.0f, 2.0f * float(M_PI))(_random);
+    float distance = std::uniform_real_distribution<float>(0.0f, radius)(_random);
+    float destX = _homeX + distance * std::cos(angle);
+    float destY = _homeY + distance * std::sin(angle);
+
+    float dx = destX - _x;
+    float dy = destY - _y;
+    float length = std::sqrt(dx * dx + dy * dy);
+    if (length < 1.0f)
+        return;
+
+    uint32 now = getMSTime();
+    _orientation = std::atan2(dy, dx);
+    if (_orientation < 0.0f)
+        _orientation += 2.0f * float(M_PI);
+
+    _moving = true;
+    _moveStartTime = now;
+    _moveEndTime = now + uint32(length / RUN_SPEED * 1000.0f);
+    _lastMoveUpdate = now;
+    _nextHeartbeat = now + HEARTBEAT_INTERVAL;
+
+    SendMovement(MSG_MOVE_START_FORWARD, now);
+    _stats.Add(STAT_MOVES);
+}
+
+void LoadGen::WorldClient::UpdateMovement(uint32 now)
+{
+    if (!_moving)
+        return;
+
+    uint32 end = std::min(now, _moveEndTime);
+    float step = RUN_SPEED * getMSTimeDiff(_lastMoveUpdate, end) / 1000.0f;
+    _x += step * std::cos(_orientation);
+    _y += step * std::sin(_orientation);
+    _lastMoveUpdate = end;
+
+    if (now >= _moveEndTime)
+    {
+        _moving = false;
+        SendMovement(MSG_MOVE_STOP, now);
+    }
+    else if (now >= _nextHeartbeat)
+    {
+        _nextHeartbeat = now + HEARTBEAT_INTERVAL;
+        SendMovement(MSG_MOVE_HEARTBEAT, now);
+    }
+}
+
+void LoadGen::WorldClient::SendMovement(uint16 opcode, uint32 now)
+{
+    // MovementInfo as read by WorldSession::ReadMovementInfo without transport, pitch or fall data
+    PacketWriter movement(opcode, 40);
+    movement.AppendPackedGuid(_guid);
+    movement << uint32(_moving ? MOVEMENTFLAG_FORWARD : 0);
+    movement << uint16(0);
+    movement << uint32(now);
+    movement << _x << _y << _homeZ << _orientation;
+    movement << uint32(0);                                  // fall time
+    SendPacket(movement);
+}
+
+void LoadGen::WorldClient::SendChat(uint32 type, std::string const& text)
+{
+    PacketWriter chat(CMSG_MESSAGECHAT, 9 + text.size());
+    chat << uint32(type);
+    chat << uint32(GetLanguage());
+    chat << text;
+    SendPacket(chat);
+}
+
+std::string LoadGen::WorldClient::GetCharacterName() const
+{
+    // alternating consonants and vowels never contain the three equal letters rejected by ObjectMgr::CheckPlayerName
+    static char const consonants[] = "bcdfghjklmnprstvwxz";
+    static char const vowels[] = "aeiouy";
+
+    std::string name = "Lg";
+    uint32 index = _info.Index;
+    for (uint32 i = 0; i < 5; ++i)
+    {
+        if (i & 1)
+        {
+            name += vowels[index % (sizeof(vowels) - 1)];
+            index /= sizeof(vowels) - 1;
+        }
+        else
+        {
+            name += consonants[index % (sizeof(consonants) - 1)];
+            index /= sizeof(consonants) - 1;
+        }
+    }
+
+    return name;
+}
+
+uint32 LoadGen::WorldClient::GetLanguage() const
+{
+    return _race && (RACEMASK_ALLIANCE & (1 << (_race - 1))) ? LANG_COMMON : LANG_ORCISH;
+}
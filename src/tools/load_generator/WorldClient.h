@@ -0,0 +1,157 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef _LOADGEN_WORLD_CLIENT_H
+#define _LOADGEN_WORLD_CLIENT_H
+
+#include "ARC4.h"
+#include "AuthDefines.h"
+#include "DeadlineTimer.h"
+#include "Define.h"
+#include <boost/asio/ip/tcp.hpp>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace LoadGen
+{
+    class LoadStats;
+    class PacketReader;
+    class PacketWriter;
+    struct Profile;
+    struct ProfileAction;
+
+    struct WorldClientInfo
+    {
+        uint32 Index = 0;
+        std::string Account;                // upper case, as sent to the authserver
+        SessionKey Key = { };
+        std::string Host;
+        std::string Port;
+        uint32 RealmId = 0;
+        Profile const* Behaviour = nullptr;
+        uint8 CreateRace = 0;               // 0 disables character creation
+        uint8 CreateClass = 0;
+        uint32 QueryInterval = 1000;        // ms between world latency probes
+        uint32 LoginStartTime = 0;          // getMSTime() when the authserver login started
+        uint32 Seed = 0;
+    };
+
+    // One simulated character: world protocol, header crypt and the profile driven behaviour.
+    // All handlers run on the io_context the client was created with, a single thread must run it.
+    class WorldClient : public std::enable_shared_from_this<WorldClient>
+    {
+        public:
+            WorldClient(boost::asio::io_context& ioContext, LoadStats& stats, WorldClientInfo info);
+            ~WorldClient();
+
+            WorldClient(WorldClient const&) = delete;
+            WorldClient& operator=(WorldClient const&) = delete;
+
+            void Start();
+
+            // Thread safe, the socket is closed from the client's io_context
+            void Stop();
+
+            bool IsClosed() const { return _closed.load(std::memory_order_relaxed); }
+
+        private:
+            enum class State
+            {
+                Connecting,
+                Authenticating,
+                CharacterList,
+                CreatingCharacter,
+                LoggingIn,
+                InWorld
+            };
+
+            void CloseSocket(std::string const& reason);
+
+            void AsyncReadHeader();
+            void ReadHeaderHandler();
+            void ReadPayload(uint32 size, uint16 opcode);
+            void HandlePacket(uint16 opcode);
+
+            void SendPacket(PacketWriter const& packet);
+            void AsyncWrite();
+
+            void HandleAuthChallenge(PacketReader& packet);
+            void HandleAuthResponse(PacketReader& packet);
+            void HandleCharEnum(PacketReader& packet);
+            void HandleCharCreate(PacketReader& packet);
+            void HandleLoginVerifyWorld(PacketReader& packet);
+            void HandleTimeSyncRequest(PacketReader& packet);
+            void HandlePong(PacketReader& packet);
+            void HandleQueryTimeResponse(PacketReader& packet);
+            void HandleSpellGo(PacketReader& packet);
+
+            void ScheduleUpdate();
+            void Update();
+            void DoAction(ProfileAction const& action);
+            void StartMove(float radius);
+            void UpdateMovement(uint32 now);
+            void SendMovement(uint16 opcode, uint32 now);
+            void SendChat(uint32 type, std::string const& text);
+
+            std::string GetCharacterName() const;
+            uint32 GetLanguage() const;
+
+            WorldClientInfo _info;
+            LoadStats& _stats;
+            boost::asio::ip::tcp::socket _socket;
+            Trinity::Asio::DeadlineTimer _updateTimer;
+            std::mt19937 _random;
+            std::atomic<bool> _closed;
+            State _state;
+
+            std::array<uint8, 5> _header;
+            std::vector<uint8> _payload;
+            std::deque<std::vector<uint8>> _writeQueue;
+
+            Trinity::Crypto::ARC4 _encrypt;
+            Trinity::Crypto::ARC4 _decrypt;
+            bool _cryptInitialized;
+
+            uint64 _guid;
+            uint8 _race;
+            uint8 _castCount;
+            bool _characterCreated;
+
+            // position from SMSG_LOGIN_VERIFY_WORLD, movement stays around it
+            float _homeX, _homeY, _homeZ;
+            float _x, _y, _orientation;
+            bool _moving;
+            uint32 _moveStartTime;
+            uint32 _moveEndTime;
+            uint32 _lastMoveUpdate;
+            uint32 _nextHeartbeat;
+
+            uint32 _nextActionTime;
+            uint32 _nextPingTime;
+            uint32 _pingSequence;
+            uint32 _pingSentTime;
+            uint32 _nextQueryTime;
+            uint32 _querySentTime;
+    };
+}
+
+#endif
@@ -22,11 +22,15 @@
 #include "ModelInstance.h"
 #include "PathCommon.h"
 #include "StringFormat.h"
+#include "Timer.h"
+#include "Util.h"
 #include "VMapFactory.h"
 #include "VMapManager2.h"
 #include <DetourCommon.h>
 #include <DetourNavMesh.h>
 #include <DetourNavMeshBuilder.h>
+#include <boost/filesystem/operations.hpp>
+#include <algorithm>
 #include <climits>
 
 namespace MMAP
@@ -231,7 +235,11 @@ namespace MMAP
                 return;
             }
 
-            buildTile(tileInfo.m_mapId, tileInfo.m_tileX, tileInfo.m_tileY, navMesh);
+            m_mapBuilder->startTile(tileInfo.m_mapId);
+
+            TileBuildResult result = buildTile(tileInfo.m_mapId, tileInfo.m_tileX, tileInfo.m_tileY, navMesh);
+
+            m_mapBuilder->finishTile(tileInfo.m_mapId, result);
 
             dtFreeNavMesh(navMesh);
         }
@@ -246,9 +254,12 @@ namespace MMAP
             m_tileBuilders.push_back(new TileBuilder(this, m_skipLiquid, m_bigBaseUnit, m_debugOutput));
         }
 
+        uint32 start = getMSTime();
+
+        std::vector<TileInfo> tileInfos;
         if (mapID)
         {
-            buildMap(*mapID);
+            buildMap(*mapID, tileInfos);
         }
         else
         {
@@ -256,10 +267,20 @@ namespace MMAP
             for (TileList::iterator it = m_tiles.begin(); it != m_tiles.end(); ++it)
             {
                 if (!shouldSkipMap(it->m_mapId))
-                    buildMap(it->m_mapId);
+                    buildMap(it->m_mapId, tileInfos);
             }
         }
 
+        // tiles of all maps share one queue, so idle workers always pick up the next tile whatever map it belongs to.
+        // Queue the most expensive tiles first to avoid ending the run with a few big continent tiles on a single thread
+        std::stable_sort(tileInfos.begin(), tileInfos.end(), [](TileInfo const& left, TileInfo const& right)
+        {
+            return left.m_cost > right.m_cost;
+        });
+
+        for (TileInfo const& tileInfo : tileInfos)
+            _queue.Push(tileInfo);
+
         while (!_queue.Empty())
         {
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
@@ -273,6 +294,94 @@ namespace MMAP
             delete builder;
 
         m_tileBuilders.clear();
+
+        printProgressReport();
+
+        uint32 elapsed = GetMSTimeDiffToNow(start);
+        uint32 built = 0;
+        uint32 failed = 0;
+        for (auto const& [mapId, progress] : m_mapProgress)
+        {
+            built += progress.m_builtTiles;
+            failed += progress.m_failedTiles;
+        }
+
+        printf("Processed %u tiles (%u built, %u failed) in %s, %.2f tiles/s\n", uint32(m_totalTilesProcessed), built, failed,
+            secsToTimeString(elapsed / 1000).c_str(), elapsed ? m_totalTilesProcessed * 1000.0 / elapsed : 0.0);
+    }
+
+    /**************************************************************************/
+    uintmax_t MapBuilder::estimateTileCost(uint32 mapID, uint32 tileX, uint32 tileY) const
+    {
+        // recast time grows with the amount of input geometry, file sizes are a cheap approximation of it
+        uintmax_t cost = 0;
+        boost::system::error_code error;
+
+        uintmax_t size = boost::filesystem::file_size(Trinity::StringFormat("maps/{:03}{:02}{:02}.map", mapID, tileY, tileX), error);
+        if (!error)
+            cost += size;
+
+        size = boost::filesystem::file_size(Trinity::StringFormat("vmaps/{:03}_{:02}_{:02}.vmtile", mapID, tileX, tileY), error);
+        if (!error)
+            cost += size;
+
+        return cost;
+    }
+
+    void MapBuilder::startTile(uint32 mapID)
+    {
+        auto itr = m_mapProgress.find(mapID);
+        if (itr == m_mapProgress.end())
+            return;
+
+        MapProgress& progress = itr->second;
+        std::call_once(progress.m_started, [&progress]() { progress.m_startTime = getMSTime(); });
+    }
+
+    void MapBuilder::finishTile(uint32 mapID, TileBuildResult result)
+    {
+        ++m_totalTilesProcessed;
+
+        auto itr = m_mapProgress.find(mapID);
+        if (itr == m_mapProgress.end())
+            return;
+
+        MapProgress& progress = itr->second;
+        switch (result)
+        {
+            case TILE_BUILD_DONE:
+                ++progress.m_builtTiles;
+                break;
+            case TILE_BUILD_UP_TO_DATE:
+                ++progress.m_upToDateTiles;
+                break;
+            case TILE_BUILD_EMPTY:
+                ++progress.m_emptyTiles;
+                break;
+            case TILE_BUILD_FAILED:
+                ++progress.m_failedTiles;
+                break;
+        }
+
+        if (++progress.m_processedTiles != progress.m_totalTiles)
+            return;
+
+        uint32 elapsed = GetMSTimeDiffToNow(progress.m_startTime);
+        printf("%u%% [Map %03u] Finished %u tiles in %s (%u built, %u up to date, %u empty, %u failed), %.2f tiles/s\n", currentPercentageDone(), mapID,
+            progress.m_totalTiles, secsToTimeString(elapsed / 1000).c_str(), uint32(progress.m_builtTiles), uint32(progress.m_upToDateTiles),
+            uint32(progress.m_emptyTiles), uint32(progress.m_failedTiles), elapsed ? progress.m_totalTiles * 1000.0 / elapsed : 0.0);
+    }
+
+    void MapBuilder::printProgressReport() const
+    {
+        if (m_mapProgress.empty())
+            return;
+
+        printf("\n  Map |  Tiles |  Built | Up to date |  Empty | Failed\n");
+        for (auto const& [mapId, progress] : m_mapProgress)
+            printf("  %03u | %6u | %6u | %10u | %6u | %6u\n", mapId, progress.m_totalTiles, uint32(progress.m_builtTiles),
+                uint32(progress.m_upToDateTiles), uint32(progress.m_emptyTiles), uint32(progress.m_failedTiles));
+        printf("\n");
     }
 
     /**************************************************************************/
@@ -429,7 +538,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void MapBuilder::buildMap(uint32 mapID)
+    void MapBuilder::buildMap(uint32 mapID, std::vector<TileInfo>& tileInfos)
     {
         std::set<uint32>* tiles = getTileList(mapID);
 
@@ -445,6 +554,8 @@ namespace MMAP
                 return;
             }
 
+            m_mapProgress[mapID].m_totalTiles = tiles->size();
+
             // now start building mmtiles for each tile
             printf("[Map %03i] We have %u tiles.                          \n", mapID, (unsigned int)tiles->size());
             for (std::set<uint32>::iterator it = tiles->begin(); it != tiles->end(); ++it)
@@ -459,7 +570,8 @@ namespace MMAP
                 tileInfo.m_tileX = tileX;
                 tileInfo.m_tileY = tileY;
                 memcpy(&tileInfo.m_navMeshParams, navMesh->getParams(), sizeof(dtNavMeshParams));
-                _queue.Push(tileInfo);
+                tileInfo.m_cost = estimateTileCost(mapID, tileX, tileY);
+                tileInfos.push_back(tileInfo);
             }
 
             dtFreeNavMesh(navMesh);
@@ -467,16 +579,8 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void TileBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
+    TileBuildResult TileBuilder::buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh)
     {
-        if(shouldSkipTile(mapID, tileX, tileY))
-        {
-            ++m_mapBuilder->m_totalTilesProcessed;
-            return;
-        }
-
-        printf("%u%% [Map %03i] Building tile [%02u,%02u]\n", m_mapBuilder->currentPercentageDone(), mapID, tileX, tileY);
-
         MeshData meshData;
 
         // get heightmap data
@@ -487,10 +591,7 @@ namespace MMAP
 
         // if there is no data, give up now
         if (!meshData.solidVerts.size() && !meshData.liquidVerts.size())
-        {
-            ++m_mapBuilder->m_totalTilesProcessed;
-            return;
-        }
+            return TILE_BUILD_EMPTY;
 
         // remove unused vertices
         TerrainBuilder::cleanVertices(meshData.solidVerts, meshData.solidTris);
@@ -502,10 +603,7 @@ namespace MMAP
         allVerts.append(meshData.solidVerts);
 
         if (!allVerts.size())
-        {
-            ++m_mapBuilder->m_totalTilesProcessed;
-            return;
-        }
+            return TILE_BUILD_EMPTY;
 
         // get bounds of current tile
         float bmin[3], bmax[3];
@@ -513,10 +611,92 @@ namespace MMAP
 
         m_terrainBuilder->loadOffMeshConnections(mapID, tileX, tileY, meshData, m_mapBuilder->m_offMeshFilePath);
 
-        // build navmesh tile
-        buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        // loading input is cheap compared to recast, skip the tile if nothing it is built from has changed
+        TileInputHash inputHash = calculateInputHash(mapID, meshData, bmin, bmax);
+        TileInputHash storedHash;
+        if (readInputHash(mapID, tileX, tileY, storedHash) && storedHash.m_digest == inputHash.m_digest
+            && (!storedHash.m_hasTile || shouldSkipTile(mapID, tileX, tileY)))
+            return TILE_BUILD_UP_TO_DATE;
+
+        printf("%u%% [Map %03i] Building tile [%02u,%02u]\n", m_mapBuilder->currentPercentageDone(), mapID, tileX, tileY);
 
-        ++m_mapBuilder->m_totalTilesProcessed;
+        // build navmesh tile, a failed tile keeps no input hash so the next run builds it again
+        MoveMapTileResult result = buildMoveMapTile(mapID, tileX, tileY, meshData, bmin, bmax, navMesh);
+        if (result == MOVE_MAP_TILE_FAILED)
+            return TILE_BUILD_FAILED;
+
+        inputHash.m_hasTile = result == MOVE_MAP_TILE_BUILT;
+        writeInputHash(mapID, tileX, tileY, inputHash);
+
+        return TILE_BUILD_DONE;
+    }
+
+    TileInputHash TileBuilder::calculateInputHash(uint32 mapID, MeshData const& meshData, float bmin[3], float bmax[3]) const
+    {
+        auto update = [](Trinity::Crypto::SHA1& sha, auto const& array)
+        {
+            uint32 size = array.size();
+            sha.UpdateData(reinterpret_cast<uint8 const*>(&size), sizeof(size));
+            sha.UpdateData(reinterpret_cast<uint8 const*>(array.getCArray()), array.size() * sizeof(array[0]));
+        };
+
+        Trinity::Crypto::SHA1 sha;
+        update(sha, meshData.solidVerts);
+        update(sha, meshData.solidTris);
+        update(sha, meshData.liquidVerts);
+        update(sha, meshData.liquidTris);
+        update(sha, meshData.liquidType);
+        update(sha, meshData.offMeshConnections);
+        update(sha, meshData.offMeshConnectionRads);
+        update(sha, meshData.offMeshConnectionDirs);
+        update(sha, meshData.offMeshConnectionsAreas);
+        update(sha, meshData.offMeshConnectionsFlags);
+
+        // build settings, rcConfig is memset before being filled so its bytes are stable
+        rcConfig config = m_mapBuilder->GetMapSpecificConfig(mapID, bmin, bmax, TileConfig(m_bigBaseUnit));
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&config), sizeof(config));
+
+        MmapTileHeader header;
+        header.usesLiquids = m_terrainBuilder->usesLiquids();
+        sha.UpdateData(reinterpret_cast<uint8 const*>(&header), sizeof(header));
+        sha.Finalize();
+
+        TileInputHash hash;
+        hash.m_digest = sha.GetDigest();
+        hash.m_hasTile = 0;
+        return hash;
+    }
+
+    bool TileBuilder::readInputHash(uint32 mapID, uint32 tileX, uint32 tileY, TileInputHash& hash)
+    {
+        char fileName[255];
+        sprintf(fileName, "mmaps/%03u%02i%02i.mmhash", mapID, tileY, tileX);
+        FILE* file = fopen(fileName, "rb");
+        if (!file)
+            return false;
+
+        bool result = fread(hash.m_digest.data(), hash.m_digest.size(), 1, file) == 1
+            && fread(&hash.m_hasTile, sizeof(hash.m_hasTile), 1, file) == 1;
+        fclose(file);
+        return result;
+    }
+
+    void TileBuilder::writeInputHash(uint32 mapID, uint32 tileX, uint32 tileY, TileInputHash const& hash)
+    {
+        char fileName[255];
+        sprintf(fileName, "mmaps/%03u%02i%02i.mmhash", mapID, tileY, tileX);
+        FILE* file = fopen(fileName, "wb");
+        if (!file)
+        {
+            char message[1024];
+            sprintf(message, "[Map %03i] Failed to open %s for writing!\n", mapID, fileName);
+            perror(message);
+            return;
+        }
+
+        fwrite(hash.m_digest.data(), hash.m_digest.size(), 1, file);
+        fwrite(&hash.m_hasTile, sizeof(hash.m_hasTile), 1, file);
+        fclose(file);
     }
 
     /**************************************************************************/
@@ -595,7 +775,7 @@ namespace MMAP
     }
 
     /**************************************************************************/
-    void TileBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
+    MoveMapTileResult TileBuilder::buildMoveMapTile(uint32 mapID, uint32 tileX, uint32 tileY,
         MeshData &meshData, float bmin[3], float bmax[3],
         dtNavMesh* navMesh)
     {
@@ -637,6 +817,7 @@ namespace MMAP
         rcPolyMesh** pmmerge = new rcPolyMesh*[TILES_PER_MAP * TILES_PER_MAP];
         rcPolyMeshDetail** dmmerge = new rcPolyMeshDetail*[TILES_PER_MAP * TILES_PER_MAP];
         int nmerge = 0;
+        bool subTileFailed = false;
         // build all tiles
         for (int y = 0; y < TILES_PER_MAP; ++y)
         {
@@ -660,6 +841,7 @@ namespace MMAP
                 if (!tile.solid || !rcCreateHeightfield(m_rcContext, *tile.solid, tileCfg.width, tileCfg.height, tileCfg.bmin, tileCfg.bmax, tileCfg.cs, tileCfg.ch))
                 {
                     printf("%s Failed building heightfield!            \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -690,6 +872,7 @@ namespace MMAP
                 if (!tile.chf || !rcBuildCompactHeightfield(m_rcContext, tileCfg.walkableHeight, tileCfg.walkableClimb, *tile.solid, *tile.chf))
                 {
                     printf("%s Failed compacting heightfield!            \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -697,24 +880,28 @@ namespace MMAP
                 if (!rcErodeWalkableArea(m_rcContext, config.walkableRadius, *tile.chf))
                 {
                     printf("%s Failed eroding area!                    \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
                 if (!rcMedianFilterWalkableArea(m_rcContext, *tile.chf))
                 {
                     printf("%s Failed filtering area!                  \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
                 if (!rcBuildDistanceField(m_rcContext, *tile.chf))
                 {
                     printf("%s Failed building distance field!         \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
                 if (!rcBuildRegions(m_rcContext, *tile.chf, tileCfg.borderSize, tileCfg.minRegionArea, tileCfg.mergeRegionArea))
                 {
                     printf("%s Failed building regions!                \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -722,6 +909,7 @@ namespace MMAP
                 if (!tile.cset || !rcBuildContours(m_rcContext, *tile.chf, tileCfg.maxSimplificationError, tileCfg.maxEdgeLen, *tile.cset))
                 {
                     printf("%s Failed building contours!               \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -730,6 +918,7 @@ namespace MMAP
                 if (!tile.pmesh || !rcBuildPolyMesh(m_rcContext, *tile.cset, tileCfg.maxVertsPerPoly, *tile.pmesh))
                 {
                     printf("%s Failed building polymesh!               \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -737,6 +926,7 @@ namespace MMAP
                 if (!tile.dmesh || !rcBuildPolyMeshDetail(m_rcContext, *tile.pmesh, *tile.chf, tileCfg.detailSampleDist, tileCfg.detailSampleMaxError, *tile.dmesh))
                 {
                     printf("%s Failed building polymesh detail!        \n", tileString);
+                    subTileFailed = true;
                     continue;
                 }
 
@@ -763,9 +953,10 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return MOVE_MAP_TILE_FAILED;
         }
-        rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh);
+        if (!rcMergePolyMeshes(m_rcContext, pmmerge, nmerge, *iv.polyMesh))
+            subTileFailed = true;
 
         iv.polyMeshDetail = rcAllocPolyMeshDetail();
         if (!iv.polyMeshDetail)
@@ -774,9 +965,10 @@ namespace MMAP
             delete[] pmmerge;
             delete[] dmmerge;
             delete[] tiles;
-            return;
+            return MOVE_MAP_TILE_FAILED;
         }
-        rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail);
+        if (!rcMergePolyMeshDetails(m_rcContext, dmmerge, nmerge, *iv.polyMeshDetail))
+            subTileFailed = true;
 
         // free things up
         delete[] pmmerge;
@@ -834,6 +1026,8 @@ namespace MMAP
         // will hold final navmesh
         unsigned char* navData = nullptr;
         int navDataSize = 0;
+        // a tile missing some of its subtiles is written but still reported as failed
+        MoveMapTileResult result = subTileFailed ? MOVE_MAP_TILE_FAILED : MOVE_MAP_TILE_EMPTY;
 
         do
         {
@@ -842,11 +1036,13 @@ namespace MMAP
             if (params.nvp > DT_VERTS_PER_POLYGON)
             {
                 printf("%s Invalid verts-per-polygon value!        \n", tileString);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
             if (params.vertCount >= 0xffff)
             {
                 printf("%s Too many vertices!                      \n", tileString);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
             if (!params.vertCount || !params.verts)
@@ -868,6 +1064,7 @@ namespace MMAP
             if (!params.detailMeshes || !params.detailVerts || !params.detailTris)
             {
                 printf("%s No detail mesh to build tile!           \n", tileString);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
 
@@ -875,6 +1072,7 @@ namespace MMAP
             if (!dtCreateNavMeshData(&params, &navData, &navDataSize))
             {
                 printf("%s Failed building navmesh tile!           \n", tileString);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
 
@@ -886,6 +1084,7 @@ namespace MMAP
             if (!tileRef || dtResult != DT_SUCCESS)
             {
                 printf("%s Failed adding tile to navmesh!           \n", tileString);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
 
@@ -899,6 +1098,7 @@ namespace MMAP
                 sprintf(message, "[Map %03i] Failed to open %s for writing!\n", mapID, fileName);
                 perror(message);
                 navMesh->removeTile(tileRef, nullptr, nullptr);
+                result = MOVE_MAP_TILE_FAILED;
                 break;
             }
 
@@ -908,7 +1108,7 @@ namespace MMAP
             MmapTileHeader header;
             header.usesLiquids = m_terrainBuilder->usesLiquids();
             header.size = uint32(navDataSize);
-            fwrite(&header, sizeof(MmapTileHeader), 1, file);
+            bool written = fwrite(&header, sizeof(MmapTileHeader), 1, file) == 1;
 
             /*
             dtMeshHeader* navDataHeader = (dtMeshHeader*)navData;
@@ -916,11 +1116,17 @@ namespace MMAP
             */
 
             // write data
-            fwrite(navData, sizeof(unsigned char), navDataSize, file);
-            fclose(file);
+            written = written && fwrite(navData, sizeof(unsigned char), navDataSize, file) == size_t(navDataSize);
+            written = fclose(file) == 0 && written;
+            if (!written)
+                printf("%s Failed writing %s!\n", tileString, fileName);
 
             // now that tile is written to disk, we can unload it
             navMesh->removeTile(tileRef, nullptr, nullptr);
+            if (!written)
+                result = MOVE_MAP_TILE_FAILED;
+            else if (result != MOVE_MAP_TILE_FAILED)
+                result = MOVE_MAP_TILE_BUILT;
         }
         while (false);
 
@@ -937,6 +1143,8 @@ namespace MMAP
             iv.generateObjFile(mapID, tileX, tileY, meshData);
             iv.writeIV(mapID, tileX, tileY);
         }
+
+        return result;
     }
 
     /**************************************************************************/
@@ -20,6 +20,7 @@
 
 #include "TerrainBuilder.h"
 
+#include "CryptoHash.h"
 #include "Recast.h"
 #include "DetourNavMesh.h"
 #include "Optional.h"
@@ -28,6 +29,8 @@
 #include <vector>
 #include <set>
 #include <list>
+#include <map>
+#include <mutex>
 #include <atomic>
 #include <thread>
 
@@ -94,12 +97,52 @@ namespace MMAP
 
     struct TileInfo
     {
-        TileInfo() : m_mapId(uint32(-1)), m_tileX(), m_tileY(), m_navMeshParams() {}
+        TileInfo() : m_mapId(uint32(-1)), m_tileX(), m_tileY(), m_navMeshParams(), m_cost(0) {}
 
         uint32 m_mapId;
         uint32 m_tileX;
         uint32 m_tileY;
         dtNavMeshParams m_navMeshParams;
+        uintmax_t m_cost;       // estimated from input file sizes, most expensive tiles are queued first
+    };
+
+    enum TileBuildResult
+    {
+        TILE_BUILD_DONE,        // tile was (re)built
+        TILE_BUILD_UP_TO_DATE,  // input hash matches the one stored with the existing tile
+        TILE_BUILD_EMPTY,       // no terrain or model data
+        TILE_BUILD_FAILED       // recast, detour or file error, no input hash is stored so the next run retries it
+    };
+
+    enum MoveMapTileResult
+    {
+        MOVE_MAP_TILE_BUILT,    // .mmtile written
+        MOVE_MAP_TILE_EMPTY,    // no polygons, nothing to write
+        MOVE_MAP_TILE_FAILED
+    };
+
+    // Stored as mmaps/MMMYYXX.mmhash next to every built tile, a tile is only rebuilt when
+    // the hash of its terrain, model and offmesh input or of the build settings changes
+    struct TileInputHash
+    {
+        Trinity::Crypto::SHA1::Digest m_digest;
+        uint8 m_hasTile;        // tiles without polygons have no .mmtile
+
+        bool operator==(TileInputHash const& right) const { return m_digest == right.m_digest && m_hasTile == right.m_hasTile; }
+    };
+
+    struct MapProgress
+    {
+        MapProgress() : m_totalTiles(0), m_startTime(0), m_processedTiles(0), m_builtTiles(0), m_upToDateTiles(0), m_emptyTiles(0), m_failedTiles(0) {}
+
+        uint32 m_totalTiles;
+        std::once_flag m_started;
+        uint32 m_startTime;
+        std::atomic<uint32> m_processedTiles;
+        std::atomic<uint32> m_builtTiles;
+        std::atomic<uint32> m_upToDateTiles;
+        std::atomic<uint32> m_emptyTiles;
+        std::atomic<uint32> m_failedTiles;
     };
 
     // ToDo: move this to its own file. For now it will stay here to keep the changes to a minimum, especially in the cpp file
@@ -118,9 +161,9 @@ namespace MMAP
             void WorkerThread();
             void WaitCompletion();
 
-            void buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
+            TileBuildResult buildTile(uint32 mapID, uint32 tileX, uint32 tileY, dtNavMesh* navMesh);
             // move map building
-            void buildMoveMapTile(uint32 mapID,
+            MoveMapTileResult buildMoveMapTile(uint32 mapID,
                 uint32 tileX,
                 uint32 tileY,
                 MeshData& meshData,
@@ -130,6 +173,10 @@ namespace MMAP
 
             bool shouldSkipTile(uint32 mapID, uint32 tileX, uint32 tileY) const;
 
+            TileInputHash calculateInputHash(uint32 mapID, MeshData const& meshData, float bmin[3], float bmax[3]) const;
+            static bool readInputHash(uint32 mapID, uint32 tileX, uint32 tileY, TileInputHash& hash);
+            static void writeInputHash(uint32 mapID, uint32 tileX, uint32 tileY, TileInputHash const& hash);
+
         private:
             bool m_bigBaseUnit;
             bool m_debugOutput;
@@ -169,14 +216,19 @@ namespace MMAP
             void buildMaps(Optional<uint32> mapID);
 
         private:
-            // builds all mmap tiles for the specified map id (ignores skip settings)
-            void buildMap(uint32 mapID);
+            // prepares all mmap tiles of the specified map id for building (ignores skip settings)
+            void buildMap(uint32 mapID, std::vector<TileInfo>& tileInfos);
             // detect maps and tiles
             void discoverTiles();
             std::set<uint32>* getTileList(uint32 mapID);
 
             void buildNavMesh(uint32 mapID, dtNavMesh* &navMesh);
 
+            uintmax_t estimateTileCost(uint32 mapID, uint32 tileX, uint32 tileY) const;
+            void startTile(uint32 mapID);
+            void finishTile(uint32 mapID, TileBuildResult result);
+            void printProgressReport() const;
+
             void getTileBounds(uint32 tileX, uint32 tileY,
                 float* verts, int vertCount,
                 float* bmin, float* bmax) const;
@@ -212,6 +264,9 @@ namespace MMAP
             std::atomic<uint32> m_totalTiles;
             std::atomic<uint32> m_totalTilesProcessed;
 
+            // filled before workers start, only counters are changed while building
+            std::map<uint32, MapProgress> m_mapProgress;
+
             // build performance - not really used for now
             rcContext* m_rcContext;
 
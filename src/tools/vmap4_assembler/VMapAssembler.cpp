@@ -17,6 +17,9 @@
 
 #include <string>
 #include <iostream>
+#include <thread>
+#include <vector>
+#include <cstring>
 
 #include "TileAssembler.h"
 #include "Banner.h"
@@ -33,23 +36,33 @@ int main(int argc, char* argv[])
 
     std::string src = "Buildings";
     std::string dest = "vmaps";
+    uint32 threads = std::thread::hardware_concurrency();
 
-    if (argc > 3)
+    std::vector<std::string> dirs;
+    for (int i = 1; i < argc; ++i)
     {
-        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir>" << std::endl;
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = uint32(std::max(0, atoi(argv[++i])));
+        else
+            dirs.emplace_back(argv[i]);
+    }
+
+    if (dirs.size() > 2)
+    {
+        std::cout << "usage: " << argv[0] << " <raw data dir> <vmap dest dir> [--threads #]" << std::endl;
         return 1;
     }
     else
     {
-        if (argc > 1)
-            src = argv[1];
-        if (argc > 2)
-            dest = argv[2];
+        if (dirs.size() > 0)
+            src = dirs[0];
+        if (dirs.size() > 1)
+            dest = dirs[1];
     }
 
-    std::cout << "using " << src << " as source directory and writing output to " << dest << std::endl;
+    std::cout << "using " << src << " as source directory and writing output to " << dest << " with " << std::max(threads, 1u) << " threads" << std::endl;
 
-    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest);
+    VMAP::TileAssembler* ta = new VMAP::TileAssembler(src, dest, threads);
 
     if (!ta->convertWorld2())
     {
@@ -0,0 +1,249 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "BoundingIntervalHierarchy.h"
+#include "ModelIgnoreFlags.h"
+#include "StringConvert.h"
+#include "Util.h"
+#include "VMapManager2.h"
+#include <cstdlib>
+#include <random>
+
+namespace
+{
+    struct BoxBounds
+    {
+        void operator()(G3D::AABox const& box, G3D::AABox& bounds) const { bounds = box; }
+    };
+
+    struct BoxRayCallback
+    {
+        std::vector<G3D::AABox> const& Boxes;
+
+        bool operator()(G3D::Ray const& ray, uint32 entry, float& distance, bool /*stopAtFirst*/) const
+        {
+            float time = ray.intersectionTime(Boxes[entry]);
+            if (time >= distance)
+                return false;
+
+            distance = time;
+            return true;
+        }
+
+        uint32 operator()(RayPacket const& packet, uint32 entry, float* distance, uint32 laneMask, bool stopAtFirst) const
+        {
+            uint32 hits = 0;
+            RayPacket::ForEachLane(laneMask, [&](uint32 lane)
+            {
+                if ((*this)(packet.Rays[lane], entry, distance[lane], stopAtFirst))
+                    hits |= 1 << lane;
+            });
+            return hits;
+        }
+    };
+
+    G3D::Vector3 RandomPoint(std::mt19937& random, float range)
+    {
+        std::uniform_real_distribution<float> coord(0.0f, range);
+        return G3D::Vector3(coord(random), coord(random), coord(random));
+    }
+}
+
+TEST_CASE("Packet traversal matches single rays", "[BIH]")
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> size(0.5f, 8.0f);
+
+    std::vector<G3D::AABox> boxes;
+    for (uint32 i = 0; i < 500; ++i)
+    {
+        G3D::Vector3 low = RandomPoint(random, 200.0f);
+        boxes.emplace_back(low, low + G3D::Vector3(size(random), size(random), size(random)));
+    }
+
+    BIH tree;
+    BoxBounds getBounds;
+    tree.build(boxes, getBounds);
+    BoxRayCallback callback{ boxes };
+
+    std::vector<G3D::Ray> rays;
+    for (uint32 i = 0; i < 400; ++i)
+    {
+        G3D::Vector3 start = RandomPoint(random, 200.0f);
+        rays.push_back(G3D::Ray::fromOriginAndDirection(start, (RandomPoint(random, 200.0f) - start).direction()));
+    }
+    // height probes, direction with zero components
+    for (uint32 i = 0; i < 100; ++i)
+        rays.push_back(G3D::Ray::fromOriginAndDirection(RandomPoint(random, 200.0f), G3D::Vector3(0.0f, 0.0f, -1.0f)));
+
+    for (bool stopAtFirst : { false, true })
+    {
+        std::vector<float> expected(rays.size(), 150.0f);
+        std::vector<uint8> expectedHit(rays.size());
+        for (uint32 i = 0; i < rays.size(); ++i)
+        {
+            BoxRayCallback single{ boxes };
+            float distance = expected[i];
+            tree.intersectRay(rays[i], single, distance, stopAtFirst);
+            expectedHit[i] = distance < expected[i];
+            expected[i] = distance;
+        }
+
+        std::vector<float> distances(rays.size(), 150.0f);
+        std::vector<uint8> hit(rays.size());
+        RayPacketQueue queue([&](RayPacket const& packet, uint32 const* indices)
+        {
+            float distance[RayPacket::WIDTH] = { 150.0f, 150.0f, 150.0f, 150.0f };
+            tree.intersectRayPacket(packet, callback, distance, stopAtFirst);
+            for (uint32 lane = 0; lane < packet.Count; ++lane)
+            {
+                distances[indices[lane]] = distance[lane];
+                hit[indices[lane]] = distance[lane] < 150.0f;
+            }
+        });
+
+        for (uint32 i = 0; i < rays.size(); ++i)
+            queue.Add(rays[i], i);
+        queue.Flush();
+
+        for (uint32 i = 0; i < rays.size(); ++i)
+        {
+            REQUIRE(hit[i] == expectedHit[i]);
+            // first hit found depends on visiting order only when stopping early
+            if (!stopAtFirst)
+                REQUIRE(distances[i] == expected[i]);
+        }
+    }
+}
+
+TEST_CASE("Packet bounds test", "[BIH]")
+{
+    G3D::Ray rays[3] =
+    {
+        G3D::Ray::fromOriginAndDirection(G3D::Vector3(0.0f, 0.0f, 0.0f), G3D::Vector3(1.0f, 0.0f, 0.0f)),
+        G3D::Ray::fromOriginAndDirection(G3D::Vector3(0.0f, 5.0f, 0.0f), G3D::Vector3(1.0f, 0.0f, 0.0f)),
+        G3D::Ray::fromOriginAndDirection(G3D::Vector3(0.0f, -0.5f, 0.0f), G3D::Vector3(1.0f, 0.0f, 0.0f))
+    };
+
+    RayPacket packet;
+    packet.Set(rays, 3);
+    REQUIRE(packet.GetLaneMask() == 0x7);
+
+    G3D::AABox box(G3D::Vector3(10.0f, -1.0f, -1.0f), G3D::Vector3(12.0f, 1.0f, 1.0f));
+    float distance[RayPacket::WIDTH] = { 20.0f, 20.0f, 5.0f, 20.0f };
+    // second ray passes the box, third one ends before reaching it
+    REQUIRE(packet.IntersectBounds(box, distance, packet.GetLaneMask()) == 0x1);
+    REQUIRE(packet.IntersectBounds(box, distance, 0x6) == 0);
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Build with WITH_BENCHMARKS, set TC_VMAP_BENCHMARK to "<vmaps directory>;<map id>;<tile x>;<tile y>" of an extracted tile
+// and run with "[vmap]" to compare single ray and packet queries on real data
+TEST_CASE("VMap batch queries", "[.][benchmark][vmap]")
+{
+    char const* config = std::getenv("TC_VMAP_BENCHMARK");
+    if (!config)
+    {
+        WARN("TC_VMAP_BENCHMARK not set, skipping");
+        return;
+    }
+
+    std::vector<std::string_view> tokens = Trinity::Tokenize(config, ';', false);
+    REQUIRE(tokens.size() == 4);
+    std::string path(tokens[0]);
+    uint32 mapId = Trinity::StringTo<uint32>(tokens[1]).value_or(0);
+    uint32 tileX = Trinity::StringTo<uint32>(tokens[2]).value_or(0);
+    uint32 tileY = Trinity::StringTo<uint32>(tokens[3]).value_or(0);
+
+    VMAP::VMapManager2 vmgr;
+    REQUIRE(vmgr.loadMap(path.c_str(), mapId, tileX, tileY) == VMAP::VMAP_LOAD_RESULT_OK);
+
+    // world coordinates covered by the tile
+    float const tileSize = 533.33333f;
+    float const maxX = (32 - float(tileX)) * tileSize;
+    float const maxY = (32 - float(tileY)) * tileSize;
+
+    std::mt19937 random(42);
+    std::uniform_real_distribution<float> offset(0.0f, tileSize);
+
+    std::vector<G3D::Vector3> probes(1024);
+    for (G3D::Vector3& probe : probes)
+        probe = G3D::Vector3(maxX - offset(random), maxY - offset(random), 1000.0f);
+
+    std::vector<float> heights(probes.size());
+    vmgr.getHeights(mapId, probes, heights, 2000.0f);
+
+    std::vector<G3D::Vector3> ground;
+    for (std::size_t i = 0; i < probes.size(); ++i)
+    {
+        REQUIRE(heights[i] == vmgr.getHeight(mapId, probes[i].x, probes[i].y, probes[i].z, 2000.0f));
+        if (heights[i] > VMAP_INVALID_HEIGHT_VALUE)
+            ground.emplace_back(probes[i].x, probes[i].y, heights[i] + 2.0f);
+    }
+
+    if (ground.size() < 2)
+    {
+        WARN("Tile has no vmap geometry, skipping line of sight");
+        return;
+    }
+
+    // pairs of nearby points, like spell target and bot positioning checks
+    std::uniform_int_distribution<std::size_t> pick(0, ground.size() - 1);
+    std::vector<G3D::Vector3> starts, ends;
+    for (uint32 i = 0; i < 1024; ++i)
+    {
+        G3D::Vector3 const& start = ground[pick(random)];
+        starts.push_back(start);
+        ends.push_back(start + G3D::Vector3(offset(random) / 16.0f - 16.0f, offset(random) / 16.0f - 16.0f, 0.0f));
+    }
+
+    std::unique_ptr<bool[]> inLoS = std::make_unique<bool[]>(starts.size());
+    vmgr.isInLineOfSight(mapId, starts, ends, { inLoS.get(), starts.size() }, VMAP::ModelIgnoreFlags::Nothing);
+    for (std::size_t i = 0; i < starts.size(); ++i)
+        REQUIRE(inLoS[i] == vmgr.isInLineOfSight(mapId, starts[i].x, starts[i].y, starts[i].z, ends[i].x, ends[i].y, ends[i].z, VMAP::ModelIgnoreFlags::Nothing));
+
+    BENCHMARK("getHeight")
+    {
+        float sum = 0.0f;
+        for (G3D::Vector3 const& probe : probes)
+            sum += vmgr.getHeight(mapId, probe.x, probe.y, probe.z, 2000.0f);
+        return sum;
+    };
+
+    BENCHMARK("getHeights")
+    {
+        vmgr.getHeights(mapId, probes, heights, 2000.0f);
+        return heights[0];
+    };
+
+    BENCHMARK("isInLineOfSight")
+    {
+        uint32 visible = 0;
+        for (std::size_t i = 0; i < starts.size(); ++i)
+            visible += vmgr.isInLineOfSight(mapId, starts[i].x, starts[i].y, starts[i].z, ends[i].x, ends[i].y, ends[i].z, VMAP::ModelIgnoreFlags::Nothing);
+        return visible;
+    };
+
+    BENCHMARK("isInLineOfSight batch")
+    {
+        vmgr.isInLineOfSight(mapId, starts, ends, { inLoS.get(), starts.size() }, VMAP::ModelIgnoreFlags::Nothing);
+        return inLoS[0];
+    };
+}
+#endif
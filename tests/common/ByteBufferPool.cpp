@@ -0,0 +1,94 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "ByteBuffer.h"
+#include "ByteBufferPool.h"
+#include <set>
+#include <thread>
+
+TEST_CASE("Size classes", "[ByteBufferPool]")
+{
+    REQUIRE(ByteBufferPool::GetSizeClass(1) == 0);
+    REQUIRE(ByteBufferPool::GetSizeClass(64) == 0);
+    REQUIRE(ByteBufferPool::GetSizeClass(65) == 1);
+    REQUIRE(ByteBufferPool::GetSizeClass(200) == 2);
+    REQUIRE(ByteBufferPool::GetSizeClass(16384) == ByteBufferPool::SIZE_CLASS_COUNT - 1);
+    REQUIRE(ByteBufferPool::GetSizeClass(16385) == ByteBufferPool::SIZE_CLASS_COUNT);
+
+    REQUIRE(ByteBufferPool::Acquire(0).capacity() == 0);
+    REQUIRE(ByteBufferPool::Acquire(200).capacity() >= 256);
+    REQUIRE(ByteBufferPool::Acquire(100000).capacity() >= 100000);
+}
+
+TEST_CASE("Storage is reused", "[ByteBufferPool]")
+{
+    std::vector<uint8> storage = ByteBufferPool::Acquire(100);
+    storage.resize(100, 1);
+    uint8 const* data = storage.data();
+    ByteBufferPool::Release(std::move(storage));
+    REQUIRE(storage.capacity() == 0);
+
+    std::vector<uint8> reused = ByteBufferPool::Acquire(120);
+    REQUIRE(reused.data() == data);
+    REQUIRE(reused.empty());
+    ByteBufferPool::Release(std::move(reused));
+}
+
+TEST_CASE("Storage released on other thread", "[ByteBufferPool]")
+{
+    std::vector<std::vector<uint8>> buffers;
+    std::set<uint8 const*> pointers;
+    for (int i = 0; i < 64; ++i)
+    {
+        buffers.push_back(ByteBufferPool::Acquire(ByteBufferPool::MAX_SIZE_CLASS));
+        pointers.insert(buffers.back().data());
+    }
+
+    std::thread releaser([&buffers]()
+    {
+        for (std::vector<uint8>& storage : buffers)
+            ByteBufferPool::Release(std::move(storage));
+    });
+    releaser.join();
+
+    // surplus of releasing thread went to shared depot
+    std::vector<uint8> storage = ByteBufferPool::Acquire(ByteBufferPool::MAX_SIZE_CLASS);
+    REQUIRE(pointers.count(storage.data()) == 1);
+    ByteBufferPool::Release(std::move(storage));
+}
+
+TEST_CASE("ByteBuffer growth and copies", "[ByteBufferPool]")
+{
+    ByteBuffer buffer(0);
+    for (uint32 i = 0; i < 5000; ++i)
+        buffer << uint32(i);
+
+    REQUIRE(buffer.size() == 20000);
+    REQUIRE(buffer.read<uint32>(4999 * 4) == 4999);
+
+    ByteBuffer copy(buffer);
+    REQUIRE(copy.size() == buffer.size());
+    REQUIRE(std::memcmp(copy.contents(), buffer.contents(), buffer.size()) == 0);
+
+    ByteBuffer assigned(16);
+    assigned << uint8(1);
+    assigned = copy;
+    REQUIRE(assigned.size() == buffer.size());
+    REQUIRE(assigned.read<uint32>(1234 * 4) == 1234);
+}
@@ -0,0 +1,152 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "DynamicBoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <bit>
+#include <random>
+#include <set>
+
+namespace
+{
+    struct TestObject
+    {
+        G3D::AABox Bounds;
+    };
+
+    struct TestObjectBounds
+    {
+        static void getBounds(TestObject const& obj, G3D::AABox& out) { out = obj.Bounds; }
+    };
+
+    typedef DynamicBVH<TestObject, TestObjectBounds> TestTree;
+
+    struct CollectRayCallback
+    {
+        std::set<TestObject const*> Hits;
+
+        bool operator()(G3D::Ray const& ray, TestObject const& obj, float& maxDist)
+        {
+            if (ray.intersectionTime(obj.Bounds) <= maxDist)
+                Hits.insert(&obj);
+            return false;
+        }
+    };
+
+    struct CollectPointCallback
+    {
+        std::set<TestObject const*> Hits;
+
+        void operator()(G3D::Vector3 const& point, TestObject const& obj)
+        {
+            if (obj.Bounds.contains(point))
+                Hits.insert(&obj);
+        }
+    };
+
+    G3D::AABox RandomBox(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> coord(0.0f, 500.0f);
+        std::uniform_real_distribution<float> size(1.0f, 20.0f);
+        G3D::Vector3 low(coord(random), coord(random), coord(random) / 10.0f);
+        return G3D::AABox(low, low + G3D::Vector3(size(random), size(random), size(random)));
+    }
+}
+
+TEST_CASE("Queries match brute force after incremental changes", "[DynamicBVH]")
+{
+    std::mt19937 random(7);
+    std::vector<TestObject> objects(300);
+    std::vector<bool> inserted(objects.size(), false);
+    TestTree tree;
+
+    for (uint32 step = 0; step < 3000; ++step)
+    {
+        TestObject& obj = objects[random() % objects.size()];
+        std::size_t index = &obj - objects.data();
+        if (!inserted[index])
+        {
+            obj.Bounds = RandomBox(random);
+            tree.insert(obj);
+            inserted[index] = true;
+        }
+        else if (random() % 4 == 0)
+        {
+            tree.remove(obj);
+            inserted[index] = false;
+        }
+        else
+        {
+            // mostly small moves staying inside enlarged leaf bounds
+            std::uniform_real_distribution<float> offset(-3.0f, 3.0f);
+            obj.Bounds = obj.Bounds + G3D::Vector3(offset(random), offset(random), 0.0f);
+            tree.move(obj);
+        }
+    }
+
+    uint32 count = uint32(std::count(inserted.begin(), inserted.end(), true));
+    REQUIRE(tree.size() == count);
+    // height balanced
+    REQUIRE(tree.height() <= int32(2 * std::bit_width(count)));
+
+    std::uniform_real_distribution<float> coord(0.0f, 500.0f);
+    for (uint32 i = 0; i < 200; ++i)
+    {
+        G3D::Vector3 start(coord(random), coord(random), coord(random) / 10.0f);
+        G3D::Vector3 end(coord(random), coord(random), coord(random) / 10.0f);
+        float maxDist = (end - start).magnitude();
+        G3D::Ray ray = G3D::Ray::fromOriginAndDirection(start, (end - start) / maxDist);
+
+        CollectRayCallback rayCallback;
+        tree.intersectRay(ray, rayCallback, maxDist);
+
+        CollectPointCallback pointCallback;
+        tree.intersectPoint(start, pointCallback);
+
+        std::set<TestObject const*> expectedRay, expectedPoint;
+        for (std::size_t j = 0; j < objects.size(); ++j)
+        {
+            if (!inserted[j])
+                continue;
+            if (ray.intersectionTime(objects[j].Bounds) <= maxDist)
+                expectedRay.insert(&objects[j]);
+            if (objects[j].Bounds.contains(start))
+                expectedPoint.insert(&objects[j]);
+        }
+
+        REQUIRE(rayCallback.Hits == expectedRay);
+        REQUIRE(pointCallback.Hits == expectedPoint);
+    }
+}
+
+TEST_CASE("Small moves keep their leaf", "[DynamicBVH]")
+{
+    TestObject obj{ G3D::AABox(G3D::Vector3(0.0f, 0.0f, 0.0f), G3D::Vector3(5.0f, 5.0f, 5.0f)) };
+    TestTree tree;
+    tree.insert(obj);
+
+    obj.Bounds = obj.Bounds + G3D::Vector3(TestTree::BOUNDS_MARGIN * 0.5f, 0.0f, 0.0f);
+    REQUIRE(tree.move(obj) == false);
+
+    obj.Bounds = obj.Bounds + G3D::Vector3(TestTree::BOUNDS_MARGIN * 2.0f, 0.0f, 0.0f);
+    REQUIRE(tree.move(obj) == true);
+
+    tree.remove(obj);
+    REQUIRE(tree.empty());
+}
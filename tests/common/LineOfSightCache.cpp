@@ -0,0 +1,77 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "LineOfSightCache.h"
+#include <G3D/AABox.h>
+
+TEST_CASE("Find stored result", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64, 1000);
+    LineOfSightCache::Key key = LineOfSightCache::MakeKey(10.0f, 10.0f, 5.0f, 30.0f, 10.0f, 5.0f, 1, 3);
+
+    bool result = true;
+    REQUIRE(cache.Find(key, 0, result) == false);
+
+    cache.Store(key, 0, false, 100);
+    REQUIRE(cache.Find(key, 500, result) == true);
+    REQUIRE(result == false);
+
+    // endpoints are compared exactly, nearby positions have their own result
+    REQUIRE(cache.Find(LineOfSightCache::MakeKey(10.1f, 10.0f, 5.0f, 30.0f, 10.0f, 5.0f, 1, 3), 500, result) == false);
+
+    // phase mask and flags are part of the key
+    REQUIRE(cache.Find(LineOfSightCache::MakeKey(10.0f, 10.0f, 5.0f, 30.0f, 10.0f, 5.0f, 2, 3), 500, result) == false);
+    REQUIRE(cache.Find(LineOfSightCache::MakeKey(10.0f, 10.0f, 5.0f, 30.0f, 10.0f, 5.0f, 1, 1), 500, result) == false);
+
+    LineOfSightCacheStats stats = cache.GetStats();
+    REQUIRE(stats.Hits == 1);
+    REQUIRE(stats.Misses == 4);
+    REQUIRE(stats.MissTime == 100);
+}
+
+TEST_CASE("Expiration", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(64, 1000);
+    LineOfSightCache::Key key = LineOfSightCache::MakeKey(0.0f, 0.0f, 0.0f, 5.0f, 5.0f, 0.0f, 1, 3);
+    cache.Store(key, 2000, true, 0);
+
+    bool result = false;
+    REQUIRE(cache.Find(key, 2999, result) == true);
+    REQUIRE(cache.Find(key, 3000, result) == false);
+}
+
+TEST_CASE("Invalidation", "[LineOfSightCache]")
+{
+    LineOfSightCache cache(1024, 1000);
+    LineOfSightCache::Key crossing = LineOfSightCache::MakeKey(0.0f, 0.0f, 0.0f, 20.0f, 0.0f, 0.0f, 1, 3);
+    LineOfSightCache::Key away = LineOfSightCache::MakeKey(0.0f, 50.0f, 0.0f, 20.0f, 50.0f, 0.0f, 1, 3);
+    cache.Store(crossing, 0, true, 0);
+    cache.Store(away, 0, true, 0);
+
+    // door between both ends of the first segment
+    cache.Invalidate(G3D::AABox(G3D::Vector3(9.0f, -2.0f, -1.0f), G3D::Vector3(11.0f, 2.0f, 5.0f)));
+
+    bool result = false;
+    REQUIRE(cache.Find(crossing, 0, result) == false);
+    REQUIRE(cache.Find(away, 0, result) == true);
+    REQUIRE(cache.GetStats().Invalidations == 1);
+
+    cache.Clear();
+    REQUIRE(cache.Find(away, 0, result) == false);
+}
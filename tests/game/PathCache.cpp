@@ -0,0 +1,81 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "PathCache.h"
+
+namespace
+{
+    auto const AllValid = [](dtPolyRef) { return true; };
+}
+
+TEST_CASE("Corridor lookup", "[PathCache]")
+{
+    PathCache cache(4);
+    dtPolyRef corridor[] = { 10, 11, 12, 13 };
+    cache.Store({ 10, 13, 1, 0 }, corridor, 4);
+
+    dtPolyRef polys[8] = { };
+    REQUIRE(cache.Find({ 10, 13, 1, 0 }, polys, 8, AllValid) == 4);
+    REQUIRE(std::equal(std::begin(corridor), std::end(corridor), polys));
+
+    SECTION("filter is part of the key")
+    {
+        REQUIRE(cache.Find({ 10, 13, 3, 0 }, polys, 8, AllValid) == 0);
+        REQUIRE(cache.Find({ 10, 13, 1, 2 }, polys, 8, AllValid) == 0);
+    }
+
+    SECTION("result is truncated to output size")
+    {
+        REQUIRE(cache.Find({ 10, 13, 1, 0 }, polys, 2, AllValid) == 2);
+    }
+
+    SECTION("stale corridors are dropped")
+    {
+        REQUIRE(cache.Find({ 10, 13, 1, 0 }, polys, 8, [](dtPolyRef poly) { return poly != 12; }) == 0);
+        REQUIRE(cache.GetSize() == 0);
+        REQUIRE(cache.Find({ 10, 13, 1, 0 }, polys, 8, AllValid) == 0);
+    }
+}
+
+TEST_CASE("Least recently used eviction", "[PathCache]")
+{
+    PathCache cache(2);
+    dtPolyRef corridor[] = { 1, 2 };
+    dtPolyRef polys[2] = { };
+
+    cache.Store({ 1, 2, 1, 0 }, corridor, 2);
+    cache.Store({ 3, 4, 1, 0 }, corridor, 2);
+
+    // touch first entry so second one is the oldest
+    REQUIRE(cache.Find({ 1, 2, 1, 0 }, polys, 2, AllValid) == 2);
+
+    cache.Store({ 5, 6, 1, 0 }, corridor, 2);
+    REQUIRE(cache.GetSize() == 2);
+    REQUIRE(cache.Find({ 3, 4, 1, 0 }, polys, 2, AllValid) == 0);
+    REQUIRE(cache.Find({ 1, 2, 1, 0 }, polys, 2, AllValid) == 2);
+    REQUIRE(cache.Find({ 5, 6, 1, 0 }, polys, 2, AllValid) == 2);
+
+    PathCacheStats stats = cache.ConsumeStats();
+    REQUIRE(stats.Hits == 3);
+    REQUIRE(stats.Misses == 1);
+    REQUIRE(stats.Evictions == 1);
+
+    stats = cache.ConsumeStats();
+    REQUIRE(stats.Hits == 0);
+}
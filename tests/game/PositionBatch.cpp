@@ -0,0 +1,118 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "Position.h"
+#include "PositionBatch.h"
+#include <cmath>
+#include <random>
+
+namespace
+{
+    // per object path of VisitCandidates: WorldObject::IsWithinDist(obj, range, false)
+    bool IsWithinDist2d(Position const& center, Position const& target, float range)
+    {
+        return center.IsInDist2d(&target, range);
+    }
+
+    void RequireSameAsPerObject(Position const& center, std::vector<Position> const& targets, std::vector<float> const& ranges)
+    {
+        Trinity::PositionBatch batch;
+        for (std::size_t i = 0; i < targets.size(); ++i)
+            batch.Add(targets[i].GetPositionX(), targets[i].GetPositionY(), ranges[i]);
+
+        std::vector<uint8> inRange;
+        batch.FilterInRange(center.GetPositionX(), center.GetPositionY(), inRange);
+        REQUIRE(inRange.size() == targets.size());
+
+        for (std::size_t i = 0; i < targets.size(); ++i)
+        {
+            INFO("candidate " << i << " at " << targets[i].GetPositionX() << ", " << targets[i].GetPositionY() << " range " << ranges[i]);
+
+            // culling must never drop an object the per object check accepts
+            if (IsWithinDist2d(center, targets[i], ranges[i]))
+                REQUIRE(inRange[i]);
+
+            // and keeps only objects within range, the boundary itself included
+            float const distSq = targets[i].GetExactDist2dSq(center);
+            REQUIRE(bool(inRange[i]) == (distSq <= ranges[i] * ranges[i]));
+        }
+    }
+}
+
+TEST_CASE("Batch culling matches per object distance", "[PositionBatch]")
+{
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> coord(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> range(0.0f, 150.0f);
+
+    Position const center(1234.5f, -876.25f, 10.0f);
+
+    // sizes around the vector widths so both the vectorized loop and its scalar tail run
+    for (std::size_t size : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 17u, 100u })
+    {
+        std::vector<Position> targets;
+        std::vector<float> ranges;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            targets.emplace_back(center.GetPositionX() + coord(random), center.GetPositionY() + coord(random), 0.0f);
+            ranges.push_back(range(random));
+        }
+
+        RequireSameAsPerObject(center, targets, ranges);
+    }
+}
+
+TEST_CASE("Batch culling at boundary distances", "[PositionBatch]")
+{
+    // center at the origin keeps offsets exact
+    Position const center(0.0f, 0.0f, 0.0f);
+
+    std::vector<Position> targets;
+    std::vector<float> ranges;
+    auto add = [&](float dx, float dy, float range)
+    {
+        targets.emplace_back(center.GetPositionX() + dx, center.GetPositionY() + dy, 0.0f);
+        ranges.push_back(range);
+    };
+
+    // exactly on the range (3-4-5), per object check is strict and rejects these
+    add(3.0f, 4.0f, 5.0f);
+    add(-30.0f, 40.0f, 50.0f);
+    add(0.0f, -100.0f, 100.0f);
+
+    // one ulp inside and outside of the range
+    add(0.0f, 100.0f, std::nextafter(100.0f, 200.0f));
+    add(0.0f, 100.0f, std::nextafter(100.0f, 0.0f));
+    add(std::nextafter(60.0f, 0.0f), 0.0f, 60.0f);
+    add(std::nextafter(60.0f, 100.0f), 0.0f, 60.0f);
+
+    // same position and zero range
+    add(0.0f, 0.0f, 0.0f);
+    add(0.5f, 0.0f, 0.0f);
+
+    RequireSameAsPerObject(center, targets, ranges);
+
+    Trinity::PositionBatch batch;
+    for (std::size_t i = 0; i < targets.size(); ++i)
+        batch.Add(targets[i].GetPositionX(), targets[i].GetPositionY(), ranges[i]);
+
+    std::vector<uint8> inRange;
+    batch.FilterInRange(center.GetPositionX(), center.GetPositionY(), inRange);
+    REQUIRE(inRange == std::vector<uint8>{ 1, 1, 1, 1, 0, 1, 0, 1, 0 });
+}
@@ -0,0 +1,173 @@
+/*
+ * This file is part of the TrinityCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation; either version 2 of the License, or (at your
+ * option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tc_catch2.h"
+
+#include "FlatSet.h"
+#include "VisibilityDiff.h"
+#include <numeric>
+#include <random>
+#include <unordered_set>
+
+namespace
+{
+    ObjectGuid MakeGuid(uint32 entry, uint32 counter)
+    {
+        return ObjectGuid(HighGuid::Unit, entry, ObjectGuid::LowType(counter));
+    }
+
+    std::vector<ObjectGuid> MakeGuids(uint32 count, uint32 firstCounter)
+    {
+        std::vector<ObjectGuid> guids;
+        guids.reserve(count);
+        for (uint32 i = 0; i < count; ++i)
+            guids.push_back(MakeGuid(1000 + (i % 50), firstCounter + i));
+        return guids;
+    }
+}
+
+TEST_CASE("Left objects", "[VisibilityDiff]")
+{
+    Trinity::Containers::FlatSet<ObjectGuid> known;
+    for (ObjectGuid const& guid : MakeGuids(10, 1))
+        known.insert(guid);
+
+    Trinity::VisibilityDiff diff;
+    diff.Clear();
+    diff.SetKnown(known);
+
+    std::vector<ObjectGuid> visited = MakeGuids(10, 1);
+    std::shuffle(visited.begin(), visited.end(), std::mt19937(42));
+    for (std::size_t i = 0; i < visited.size(); ++i)
+        if (visited[i].GetCounter() % 3)
+            diff.AddVisited(visited[i]);
+
+    // object that became visible during the pass is visited but not known before
+    diff.AddVisited(MakeGuid(1, 100));
+
+    std::vector<ObjectGuid> const& left = diff.ComputeLeft(known);
+    REQUIRE(left.size() == 3);
+    for (ObjectGuid const& guid : left)
+        REQUIRE(guid.GetCounter() % 3 == 0);
+
+    REQUIRE(std::is_sorted(left.begin(), left.end()));
+}
+
+TEST_CASE("Objects known during a nested pass", "[VisibilityDiff]")
+{
+    Trinity::Containers::FlatSet<ObjectGuid> known;
+    known.insert(MakeGuid(1, 1));
+    known.insert(MakeGuid(1, 2));
+    known.insert(MakeGuid(1, 3));
+
+    Trinity::VisibilityDiff diff;
+    diff.Clear();
+    diff.SetKnown(known);
+    diff.AddVisited(MakeGuid(1, 1));
+
+    // inner pass made the client see a new object and forget another one
+    known.insert(MakeGuid(1, 10));
+    known.erase(MakeGuid(1, 3));
+
+    std::vector<ObjectGuid> const& left = diff.ComputeLeft(known);
+    REQUIRE(left.size() == 1);
+    REQUIRE(left.front() == MakeGuid(1, 2));
+}
+
+TEST_CASE("Visited lookup", "[VisibilityDiff]")
+{
+    Trinity::VisibilityDiff diff;
+    diff.Clear();
+
+    diff.AddVisited(MakeGuid(1, 5));
+    diff.AddVisited(MakeGuid(1, 2));
+    diff.SortVisited();
+    REQUIRE(diff.IsVisited(MakeGuid(1, 2)));
+    REQUIRE(diff.IsVisited(MakeGuid(1, 5)));
+    REQUIRE_FALSE(diff.IsVisited(MakeGuid(1, 3)));
+
+    // not found until sorted again
+    diff.AddVisited(MakeGuid(1, 3));
+    REQUIRE_FALSE(diff.IsVisited(MakeGuid(1, 3)));
+    diff.SortVisited();
+    REQUIRE(diff.IsVisited(MakeGuid(1, 3)));
+    REQUIRE(diff.IsVisited(MakeGuid(1, 2)));
+
+    diff.Clear();
+    REQUIRE(diff.GetVisitedCount() == 0);
+    REQUIRE(diff.ComputeLeft(Trinity::Containers::FlatSet<ObjectGuid>()).empty());
+}
+
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// build with WITH_BENCHMARKS and run with: tests "[.benchmark]"
+TEST_CASE("Visibility pass of 200 objects", "[VisibilityDiff][.benchmark]")
+{
+    std::vector<ObjectGuid> visible = MakeGuids(200, 1);
+    std::shuffle(visible.begin(), visible.end(), std::mt19937(7));
+
+    // 10 objects leave and 10 enter every pass
+    std::vector<ObjectGuid> visited(visible.begin() + 10, visible.end());
+    std::vector<ObjectGuid> entering = MakeGuids(10, 1000);
+    visited.insert(visited.end(), entering.begin(), entering.end());
+
+    // known objects are built once, a pass only looks them up
+    GuidUnorderedSet known(visible.begin(), visible.end());
+    Trinity::Containers::FlatSet<ObjectGuid> flatKnown;
+    for (ObjectGuid const& guid : visible)
+        flatKnown.insert(guid);
+
+    BENCHMARK("unordered set copy and erase")
+    {
+        GuidUnorderedSet remaining(known);
+        std::size_t entered = 0;
+        for (ObjectGuid const& guid : visited)
+            if (!remaining.erase(guid) && !known.count(guid))
+                ++entered;
+        return remaining.size() + entered;
+    };
+
+    Trinity::VisibilityDiff diff;
+    BENCHMARK("flat set merge")
+    {
+        diff.Clear();
+        diff.SetKnown(flatKnown);
+        std::size_t entered = 0;
+        for (ObjectGuid const& guid : visited)
+        {
+            diff.AddVisited(guid);
+            if (flatKnown.find(guid) == flatKnown.end())
+                ++entered;
+        }
+        return diff.ComputeLeft(flatKnown).size() + entered;
+    };
+
+    // visited set is filled and sorted once, only lookups are measured
+    diff.Clear();
+    for (ObjectGuid const& guid : visited)
+        diff.AddVisited(guid);
+    diff.SortVisited();
+
+    BENCHMARK("visited lookup")
+    {
+        std::size_t found = 0;
+        for (ObjectGuid const& guid : visible)
+            if (diff.IsVisited(guid))
+                ++found;
+        return found;
+    };
+}
+#endif